@@ -39,6 +39,11 @@ if test "$PHP_TUI" != "no"; then
   dnl Check for sys/ioctl.h (terminal size)
   AC_CHECK_HEADERS([sys/ioctl.h])
 
+  dnl Check for pthreads (banded frame encoding, tui.encode_threads)
+  AC_CHECK_HEADERS([pthread.h], [], [
+    AC_MSG_ERROR([pthread.h not found, required for the encoder worker threads])
+  ])
+
   dnl Define C sources (our extension code)
   dnl Split into logical modules for maintainability
   TUI_SOURCES="tui.c \
@@ -69,10 +74,16 @@ if test "$PHP_TUI" != "no"; then
      src/node/node.c \
      src/node/reconciler.c \
      src/node/keymap.c \
+     src/node/keywords.c \
      src/render/buffer.c \
      src/render/output.c \
+     src/render/diff.c \
+     src/render/queue.c \
+     src/render/workers.c \
+     src/render/damage.c \
      src/text/measure.c \
      src/text/wrap.c \
+     src/text/run.c \
      src/text/grapheme.c \
      src/drawing/primitives.c \
      src/drawing/canvas.c \
@@ -92,7 +103,10 @@ if test "$PHP_TUI" != "no"; then
      src/testing/renderer.c \
      src/testing/query.c \
      src/pool/pool.c \
-     src/pool/intern.c"
+     src/pool/intern.c \
+     src/pool/wrapcache.c \
+     src/pool/colorcache.c \
+     src/pool/arena.c"
 
   dnl Define C++ sources (Yoga layout engine)
   YOGA_SOURCES="src/yoga/YGConfig.cpp \
@@ -161,6 +175,9 @@ if test "$PHP_TUI" != "no"; then
 
   dnl Add C++ standard library
   PHP_ADD_LIBRARY(stdc++, 1, TUI_SHARED_LIBADD)
+
+  dnl Add pthreads for the encoder workers
+  PHP_ADD_LIBRARY(pthread, 1, TUI_SHARED_LIBADD)
   PHP_SUBST(TUI_SHARED_LIBADD)
 
   dnl Add build directories for C sources
@@ -70,6 +70,8 @@ typedef struct {
     int64_t text_count;
     int64_t static_count;
     int64_t max_depth;
+    int64_t nodes_converted;    /* Node objects read property by property */
+    int64_t nodes_copied;       /* Node objects copied from their native node */
 
     /* Reconciler metrics */
     int64_t diff_runs;
@@ -99,6 +101,28 @@ typedef struct {
     int64_t timer_fires;
     int64_t poll_errors;
 
+    /* Output metrics (running totals) */
+    int64_t output_bytes;       /* Bytes written to the terminal */
+    int64_t output_writes;      /* write()/writev() syscalls */
+    int64_t cells_changed;      /* Cells emitted by the diff */
+    int64_t rows_touched;       /* Rows with at least one emitted cell */
+    int64_t cursor_moves;       /* Cursor movement sequences */
+    int64_t sgr_sequences;      /* SGR (style) sequences */
+    int64_t link_sequences;     /* OSC 8 hyperlink opens and closes */
+    int64_t full_redraws;       /* Frames that repainted every row */
+    int64_t damaged_cells;      /* Cells cleared and re-rasterized */
+
+    /* Output metrics (most recent frame) */
+    int64_t frame_bytes;
+    int64_t frame_writes;
+    int64_t frame_cells_changed;
+    int64_t frame_rows_touched;
+    int64_t frame_cursor_moves;
+    int64_t frame_sgr_sequences;
+    int64_t frame_link_sequences;
+    int64_t frame_full_redraw;
+    int64_t frame_damaged_cells;
+
     /* Pool metrics */
     int64_t pool_diff_allocs;
     int64_t pool_diff_fallbacks;
@@ -124,6 +148,8 @@ ZEND_BEGIN_MODULE_GLOBALS(tui)
     zend_long max_states;
     zend_long max_timers;
     zend_long min_render_interval;
+    zend_long encode_threads;
+    zend_bool node_arena;
 
     /* Telemetry */
     zend_bool metrics_enabled;
@@ -164,6 +190,7 @@ ZEND_EXTERN_MODULE_GLOBALS(tui)
 #define TUI_METRIC_ADD(field, val)      ((void)0)
 #define TUI_METRIC_MAX(field, val)      ((void)0)
 #define TUI_METRIC_MIN(field, val)      ((void)0)
+#define TUI_METRIC_SET(field, val)      ((void)0)
 
 #else /* !TUI_DISABLE_METRICS */
 
@@ -186,6 +213,9 @@ ZEND_EXTERN_MODULE_GLOBALS(tui)
         (TUI_G(metrics).field == 0 || (val) < TUI_G(metrics).field)) \
         TUI_G(metrics).field = (val); } while(0)
 
+#define TUI_METRIC_SET(field, val) \
+    do { if (TUI_G(metrics_enabled)) TUI_G(metrics).field = (val); } while(0)
+
 #endif /* TUI_DISABLE_METRICS */
 
 /* Class entries */
@@ -10,6 +10,7 @@
 */
 
 #include "accessibility.h"
+#include "../render/queue.h"
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
@@ -164,17 +165,6 @@ tui_aria_role tui_aria_role_from_string(const char *role_str)
     return TUI_ARIA_ROLE_CUSTOM;
 }
 
-/* Write output to stdout */
-static void write_stdout(const char *data, size_t len)
-{
-    size_t written = 0;
-    while (written < len) {
-        ssize_t n = write(STDOUT_FILENO, data + written, len - written);
-        if (n <= 0) break;
-        written += (size_t)n;
-    }
-}
-
 int tui_announce(const char *message, tui_announce_priority priority)
 {
     if (!message) return -1;
@@ -198,7 +188,7 @@ int tui_announce(const char *message, tui_announce_priority priority)
         "\x1b]777;notify;Announcement;%s\x07", message);
 
     if (len > 0 && (size_t)len < buf_size) {
-        write_stdout(buf, (size_t)len);
+        tui_output_write(buf, (size_t)len);
     }
 
     /* iTerm2 notification (OSC 9) */
@@ -206,7 +196,7 @@ int tui_announce(const char *message, tui_announce_priority priority)
         "\x1b]9;%s\x07", message);
 
     if (len > 0 && (size_t)len < buf_size) {
-        write_stdout(buf, (size_t)len);
+        tui_output_write(buf, (size_t)len);
     }
 
     /* Kitty notification (OSC 99) with urgency */
@@ -216,7 +206,7 @@ int tui_announce(const char *message, tui_announce_priority priority)
         message);
 
     if (len > 0 && (size_t)len < buf_size) {
-        write_stdout(buf, (size_t)len);
+        tui_output_write(buf, (size_t)len);
     }
 
     /* Suppress unused variable warning */
@@ -8,6 +8,9 @@
 #include "../terminal/terminal.h"
 #include "../terminal/ansi.h"
 #include "../event/input.h"
+#include "../render/damage.h"
+#include "../node/reconciler.h"
+#include "../pool/pool.h"
 #include "php.h"
 #include "php_tui.h"
 #include <stdlib.h>
@@ -15,6 +18,7 @@
 #include <unistd.h>
 #include <stdint.h>
 #include <limits.h>
+#include <math.h>
 #include <time.h>
 #include <termios.h>
 
@@ -22,10 +26,20 @@
 extern zend_class_entry *tui_key_ce;
 extern zend_class_entry *tui_focus_event_ce;
 
-/* Forward declaration for rendering a node tree to buffer */
-static void render_node_to_buffer(tui_app *app, tui_node *node, int offset_x, int offset_y);
+/* Unsent tty bytes above which the terminal counts as falling behind */
+#define FRAME_BACKLOG_BYTES 4096
 
-tui_app* tui_app_create(void)
+/* Forward declaration for rendering a node tree to buffer */
+static void render_node_to_buffer(tui_buffer *buffer, tui_node *node, int offset_x, int offset_y);
+static void collect_damage(tui_node *node, int offset_x, int offset_y, tui_damage *damage, int depth);
+static void layout_surface(tui_app *app, tui_layer *s);
+static long rasterize_surface(tui_app *app, tui_layer *s, int above, tui_damage *out);
+static void composite_layers(tui_app *app, const tui_damage *composite);
+static void layer_free(tui_layer *layer);
+static void print_static_items(tui_app *app, tui_node *node, int depth);
+
+/* Allocate an app of the given size; headless apps get no output */
+static tui_app* app_create(int width, int height, int headless)
 {
     tui_app *app = calloc(1, sizeof(tui_app));
     if (!app) {
@@ -35,7 +49,9 @@ tui_app* tui_app_create(void)
 
     app->fullscreen = 1;
     app->exit_on_ctrl_c = 1;
-    app->min_render_interval_ms = 16;  /* 60fps */
+    /* Range checked when the INI value is set */
+    app->min_render_interval_ms = (int)TUI_G(min_render_interval);
+    app->frame_interval_ms = app->min_render_interval_ms;
 
     /* Initialize all zvals to UNDEF for safe cleanup.
      * This ensures zval_ptr_dtor checks in tui_app_destroy() work correctly
@@ -64,19 +80,20 @@ tui_app* tui_app_create(void)
     }
     app->timer_capacity = INITIAL_TIMER_CAPACITY;
 
-    /* Get terminal size (uses defaults 80x24 on failure) */
-    if (tui_terminal_get_size(&app->width, &app->height) != 0) {
-        /* Non-fatal: proceed with default size but log for debugging */
-        php_error_docref(NULL, E_NOTICE,
-            "Could not determine terminal size, using default %dx%d",
-            app->width, app->height);
-    }
+    app->width = width;
+    app->height = height;
+    app->headless = headless;
 
     /* Create output system */
-    app->output = tui_output_create(app->width, app->height);
-    if (!app->output) {
-        php_error_docref(NULL, E_WARNING, "Failed to create TUI output system");
-        goto error_timers;
+    if (!headless) {
+        app->output = tui_output_create(app->width, app->height);
+        if (!app->output) {
+            php_error_docref(NULL, E_WARNING, "Failed to create TUI output system");
+            goto error_timers;
+        }
+        if (TUI_G(encode_threads) > 1 && TUI_G(encode_threads) <= TUI_WORKERS_MAX) {
+            tui_output_set_encode_threads(app->output, (int)TUI_G(encode_threads));
+        }
     }
 
     /* Create character buffer */
@@ -86,6 +103,9 @@ tui_app* tui_app_create(void)
         goto error_output;
     }
 
+    tui_damage_init(&app->base.stale, app->width, app->height);
+    tui_damage_init(&app->uncovered, app->width, app->height);
+
     /* Create event loop */
     app->loop = tui_loop_create();
     if (!app->loop) {
@@ -109,6 +129,30 @@ error_app:
     return NULL;
 }
 
+tui_app* tui_app_create(void)
+{
+    int width, height;
+
+    /* Get terminal size (uses defaults 80x24 on failure) */
+    if (tui_terminal_get_size(&width, &height) != 0) {
+        /* Non-fatal: proceed with default size but log for debugging */
+        php_error_docref(NULL, E_NOTICE,
+            "Could not determine terminal size, using default %dx%d",
+            width, height);
+    }
+
+    return app_create(width, height, 0);
+}
+
+tui_app* tui_app_create_headless(int width, int height)
+{
+    tui_app *app = app_create(width, height, 1);
+    if (app) {
+        app->running = 1;
+    }
+    return app;
+}
+
 void tui_app_destroy(tui_app *app)
 {
     if (!app) return;
@@ -213,6 +257,16 @@ void tui_app_destroy(tui_app *app)
         tui_node_destroy(app->root_node);
         app->root_node = NULL;
     }
+    for (int i = 0; i < app->layer_count; i++) {
+        layer_free(app->layers[i]);
+    }
+    free(app->layers);
+    app->layers = NULL;
+    app->layer_count = 0;
+    if (app->base_buffer) {
+        tui_buffer_destroy(app->base_buffer);
+        app->base_buffer = NULL;
+    }
     if (app->buffer) {
         tui_buffer_destroy(app->buffer);
         app->buffer = NULL;
@@ -654,9 +708,11 @@ int tui_app_start(tui_app *app)
         return -1;
     }
 
-    /* Enter alternate screen if fullscreen */
+    /* Enter alternate screen if fullscreen, otherwise draw below the prompt */
     if (app->fullscreen) {
         tui_output_enter_alternate(app->output);
+    } else {
+        tui_output_set_inline(app->output, 1);
     }
 
     /* Hide cursor */
@@ -702,34 +758,61 @@ void tui_app_render_tree(tui_app *app)
         start_ns = get_time_ns();
     }
 
-    /* Clear the buffer */
-    tui_buffer_clear(app->buffer);
-
-    /* If we have a root node, render it */
-    if (app->root_node) {
-        /* Calculate layout */
-        tui_node_calculate_layout(app->root_node, app->width, app->height);
+    /* Inline mode: new Static items go to the scrollback before layout.
+     * Only a rebuilt tree can have gained any. */
+    if (!app->fullscreen && app->root_node && app->base.tree_dirty) {
+        print_static_items(app, app->root_node, 0);
+    }
 
-        if (TUI_G(metrics_enabled)) {
-            layout_end_ns = get_time_ns();
-        }
+    /* Lay out whichever trees changed; each layer independently */
+    app->base.root = app->root_node;
+    app->base.buffer = app->base_buffer ? app->base_buffer : app->buffer;
+    layout_surface(app, &app->base);
+    for (int i = 0; i < app->layer_count; i++) {
+        layout_surface(app, app->layers[i]);
+    }
 
-        /* Render to buffer */
-        render_node_to_buffer(app, app->root_node, 0, 0);
+    if (TUI_G(metrics_enabled)) {
+        layout_end_ns = get_time_ns();
+    }
 
-        if (TUI_G(metrics_enabled)) {
-            buffer_end_ns = get_time_ns();
+    /* Redraw what changed in each surface. Without layers the main tree
+     * draws straight into app->buffer; with layers app->buffer is the
+     * composite of all surfaces. */
+    tui_damage composite;
+    tui_damage_init(&composite, app->buffer->width, app->buffer->height);
+    long damaged = rasterize_surface(app, &app->base, 0, &composite);
+    for (int i = 0; i < app->layer_count; i++) {
+        damaged += rasterize_surface(app, app->layers[i], i + 1, &composite);
+    }
+    if (app->base_buffer) {
+        for (int i = 0; i < app->uncovered.count; i++) {
+            tui_damage_add(&composite, app->uncovered.rects[i]);
+        }
+        tui_damage_init(&app->uncovered, app->buffer->width, app->buffer->height);
+        if (app->repaint_all) {
+            tui_damage_add_all(&composite);
         }
-    } else if (TUI_G(metrics_enabled)) {
-        layout_end_ns = start_ns;
-        buffer_end_ns = start_ns;
+        composite_layers(app, &composite);
+    }
+    TUI_METRIC_SET(frame_damaged_cells, damaged);
+    TUI_METRIC_ADD(damaged_cells, damaged);
+    app->repaint_all = 0;
+
+    if (TUI_G(metrics_enabled)) {
+        buffer_end_ns = get_time_ns();
     }
 
     /* Determine if cursor should be shown based on focused node's showCursor property */
     int show_cursor = (app->focused_node && app->focused_node->show_cursor) ? 1 : 0;
 
-    /* Output to terminal */
-    tui_output_render_with_cursor(app->output, app->buffer, show_cursor);
+    /* Output to terminal; inline, only the rows the main tree occupies */
+    if (app->fullscreen) {
+        tui_output_render_with_cursor(app->output, app->buffer, show_cursor);
+    } else {
+        int rows = app->root_node ? (int)ceilf(app->root_node->y + app->root_node->height) : 0;
+        tui_output_render_inline(app->output, app->buffer, rows, show_cursor);
+    }
 
     if (TUI_G(metrics_enabled)) {
         output_end_ns = get_time_ns();
@@ -755,6 +838,10 @@ void tui_app_render(tui_app *app)
 {
     if (!app || !app->running) return;
 
+    /* One frame: output from the component (images, OSC) lands in the
+     * same write as the cell diff */
+    tui_output_begin_frame(app->output);
+
     /* Use rerender_callback to properly call component with Instance parameter */
     if (app->rerender_callback) {
         app->rerender_callback(app);
@@ -762,6 +849,8 @@ void tui_app_render(tui_app *app)
 
     /* Render the tree to screen */
     tui_app_render_tree(app);
+
+    tui_output_end_frame(app->output);
 }
 
 void tui_app_stop(tui_app *app)
@@ -770,6 +859,12 @@ void tui_app_stop(tui_app *app)
 
     app->running = 0;
 
+    /* Nothing was set up on a terminal */
+    if (app->headless) return;
+
+    /* Write out a frame left open by an aborted render */
+    tui_output_end_frame(app->output);
+
     /* Stop event loop */
     tui_loop_stop(app->loop);
 
@@ -788,9 +883,11 @@ void tui_app_stop(tui_app *app)
     /* Show cursor */
     tui_output_show_cursor(app->output);
 
-    /* Exit alternate screen if fullscreen */
+    /* Exit alternate screen if fullscreen; inline, the last frame stays */
     if (app->fullscreen) {
         tui_output_exit_alternate(app->output);
+    } else {
+        tui_output_inline_finish(app->output);
     }
 
     /* Output a newline so shell prompt appears on a fresh line */
@@ -803,26 +900,102 @@ void tui_app_stop(tui_app *app)
     tui_terminal_disable_raw_mode();
 }
 
+void tui_app_request_render(tui_app *app)
+{
+    if (!app) return;
+
+    if (app->in_event_loop) {
+        app->rerender_pending = 1;
+        return;
+    }
+
+    tui_output_begin_frame(app->output);
+    if (app->rerender_callback) {
+        app->rerender_callback(app);  /* Rebuild tree */
+    }
+    tui_app_render_tree(app);         /* Render to screen */
+    tui_output_end_frame(app->output);
+}
+
+/**
+ * Milliseconds until the next frame may be rendered (0 = render now).
+ *
+ * Adapts the interval to the terminal: while the tty still holds more
+ * than FRAME_BACKLOG_BYTES of unsent output, the interval doubles (up to
+ * TUI_FRAME_INTERVAL_MAX_MS) and the frame is deferred; once it drains, the
+ * interval halves back towards min_render_interval_ms.
+ */
+static int frame_wait_ms(tui_app *app)
+{
+    int64_t elapsed_ms = (get_time_ns() - app->last_frame_ns) / 1000000;
+    if (elapsed_ms < app->frame_interval_ms) {
+        return app->frame_interval_ms - (int)elapsed_ms;
+    }
+
+    int queued = tui_terminal_output_queued();
+    if (queued > FRAME_BACKLOG_BYTES) {
+        int interval = app->frame_interval_ms > 0 ? app->frame_interval_ms * 2 : 8;
+        app->frame_interval_ms = interval < TUI_FRAME_INTERVAL_MAX_MS ? interval : TUI_FRAME_INTERVAL_MAX_MS;
+        app->last_frame_ns = get_time_ns();
+        return app->frame_interval_ms;
+    }
+
+    if (app->frame_interval_ms > app->min_render_interval_ms) {
+        int interval = app->frame_interval_ms / 2;
+        app->frame_interval_ms = interval > app->min_render_interval_ms ? interval : app->min_render_interval_ms;
+    }
+    return 0;
+}
+
+int tui_app_render_pending(tui_app *app)
+{
+    if (!app || !app->running) return 0;
+
+    /* Full re-render if needed (e.g., terminal resize, setState) */
+    if (app->rerender_pending && app->rerender_callback) {
+        app->rerender_pending = 0;
+        tui_output_begin_frame(app->output);
+        app->rerender_callback(app);  /* Rebuild tree */
+        tui_app_render_tree(app);     /* Render to screen */
+        tui_output_end_frame(app->output);
+        return 1;
+    }
+    /* Re-render existing tree if pending (focus changes) */
+    if (app->render_pending) {
+        tui_app_render_tree(app);
+        return 1;
+    }
+    return 0;
+}
+
 void tui_app_wait_until_exit(tui_app *app)
 {
     if (!app || !app->running) return;
 
-    /* Run event loop until stopped */
+    app->in_event_loop = 1;
+
+    /* Run event loop until stopped. Render requests only set flags, so
+     * everything requested between two frames (state changes, timers,
+     * input, resizes) is rendered once, at most once per interval. */
     while (app->running && !app->should_exit) {
         tui_loop_run(app->loop);
 
-        /* Full re-render if needed (e.g., terminal resize) */
-        if (app->rerender_pending && app->rerender_callback) {
-            app->rerender_pending = 0;
-            app->rerender_callback(app);  /* Rebuild tree */
-            tui_app_render_tree(app);     /* Render to screen */
-        }
-        /* Re-render existing tree if pending (focus changes) */
-        else if (app->render_pending) {
-            tui_app_render_tree(app);
+        int full = app->rerender_pending && app->rerender_callback;
+        if (!full && !app->render_pending) continue;
+
+        int wait_ms = frame_wait_ms(app);
+        if (wait_ms > 0) {
+            /* Wake up when the frame is due, even with no events */
+            tui_loop_set_max_wait(app->loop, wait_ms);
+            continue;
         }
+
+        app->last_frame_ns = get_time_ns();
+        tui_app_render_pending(app);
     }
 
+    app->in_event_loop = 0;
+
     /* Clean up terminal state when exiting */
     if (app->running) {
         tui_app_stop(app);
@@ -1077,6 +1250,19 @@ void tui_app_on_resize(int width, int height, void *userdata)
 
     /* Resize buffers */
     tui_buffer_resize(app->buffer, width, height);
+    if (app->base_buffer) {
+        tui_buffer_resize(app->base_buffer, width, height);
+    }
+    for (int i = 0; i < app->layer_count; i++) {
+        tui_buffer_resize(app->layers[i]->buffer, width, height);
+        tui_damage_init(&app->layers[i]->stale, width, height);
+    }
+    tui_damage_init(&app->base.stale, width, height);
+    tui_damage_init(&app->uncovered, width, height);
+    app->repaint_all = 1;
+
+    /* The terminal may have rewrapped the inline region's lines */
+    tui_output_inline_reset(app->output);
 
     /* Call PHP resize handler if set */
     if (app->has_resize_handler) {
@@ -1141,14 +1327,22 @@ static void render_border_to_buffer(tui_buffer *buffer, tui_node *node, int x, i
     tui_buffer_write_text(buffer, x, y + h - 1, chars[2], &border_style);
     tui_buffer_write_text(buffer, x + w - 1, y + h - 1, chars[3], &border_style);
 
+    /* Edges, limited to the part inside the clip rect */
+    const tui_rect *clip = &buffer->clip;
+    int first = clip->x - x > 1 ? clip->x - x : 1;
+    int last = clip->x + clip->w - x < w - 1 ? clip->x + clip->w - x : w - 1;
+
     /* Horizontal edges (top and bottom) */
-    for (int i = 1; i < w - 1; i++) {
+    for (int i = first; i < last; i++) {
         tui_buffer_write_text(buffer, x + i, y, chars[4], &border_style);
         tui_buffer_write_text(buffer, x + i, y + h - 1, chars[4], &border_style);
     }
 
+    first = clip->y - y > 1 ? clip->y - y : 1;
+    last = clip->y + clip->h - y < h - 1 ? clip->y + clip->h - y : h - 1;
+
     /* Vertical edges (left and right) */
-    for (int i = 1; i < h - 1; i++) {
+    for (int i = first; i < last; i++) {
         tui_buffer_write_text(buffer, x, y + i, chars[5], &border_style);
         tui_buffer_write_text(buffer, x + w - 1, y + i, chars[5], &border_style);
     }
@@ -1157,8 +1351,35 @@ static void render_border_to_buffer(tui_buffer *buffer, tui_node *node, int x, i
 /* Forward declaration */
 #include "../text/wrap.h"
 
+/* Wrap through copied lines; only used when the glyph run can't be built */
+static void render_wrapped_text_copy(tui_buffer *buffer, tui_node *node, int x, int y,
+                                     int max_width, int max_height)
+{
+    if (node->wrap_mode == TUI_WRAP_NONE) {
+        char *truncated = tui_truncate_text(node->text, max_width, "…");
+        if (truncated) {
+            tui_buffer_write_text(buffer, x, y, truncated, &node->style);
+            free(truncated);
+        }
+        return;
+    }
+
+    tui_wrapped_text *wrapped = tui_wrap_text(node->text, max_width, node->wrap_mode);
+    if (wrapped) {
+        int lines_to_render = wrapped->count < max_height ? wrapped->count : max_height;
+        /* Only the lines that land inside the clip rect */
+        int first = buffer->clip.y - y > 0 ? buffer->clip.y - y : 0;
+        int end = buffer->clip.y + buffer->clip.h - y;
+        if (end < lines_to_render) lines_to_render = end;
+        for (int i = first; i < lines_to_render; i++) {
+            tui_buffer_write_text(buffer, x, y + i, wrapped->lines[i], &node->style);
+        }
+        tui_wrapped_text_free(wrapped);
+    }
+}
+
 /* Render wrapped text */
-static void render_wrapped_text(tui_app *app, tui_node *node, int x, int y, int max_width, int max_height)
+static void render_wrapped_text(tui_buffer *buffer, tui_node *node, int x, int y, int max_width, int max_height)
 {
     if (!node || !node->text || !node->text[0]) return;
 
@@ -1166,14 +1387,32 @@ static void render_wrapped_text(tui_app *app, tui_node *node, int x, int y, int
         return;
     }
 
+    /* Lines are written straight from the node's glyph run: no copies */
+    const tui_text_run *run = tui_node_text_run(node);
+    if (!run) {
+        render_wrapped_text_copy(buffer, node, x, y, max_width, max_height);
+        return;
+    }
+
     switch (node->wrap_mode) {
         case TUI_WRAP_NONE:
             /* Truncate to fit width */
-            {
-                char *truncated = tui_truncate_text(node->text, max_width, "…");
-                if (truncated) {
-                    tui_buffer_write_text(app->buffer, x, y, truncated, &node->style);
-                    free(truncated);
+            if (run->width <= max_width) {
+                tui_buffer_write_text_n(buffer, x, y, node->text, (size_t)run->bytes, &node->style);
+            } else if (max_width <= 1) {
+                tui_buffer_write_text(buffer, x, y, "…", &node->style);
+            } else {
+                /* Same cut as tui_truncate_text(text, max_width, "…"), built
+                 * on the stack when it fits */
+                char stack[256];
+                int count = tui_text_run_fit(run, max_width - 1, NULL);
+                size_t len = count < run->count ? run->glyphs[count].offset : (size_t)run->bytes;
+                char *line = len + 4 <= sizeof(stack) ? stack : malloc(len + 4);
+                if (line) {
+                    memcpy(line, node->text, len);
+                    memcpy(line + len, "…", 4);
+                    tui_buffer_write_text(buffer, x, y, line, &node->style);
+                    if (line != stack) free(line);
                 }
             }
             break;
@@ -1183,23 +1422,46 @@ static void render_wrapped_text(tui_app *app, tui_node *node, int x, int y, int
         case TUI_WRAP_WORD_CHAR:
             /* Word or character wrap */
             {
-                tui_wrapped_text *wrapped = tui_wrap_text(node->text, max_width, node->wrap_mode);
-                if (wrapped) {
-                    int lines_to_render = wrapped->count < max_height ? wrapped->count : max_height;
-                    for (int i = 0; i < lines_to_render; i++) {
-                        tui_buffer_write_text(app->buffer, x, y + i, wrapped->lines[i], &node->style);
+                /* Only the lines that land inside the clip rect */
+                int first = buffer->clip.y - y > 0 ? buffer->clip.y - y : 0;
+                int end = buffer->clip.y + buffer->clip.h - y;
+                if (end > max_height) end = max_height;
+
+                /* Unchanged text at an unchanged width is wrapped once,
+                 * then served from the cache on later frames */
+                int count;
+                const tui_line_span *spans = TUI_G(pools) ?
+                    tui_wrap_cache_get(&TUI_G(pools)->wrap_cache, node->text, run,
+                                       max_width, node->wrap_mode, &count) : NULL;
+                if (spans) {
+                    if (end > count) end = count;
+                    for (int i = first; i < end; i++) {
+                        tui_buffer_write_text_n(buffer, x, y + i, node->text + spans[i].offset,
+                                                (size_t)spans[i].len, &node->style);
+                    }
+                    break;
+                }
+
+                tui_wrap_iter it;
+                int offset, len;
+                tui_wrap_iter_init(&it, run, max_width, node->wrap_mode);
+                for (int i = 0; i < end && tui_wrap_iter_next(&it, &offset, &len); i++) {
+                    if (i >= first) {
+                        tui_buffer_write_text_n(buffer, x, y + i, node->text + offset,
+                                                (size_t)len, &node->style);
                     }
-                    tui_wrapped_text_free(wrapped);
                 }
             }
             break;
     }
 }
 
-/* Render a node tree to the buffer */
-static void render_node_to_buffer(tui_app *app, tui_node *node, int offset_x, int offset_y)
+/* Render a node tree to the buffer.
+ * Subtrees whose extent lies outside the clip rect are skipped; boxes with
+ * overflow hidden/scroll narrow the clip rect for their children. */
+static void render_node_to_buffer(tui_buffer *buffer, tui_node *node, int offset_x, int offset_y)
 {
-    if (!app || !node) return;
+    if (!buffer || !node) return;
 
     /* Calculate absolute position */
     int x = offset_x + (int)node->x;
@@ -1207,26 +1469,425 @@ static void render_node_to_buffer(tui_app *app, tui_node *node, int offset_x, in
     int w = (int)node->width;
     int h = (int)node->height;
 
+    /* Cull: nothing in this subtree can reach a visible cell */
+    int ex = x + (int)floorf(node->extent_x0);
+    int ey = y + (int)floorf(node->extent_y0);
+    if (!tui_buffer_clip_intersects(buffer, ex, ey,
+                                    x + (int)ceilf(node->extent_x1) - ex,
+                                    y + (int)ceilf(node->extent_y1) - ey)) {
+        return;
+    }
+
+    /* Cells written by a linked node and its children carry the link */
+    uint16_t saved_link = buffer->link;
+    if (node->hyperlink_url) {
+        tui_buffer_set_link(buffer, tui_buffer_intern_link(buffer, node->hyperlink_url,
+                                                           node->hyperlink_id));
+    }
+
     /* Render based on node type */
     if (node->type == TUI_NODE_TEXT && node->text) {
         /* Render text content with wrapping support */
-        render_wrapped_text(app, node, x, y, w, h);
-    } else if (node->type == TUI_NODE_BOX) {
+        render_wrapped_text(buffer, node, x, y, w, h);
+    } else if (node->type == TUI_NODE_BOX || node->type == TUI_NODE_STATIC) {
         /* Fill background if set */
         if (node->style.bg.is_set) {
-            tui_buffer_fill_rect(app->buffer, x, y, w, h, ' ', &node->style);
+            tui_buffer_fill_rect(buffer, x, y, w, h, ' ', &node->style);
         }
 
         /* Render border if set */
         if (node->border_style != TUI_BORDER_NONE) {
-            render_border_to_buffer(app->buffer, node, x, y, w, h);
+            render_border_to_buffer(buffer, node, x, y, w, h);
+        }
+    }
+
+    if (node->child_count == 0) {
+        tui_buffer_set_link(buffer, saved_link);
+        return;
+    }
+
+    /* Clip children to the box on axes with overflow hidden/scroll */
+    int clipped = (node->type == TUI_NODE_BOX || node->type == TUI_NODE_STATIC) &&
+                  (node->clip_x || node->clip_y);
+    tui_rect saved = buffer->clip;
+    if (clipped) {
+        tui_rect box = saved;
+        if (node->clip_x) {
+            box.x = x;
+            box.w = w;
         }
+        if (node->clip_y) {
+            box.y = y;
+            box.h = h;
+        }
+        tui_buffer_push_clip(buffer, box);
     }
 
     /* Render children */
     for (int i = 0; i < node->child_count; i++) {
-        render_node_to_buffer(app, node->children[i], x, y);
+        render_node_to_buffer(buffer, node->children[i], x, y);
+    }
+
+    if (clipped) {
+        tui_buffer_set_clip(buffer, saved);
+    }
+    tui_buffer_set_link(buffer, saved_link);
+}
+
+/* Compare each node's box with where it was painted last frame and add
+ * whatever moved, resized, restyled or disappeared to the damage list.
+ * Records the new boxes, so this runs once per frame even when the whole
+ * screen is repainted. */
+static void collect_damage(tui_node *node, int offset_x, int offset_y, tui_damage *damage, int depth)
+{
+    if (!node || depth >= MAX_TREE_DEPTH) return;
+
+    int x = offset_x + (int)node->x;
+    int y = offset_y + (int)node->y;
+    int w = (int)node->width;
+    int h = (int)node->height;
+
+    if (node->paint_dirty) {
+        /* New look: old box plus everything the subtree may now draw */
+        int ex = x + (int)floorf(node->extent_x0);
+        int ey = y + (int)floorf(node->extent_y0);
+        tui_damage_add(damage, (tui_rect){node->paint_x, node->paint_y, node->paint_w, node->paint_h});
+        tui_damage_add(damage, (tui_rect){ex, ey,
+                                          x + (int)ceilf(node->extent_x1) - ex,
+                                          y + (int)ceilf(node->extent_y1) - ey});
+    } else if (x != node->paint_x || y != node->paint_y ||
+               w != node->paint_w || h != node->paint_h) {
+        tui_damage_add(damage, (tui_rect){node->paint_x, node->paint_y, node->paint_w, node->paint_h});
+        tui_damage_add(damage, (tui_rect){x, y, w, h});
+    }
+    if (node->lost_w > 0 && node->lost_h > 0) {
+        tui_damage_add(damage, (tui_rect){node->lost_x, node->lost_y, node->lost_w, node->lost_h});
+        node->lost_w = node->lost_h = 0;
+    }
+
+    node->paint_x = x;
+    node->paint_y = y;
+    node->paint_w = w;
+    node->paint_h = h;
+    node->paint_dirty = 0;
+
+    for (int i = 0; i < node->child_count; i++) {
+        collect_damage(node->children[i], x, y, damage, depth + 1);
+    }
+}
+
+/* ------------------------------------------------------------------
+ * Static output (inline mode)
+ * ------------------------------------------------------------------ */
+
+/* Lay out one item on its own, at the terminal width, and print it */
+static void print_static_item(tui_app *app, tui_node *item)
+{
+    tui_node_calculate_layout(item, (float)app->width, YGUndefined);
+
+    int rows = (int)ceilf(item->y + item->height);
+    if (rows <= 0) return;
+
+    tui_buffer *lines = tui_buffer_create(app->width, rows);
+    if (!lines) return;
+
+    render_node_to_buffer(lines, item, 0, 0);
+    tui_output_inline_print(app->output, lines, rows);
+    tui_buffer_destroy(lines);
+}
+
+/* Print the children each Static node gained since the last frame, then
+ * drop them: they live in the scrollback now and never take part in the
+ * main tree's layout. static_items_rendered counts them so the reconciler
+ * skips their twins in later trees. */
+static void print_static_items(tui_app *app, tui_node *node, int depth)
+{
+    if (!node || depth >= MAX_TREE_DEPTH) return;
+
+    if (node->type != TUI_NODE_STATIC) {
+        for (int i = 0; i < node->child_count; i++) {
+            print_static_items(app, node->children[i], depth + 1);
+        }
+        return;
+    }
+    if (node->child_count == 0) return;
+
+    for (tui_node *p = app->focused_node; p; p = p->parent) {
+        if (p == node) {
+            app->focused_node = NULL;
+            break;
+        }
+    }
+
+    YGNodeRemoveAllChildren(node->yoga_node);
+    for (int i = 0; i < node->child_count; i++) {
+        tui_node *item = node->children[i];
+        node->children[i] = NULL;
+        if (!item) continue;
+
+        item->parent = NULL;
+        print_static_item(app, item);
+        tui_node_destroy(item);
     }
+    node->static_items_rendered += node->child_count;
+    node->child_count = 0;
+}
+
+/* ------------------------------------------------------------------
+ * Surfaces and layers
+ * ------------------------------------------------------------------ */
+
+/* Does the surface's tree need layout and damage collection this frame? */
+static inline int surface_changed(const tui_app *app, const tui_layer *s)
+{
+    return s->tree_dirty || app->repaint_all || s->painted_root != s->root;
+}
+
+static void layout_surface(tui_app *app, tui_layer *s)
+{
+    if (!s->root || !surface_changed(app, s)) return;
+
+    /* Inline, the main tree is as tall as its content */
+    tui_node *root = s->root;
+    tui_node_calculate_layout(root, app->width,
+                              (!app->fullscreen && s == &app->base) ? YGUndefined : app->height);
+
+    int x0 = (int)floorf(root->x + root->extent_x0);
+    int y0 = (int)floorf(root->y + root->extent_y0);
+    s->bounds = (tui_rect){ x0, y0,
+                            (int)ceilf(root->x + root->extent_x1) - x0,
+                            (int)ceilf(root->y + root->extent_y1) - y0 };
+}
+
+/* A layer whose root box has a background hides everything below it */
+static int layer_opaque_rect(const tui_layer *layer, tui_rect *r)
+{
+    const tui_node *root = layer->root;
+    if (!root || root->type != TUI_NODE_BOX || !root->style.bg.is_set) return 0;
+
+    *r = (tui_rect){ (int)root->x, (int)root->y, (int)root->width, (int)root->height };
+    return r->w > 0 && r->h > 0;
+}
+
+/*
+ * Clear and redraw the damaged parts of one surface. Damage covered by an
+ * opaque layer above it (layers[above..]) is not drawn but kept as stale
+ * until it shows again. Redrawn rects are added to out.
+ * @return Number of cells redrawn
+ */
+static long rasterize_surface(tui_app *app, tui_layer *s, int above, tui_damage *out)
+{
+    tui_buffer *buf = s->buffer;
+    int overlay = s != &app->base;
+
+    tui_damage d;
+    tui_damage_init(&d, buf->width, buf->height);
+    if (app->repaint_all || s->painted_root != s->root) {
+        tui_damage_add_all(&d);
+    }
+    if (s->root && surface_changed(app, s)) {
+        collect_damage(s->root, 0, 0, &d, 0);
+    }
+    s->tree_dirty = 0;
+    s->painted_root = s->root;
+
+    for (int i = 0; i < s->stale.count; i++) {
+        tui_damage_add(&d, s->stale.rects[i]);
+    }
+    tui_damage_init(&s->stale, buf->width, buf->height);
+
+    /* Occlusion culling */
+    for (int j = above; j < app->layer_count && d.count > 0; j++) {
+        tui_rect o;
+        if (!layer_opaque_rect(app->layers[j], &o)) continue;
+
+        for (int i = 0; i < d.count; i++) {
+            tui_rect r = d.rects[i];
+            int x0 = r.x > o.x ? r.x : o.x;
+            int y0 = r.y > o.y ? r.y : o.y;
+            int x1 = r.x + r.w < o.x + o.w ? r.x + r.w : o.x + o.w;
+            int y1 = r.y + r.h < o.y + o.h ? r.y + r.h : o.y + o.h;
+            tui_damage_add(&s->stale, (tui_rect){ x0, y0, x1 - x0, y1 - y0 });
+        }
+        tui_damage_subtract(&d, o);
+    }
+
+    if (d.full && !overlay) {
+        tui_buffer_clear(buf);
+        tui_buffer_reset_clip(buf);
+        render_node_to_buffer(buf, s->root, 0, 0);
+    } else {
+        for (int i = 0; i < d.count; i++) {
+            tui_rect r = tui_buffer_align_rect(buf, d.rects[i]);
+            for (;;) {
+                tui_buffer_set_clip(buf, r);
+                if (overlay) {
+                    tui_buffer_fill_rect(buf, r.x, r.y, r.w, r.h, TUI_CELL_TRANSPARENT, NULL);
+                } else {
+                    tui_buffer_clear_rect(buf, r.x, r.y, r.w, r.h);
+                }
+                buf->cut = (tui_rect){ 0, 0, 0, 0 };
+                render_node_to_buffer(buf, s->root, 0, 0);
+
+                /* A wide character the rect's edge cut in half is whole in
+                 * a full redraw: draw again with the rect grown over it */
+                int x0 = buf->cut.x < r.x ? buf->cut.x : r.x;
+                int x1 = buf->cut.x + buf->cut.w > r.x + r.w ? buf->cut.x + buf->cut.w : r.x + r.w;
+                if (buf->cut.w <= 0 || (x0 == r.x && x1 == r.x + r.w)) break;
+                r.x = x0 < 0 ? 0 : x0;
+                r.w = (x1 > buf->width ? buf->width : x1) - r.x;
+            }
+            tui_damage_add(out, r);
+        }
+        tui_buffer_reset_clip(buf);
+    }
+    if (d.full) {
+        tui_damage_add_all(out);
+    }
+
+    return tui_damage_area(&d);
+}
+
+/* Rebuild the damaged parts of app->buffer from the main tree's buffer
+ * and the layers above it */
+static void composite_layers(tui_app *app, const tui_damage *composite)
+{
+    /* Cells are copied raw, so every surface must use one style table */
+    tui_buffer_share_styles(app->buffer, app->base_buffer);
+    for (int i = 0; i < app->layer_count; i++) {
+        tui_buffer_share_styles(app->layers[i]->buffer, app->buffer);
+    }
+
+    for (int i = 0; i < composite->count; i++) {
+        tui_rect r = composite->rects[i];
+        tui_buffer_composite(app->buffer, app->base_buffer, r);
+        for (int j = 0; j < app->layer_count; j++) {
+            tui_buffer_composite(app->buffer, app->layers[j]->buffer, r);
+        }
+    }
+}
+
+/* Render the existing trees: coalesced inside the event loop, at once otherwise */
+static void request_tree_render(tui_app *app)
+{
+    if (!app->running) return;
+
+    if (app->in_event_loop) {
+        app->render_pending = 1;
+        return;
+    }
+
+    tui_output_begin_frame(app->output);
+    tui_app_render_tree(app);
+    tui_output_end_frame(app->output);
+}
+
+static int find_layer(const tui_app *app, int id)
+{
+    for (int i = 0; i < app->layer_count; i++) {
+        if (app->layers[i]->id == id) return i;
+    }
+    return -1;
+}
+
+static void layer_free(tui_layer *layer)
+{
+    if (!layer) return;
+    tui_node_destroy(layer->root);
+    tui_buffer_destroy(layer->buffer);
+    free(layer);
+}
+
+int tui_app_add_layer(tui_app *app, tui_node *root, int z_index)
+{
+    if (!app || !root) goto fail;
+
+    if (!app->base_buffer) {
+        /* First layer: the main tree gets a buffer of its own, starting
+         * from what it has already drawn */
+        app->base_buffer = tui_buffer_create(app->buffer->width, app->buffer->height);
+        if (!app->base_buffer) goto fail;
+        tui_buffer_share_styles(app->base_buffer, app->buffer);
+        tui_buffer_composite(app->base_buffer, app->buffer,
+                             (tui_rect){ 0, 0, app->buffer->width, app->buffer->height });
+    }
+
+    if (app->layer_count >= app->layer_capacity) {
+        int new_capacity = app->layer_capacity ? app->layer_capacity * 2 : 4;
+        tui_layer **layers = realloc(app->layers, (size_t)new_capacity * sizeof(tui_layer *));
+        if (!layers) goto fail;
+        app->layers = layers;
+        app->layer_capacity = new_capacity;
+    }
+
+    tui_layer *layer = calloc(1, sizeof(tui_layer));
+    if (!layer) goto fail;
+    layer->buffer = tui_buffer_create(app->buffer->width, app->buffer->height);
+    if (!layer->buffer) {
+        free(layer);
+        goto fail;
+    }
+    tui_buffer_fill_rect(layer->buffer, 0, 0, app->buffer->width, app->buffer->height,
+                         TUI_CELL_TRANSPARENT, NULL);
+
+    layer->id = ++app->next_layer_id;
+    layer->z_index = z_index;
+    layer->root = root;
+    /* The buffer is blank, so only the boxes of the new tree need drawing */
+    layer->painted_root = root;
+    layer->tree_dirty = 1;
+    tui_damage_init(&layer->stale, app->buffer->width, app->buffer->height);
+
+    /* Keep layers sorted; equal z_index stacks in insertion order */
+    int pos = app->layer_count;
+    while (pos > 0 && app->layers[pos - 1]->z_index > z_index) {
+        app->layers[pos] = app->layers[pos - 1];
+        pos--;
+    }
+    app->layers[pos] = layer;
+    app->layer_count++;
+
+    request_tree_render(app);
+    return layer->id;
+
+fail:
+    tui_node_destroy(root);
+    return -1;
+}
+
+int tui_app_update_layer(tui_app *app, int id, tui_node *root)
+{
+    int index = app ? find_layer(app, id) : -1;
+    if (index < 0) {
+        tui_node_destroy(root);
+        return -1;
+    }
+
+    tui_layer *layer = app->layers[index];
+    layer->root = tui_reconciler_reconcile(layer->root, root, &app->focused_node);
+    layer->tree_dirty = 1;
+
+    request_tree_render(app);
+    return 0;
+}
+
+int tui_app_remove_layer(tui_app *app, int id)
+{
+    int index = app ? find_layer(app, id) : -1;
+    if (index < 0) return -1;
+
+    tui_layer *layer = app->layers[index];
+    if (layer->painted_root) {
+        tui_damage_add(&app->uncovered, layer->bounds);
+    }
+    layer_free(layer);
+
+    app->layer_count--;
+    memmove(&app->layers[index], &app->layers[index + 1],
+            (size_t)(app->layer_count - index) * sizeof(tui_layer *));
+
+    request_tree_render(app);
+    return 0;
 }
 
 /* ------------------------------------------------------------------
@@ -1401,82 +2062,3 @@ void tui_app_inject_input(tui_app *app, const char *input, int len)
     /* Call the input handler directly, simulating input without polling */
     tui_app_on_input(input, len, app);
 }
-
-/* Render node tree to external buffer (for headless testing) */
-static void render_node_to_buffer_external(tui_buffer *buffer, tui_node *node, int offset_x, int offset_y);
-
-/* Render wrapped text to external buffer */
-static void render_wrapped_text_external(tui_buffer *buffer, tui_node *node, int x, int y, int max_width, int max_height)
-{
-    if (!node || !node->text || !node->text[0]) return;
-
-    if (max_width <= 0 || max_height <= 0) {
-        return;
-    }
-
-    switch (node->wrap_mode) {
-        case TUI_WRAP_NONE:
-            {
-                char *truncated = tui_truncate_text(node->text, max_width, "…");
-                if (truncated) {
-                    tui_buffer_write_text(buffer, x, y, truncated, &node->style);
-                    free(truncated);
-                }
-            }
-            break;
-
-        case TUI_WRAP_CHAR:
-        case TUI_WRAP_WORD:
-        case TUI_WRAP_WORD_CHAR:
-            {
-                tui_wrapped_text *wrapped = tui_wrap_text(node->text, max_width, node->wrap_mode);
-                if (wrapped) {
-                    int lines_to_render = wrapped->count < max_height ? wrapped->count : max_height;
-                    for (int i = 0; i < lines_to_render; i++) {
-                        tui_buffer_write_text(buffer, x, y + i, wrapped->lines[i], &node->style);
-                    }
-                    tui_wrapped_text_free(wrapped);
-                }
-            }
-            break;
-    }
-}
-
-static void render_node_to_buffer_external(tui_buffer *buffer, tui_node *node, int offset_x, int offset_y)
-{
-    if (!buffer || !node) return;
-
-    int x = offset_x + (int)node->x;
-    int y = offset_y + (int)node->y;
-    int w = (int)node->width;
-    int h = (int)node->height;
-
-    if (node->type == TUI_NODE_TEXT && node->text) {
-        render_wrapped_text_external(buffer, node, x, y, w, h);
-    } else if (node->type == TUI_NODE_BOX) {
-        if (node->style.bg.is_set) {
-            tui_buffer_fill_rect(buffer, x, y, w, h, ' ', &node->style);
-        }
-        if (node->border_style != TUI_BORDER_NONE) {
-            render_border_to_buffer(buffer, node, x, y, w, h);
-        }
-    }
-
-    for (int i = 0; i < node->child_count; i++) {
-        render_node_to_buffer_external(buffer, node->children[i], x, y);
-    }
-}
-
-void tui_app_render_node_to_buffer(tui_buffer *buffer, tui_node *node,
-                                    int offset_x, int offset_y,
-                                    int clip_x, int clip_y,
-                                    int clip_w, int clip_h)
-{
-    /* clip parameters reserved for future use */
-    (void)clip_x;
-    (void)clip_y;
-    (void)clip_w;
-    (void)clip_h;
-
-    render_node_to_buffer_external(buffer, node, offset_x, offset_y);
-}
@@ -16,6 +16,7 @@
 #include "../node/node.h"
 #include "../render/buffer.h"
 #include "../render/output.h"
+#include "../render/damage.h"
 #include "../event/loop.h"
 #include "php.h"
 
@@ -32,9 +33,30 @@ typedef struct {
 /* Initial capacity for dynamic state array */
 #define INITIAL_STATE_CAPACITY 8
 
+/* Frame scheduling: upper bound for the render interval, both as the
+ * tui.min_render_interval INI value and when backing off from a slow
+ * terminal */
+#define TUI_FRAME_INTERVAL_MAX_MS 250
+
 /* Forward declaration for callback pointer */
 typedef struct tui_app tui_app;
 
+/**
+ * A node tree with its own layout and retained buffer. The main tree is
+ * the bottom surface; overlay layers (modals, popups, toasts) are
+ * composited over it in z order.
+ */
+typedef struct {
+    int id;                   /* Layer ID (0 = main tree) */
+    int z_index;              /* Stacking order, higher is on top */
+    tui_node *root;           /* Tree (owned by the layer; main tree: app->root_node) */
+    tui_node *painted_root;   /* Tree the buffer holds (NULL = nothing painted) */
+    tui_buffer *buffer;       /* Overlays: TUI_CELL_TRANSPARENT where nothing is drawn */
+    tui_rect bounds;          /* Screen area the tree covered when last laid out */
+    tui_damage stale;         /* Damage skipped while covered by an opaque layer */
+    int tree_dirty;           /* Tree changed since it was last laid out */
+} tui_layer;
+
 /**
  * Main application state structure.
  */
@@ -45,6 +67,7 @@ struct tui_app {
     int running;              /* Currently in event loop */
     int should_exit;          /* Exit requested */
     int exit_code;            /* Exit code to return */
+    int headless;             /* No terminal: renders to buffer (and output, if set) only */
 
     /* ---- Layout dimensions ---- */
     int width;                /* Terminal width in columns */
@@ -81,6 +104,16 @@ struct tui_app {
     /* ---- Render state ---- */
     tui_buffer *buffer;       /* Character buffer */
     tui_output *output;       /* Terminal output */
+    int repaint_all;          /* Next frame redraws everything (resize, clear) */
+
+    /* ---- Layers ---- */
+    tui_layer base;           /* Main tree (buffer: app->buffer, or base_buffer once layers exist) */
+    tui_buffer *base_buffer;  /* Main tree's own buffer while compositing */
+    tui_layer **layers;       /* Overlays, sorted by z_index */
+    int layer_count;
+    int layer_capacity;
+    int next_layer_id;
+    tui_damage uncovered;     /* Screen area of removed layers, recomposited next frame */
 
     /* ---- Event loop ---- */
     tui_loop *loop;           /* Event loop instance */
@@ -89,6 +122,9 @@ struct tui_app {
     int render_pending;           /* Re-render existing tree */
     int rerender_pending;         /* Full re-render (call component) */
     int min_render_interval_ms;   /* Throttle interval (16ms = 60fps) */
+    int frame_interval_ms;        /* Current interval (raised while the tty backs up) */
+    int64_t last_frame_ns;        /* Monotonic time of the last scheduled frame */
+    int in_event_loop;            /* Inside tui_app_wait_until_exit() */
 
     /* ---- Rerender callback (set by tui.c) ---- */
     void (*rerender_callback)(struct tui_app *app);
@@ -138,6 +174,17 @@ struct tui_app {
  */
 tui_app* tui_app_create(void);
 
+/**
+ * Create an app that never touches the terminal, for the test renderer.
+ * The size is given instead of queried, there is no output until the
+ * caller sets app->output, and the app counts as running from the start:
+ * tui_app_render_tree() and the layer calls work without tui_app_start().
+ * @param width  Columns
+ * @param height Rows
+ * @return New app instance, or NULL on allocation failure
+ */
+tui_app* tui_app_create_headless(int width, int height);
+
 /**
  * Destroy app and free all resources.
  * Stops event loop if running, cleans up all PHP references.
@@ -269,12 +316,29 @@ int tui_app_start(tui_app *app);
  */
 void tui_app_render(tui_app *app);
 
+/**
+ * Request a full rerender.
+ * Inside the event loop the request is coalesced with any others and
+ * rendered by the frame scheduler; outside it, renders immediately.
+ * @param app App instance
+ */
+void tui_app_request_render(tui_app *app);
+
 /**
  * Render existing node tree without calling component.
  * @param app App instance
  */
 void tui_app_render_tree(tui_app *app);
 
+/**
+ * Draw the frame requested since the last one, if any, as the frame
+ * scheduler does once the interval has passed: everything requested in
+ * between (re-renders, focus changes, layer updates) becomes one frame.
+ * @param app App instance
+ * @return 1 if a frame was drawn, 0 if none was pending
+ */
+int tui_app_render_pending(tui_app *app);
+
 /**
  * Stop the event loop.
  * @param app App instance
@@ -294,6 +358,38 @@ void tui_app_wait_until_exit(tui_app *app);
  */
 void tui_app_exit(tui_app *app, int code);
 
+/* ================================================================
+ * Layers
+ * ================================================================ */
+
+/**
+ * Add an overlay layer above the main tree. The layer is laid out and
+ * rasterized on its own; showing, updating or removing it does not
+ * re-render the main tree.
+ * @param app     App instance
+ * @param root    Layer tree (ownership passes to the app)
+ * @param z_index Stacking order (equal values stack in insertion order)
+ * @return Layer ID (> 0), or -1 on failure (root is destroyed)
+ */
+int tui_app_add_layer(tui_app *app, tui_node *root, int z_index);
+
+/**
+ * Replace a layer's tree. The new tree is reconciled into the old one.
+ * @param app  App instance
+ * @param id   Layer ID
+ * @param root New tree (ownership passes to the app)
+ * @return 0 on success, -1 if there is no such layer (root is destroyed)
+ */
+int tui_app_update_layer(tui_app *app, int id, tui_node *root);
+
+/**
+ * Remove a layer and free its tree.
+ * @param app App instance
+ * @param id  Layer ID
+ * @return 0 on success, -1 if there is no such layer
+ */
+int tui_app_remove_layer(tui_app *app, int id);
+
 /* ================================================================
  * Timers
  * ================================================================ */
@@ -372,20 +468,4 @@ void tui_app_cleanup_states(tui_app *app);
  */
 void tui_app_inject_input(tui_app *app, const char *input, int len);
 
-/**
- * Render a node tree to an external buffer (for headless testing).
- * @param buffer   Target buffer
- * @param node     Root node to render
- * @param offset_x X offset for rendering
- * @param offset_y Y offset for rendering
- * @param clip_x   Clip region X (reserved, unused)
- * @param clip_y   Clip region Y (reserved, unused)
- * @param clip_w   Clip region width (reserved, unused)
- * @param clip_h   Clip region height (reserved, unused)
- */
-void tui_app_render_node_to_buffer(tui_buffer *buffer, tui_node *node,
-                                    int offset_x, int offset_y,
-                                    int clip_x, int clip_y,
-                                    int clip_w, int clip_h);
-
 #endif /* TUI_APP_H */
@@ -42,6 +42,7 @@ struct tui_loop {
     tui_timer timers[MAX_TIMERS];
     int timer_count;
     int next_timer_id;
+    int max_wait_ms;                 /* One-shot poll timeout cap (0 = none) */
     struct sigaction old_sigwinch;  /* Saved SIGWINCH handler for restoration */
     int sigwinch_installed;          /* Whether we installed a handler */
 };
@@ -194,6 +195,10 @@ int tui_loop_run(tui_loop *loop)
             timeout = remaining;
         }
     }
+    if (loop->max_wait_ms > 0 && loop->max_wait_ms < timeout) {
+        timeout = loop->max_wait_ms;
+    }
+    loop->max_wait_ms = 0;
     if (timeout <= 0) timeout = MIN_POLL_TIMEOUT_MS;
 
     int ret = poll(fds, 1, timeout);
@@ -278,6 +283,12 @@ void tui_loop_stop(tui_loop *loop)
     loop->running = 0;
 }
 
+void tui_loop_set_max_wait(tui_loop *loop, int ms)
+{
+    if (!loop) return;
+    loop->max_wait_ms = ms > 0 ? ms : 0;
+}
+
 void tui_loop_tick_timers(tui_loop *loop, int ms)
 {
     if (!loop || ms <= 0) return;
@@ -80,6 +80,15 @@ int tui_loop_run(tui_loop *loop);
  */
 void tui_loop_stop(tui_loop *loop);
 
+/**
+ * Limit how long the next iteration may block in poll().
+ * Used by the frame scheduler to wake up when a deferred frame is due.
+ * Applies to the next iteration only.
+ * @param loop Loop instance
+ * @param ms   Maximum wait in milliseconds
+ */
+void tui_loop_set_max_wait(tui_loop *loop, int ms);
+
 /* ================================================================
  * Callback registration
  * ================================================================ */
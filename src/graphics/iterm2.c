@@ -12,24 +12,12 @@
 #include "iterm2.h"
 #include "../terminal/ansi.h"
 #include "../terminal/capabilities.h"
+#include "../render/queue.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
-/**
- * Write all bytes to stdout.
- */
-static void write_stdout(const char *buf, size_t len)
-{
-    size_t written = 0;
-    while (written < len) {
-        ssize_t n = write(STDOUT_FILENO, buf + written, len - written);
-        if (n <= 0) break;
-        written += (size_t)n;
-    }
-}
-
 int tui_iterm2_is_supported(void)
 {
     const char *term_program = getenv("TERM_PROGRAM");
@@ -145,8 +133,8 @@ int tui_iterm2_display_inline(tui_image *img, int cols, int rows)
         return -1;
     }
 
-    write_stdout(buf, (size_t)len);
-    free(buf);
+    /* Payload is queued without copying and freed once written */
+    tui_output_write_owned(buf, (size_t)len);
 
     img->state = TUI_IMAGE_STATE_DISPLAYED;
     img->display_cols = cols;
@@ -165,7 +153,7 @@ int tui_iterm2_display(tui_image *img, int x, int y, int cols, int rows)
     char cursor_buf[32];
     size_t cursor_len;
     tui_ansi_cursor_move(cursor_buf, &cursor_len, x, y);
-    write_stdout(cursor_buf, cursor_len);
+    tui_output_write(cursor_buf, cursor_len);
 
     /* Display the image */
     int result = tui_iterm2_display_inline(img, cols, rows);
@@ -12,6 +12,7 @@
 #include "kitty.h"
 #include "../terminal/ansi.h"
 #include "../terminal/capabilities.h"
+#include "../render/queue.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -41,16 +42,10 @@ static int is_png_data(const unsigned char *data, size_t len)
     return memcmp(data, TUI_PNG_SIGNATURE, TUI_PNG_SIGNATURE_LEN) == 0;
 }
 
-/* Write escape sequence to stdout */
+/* Write escape sequence to the terminal (queued when a frame is open) */
 static int write_escape(const char *data, size_t len)
 {
-    size_t written = 0;
-    while (written < len) {
-        ssize_t n = write(STDOUT_FILENO, data + written, len - written);
-        if (n < 0) return -1;
-        written += (size_t)n;
-    }
-    return 0;
+    return tui_output_write(data, len);
 }
 
 /* ============================================================================
@@ -225,11 +220,14 @@ int tui_image_transmit(tui_image *img)
         return -1;
     }
 
-    /* Allocate buffer for escape sequence */
-    char *escape_buf = malloc(TUI_GRAPHICS_MAX_ESCAPE_SIZE);
-    if (!escape_buf) {
-        free(b64_data);
-        return -1;
+    /* Chunks are queued by reference into b64_data; only the short APC
+     * headers are copied. Inside a frame they join the frame's writev,
+     * otherwise the whole image goes out in one writev of its own. */
+    tui_output_queue local;
+    tui_output_queue *q = tui_output_queue_active();
+    if (!q) {
+        tui_output_queue_init(&local);
+        q = &local;
     }
 
     /* Transmit in chunks */
@@ -244,40 +242,34 @@ int tui_image_transmit(tui_image *img)
         int is_last = (remaining - chunk_size == 0);
         int more = is_last ? 0 : 1;
 
-        int escape_len;
+        char header[128];
+        int header_len;
         if (is_first) {
             /* First chunk includes metadata */
             if (img->format == TUI_GRAPHICS_PNG) {
-                escape_len = snprintf(escape_buf, TUI_GRAPHICS_MAX_ESCAPE_SIZE,
+                header_len = snprintf(header, sizeof(header),
                     "\x1b_Ga=T,f=%d,i=%u,q=2,m=%d;",
                     img->format, img->image_id, more);
             } else {
                 /* RGB/RGBA requires dimensions */
-                escape_len = snprintf(escape_buf, TUI_GRAPHICS_MAX_ESCAPE_SIZE,
+                header_len = snprintf(header, sizeof(header),
                     "\x1b_Ga=T,f=%d,s=%d,v=%d,i=%u,q=2,m=%d;",
                     img->format, img->width, img->height, img->image_id, more);
             }
         } else {
             /* Subsequent chunks only have continuation flag */
-            escape_len = snprintf(escape_buf, TUI_GRAPHICS_MAX_ESCAPE_SIZE,
-                "\x1b_Gm=%d;", more);
+            header_len = snprintf(header, sizeof(header), "\x1b_Gm=%d;", more);
         }
 
-        if (escape_len < 0 || (size_t)escape_len >= TUI_GRAPHICS_MAX_ESCAPE_SIZE - chunk_size - 3) {
+        if (header_len < 0 || (size_t)header_len >= sizeof(header)) {
             result = -1;
             break;
         }
 
-        /* Append chunk data */
-        memcpy(escape_buf + escape_len, b64_data + offset, chunk_size);
-        escape_len += (int)chunk_size;
-
-        /* Append string terminator */
-        escape_buf[escape_len++] = '\x1b';
-        escape_buf[escape_len++] = '\\';
-
-        /* Write to terminal */
-        if (write_escape(escape_buf, (size_t)escape_len) < 0) {
+        /* Header, chunk data, string terminator */
+        if (tui_output_queue_write(q, header, (size_t)header_len) < 0 ||
+            tui_output_queue_write_ref(q, b64_data + offset, chunk_size) < 0 ||
+            tui_output_queue_write(q, "\x1b\\", 2) < 0) {
             result = -1;
             break;
         }
@@ -287,8 +279,16 @@ int tui_image_transmit(tui_image *img)
         is_first = 0;
     }
 
-    free(escape_buf);
-    free(b64_data);
+    if (q == &local) {
+        if (result == 0 && tui_output_queue_flush(&local, STDOUT_FILENO) < 0) {
+            result = -1;
+        }
+        tui_output_queue_free(&local);
+        free(b64_data);
+    } else {
+        /* Queued chunks point into b64_data until the frame is flushed */
+        tui_output_queue_adopt(q, b64_data);
+    }
 
     if (result == 0) {
         img->state = TUI_IMAGE_STATE_TRANSMITTED;
@@ -12,24 +12,12 @@
 #include "sixel.h"
 #include "../terminal/ansi.h"
 #include "../terminal/capabilities.h"
+#include "../render/queue.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
-/**
- * Write all bytes to stdout.
- */
-static void write_stdout(const char *buf, size_t len)
-{
-    size_t written = 0;
-    while (written < len) {
-        ssize_t n = write(STDOUT_FILENO, buf + written, len - written);
-        if (n <= 0) break;
-        written += (size_t)n;
-    }
-}
-
 int tui_sixel_is_supported(void)
 {
     const tui_capabilities *caps = tui_get_capabilities();
@@ -538,7 +526,7 @@ int tui_sixel_output(const char *sixel_data, size_t len)
     if (!sixel_data || len == 0) {
         return -1;
     }
-    write_stdout(sixel_data, len);
+    tui_output_write(sixel_data, len);
     return 0;
 }
 
@@ -558,7 +546,7 @@ int tui_sixel_display(tui_image *img, int x, int y,
     char cursor_buf[32];
     size_t cursor_len;
     tui_ansi_cursor_move(cursor_buf, &cursor_len, x, y);
-    write_stdout(cursor_buf, cursor_len);
+    tui_output_write(cursor_buf, cursor_len);
 
     /* For Sixel, we need RGB data (not PNG) */
     if (img->format == TUI_GRAPHICS_PNG) {
@@ -592,8 +580,7 @@ int tui_sixel_display(tui_image *img, int x, int y,
 
         if (result < 0) return -1;
 
-        tui_sixel_output(sixel, sixel_len);
-        tui_sixel_free(sixel);
+        tui_output_write_owned(sixel, sixel_len);
     } else {
         /* Already RGB */
         rgb_data = img->data;
@@ -605,8 +592,7 @@ int tui_sixel_display(tui_image *img, int x, int y,
             return -1;
         }
 
-        tui_sixel_output(sixel, sixel_len);
-        tui_sixel_free(sixel);
+        tui_output_write_owned(sixel, sixel_len);
     }
 
     img->state = TUI_IMAGE_STATE_DISPLAYED;
@@ -0,0 +1,75 @@
+/*
+  +----------------------------------------------------------------------+
+  | ext-tui: Style keyword lookup                                       |
+  +----------------------------------------------------------------------+
+  | Perfect hash over the fixed keyword set: the first byte, last byte  |
+  | and length pick a slot no other keyword shares, and one memcmp()    |
+  | confirms the match.                                                  |
+  |                                                                       |
+  | The multipliers were found by trying small values until all the     |
+  | keywords landed in distinct slots. Adding a keyword means checking   |
+  | that it still does (the slot indices below are the hash values),    |
+  | and picking new multipliers if not.                                  |
+  +----------------------------------------------------------------------+
+*/
+
+#include "keywords.h"
+#include <string.h>
+
+#define KEYWORD_SLOTS   64          /* Power of two */
+#define KEYWORD_MAX_LEN 14          /* "column-reverse" */
+
+#define KEYWORD_HASH(first, last, len) \
+    (((unsigned)(first) * 7u + (unsigned)(last) * 20u + (unsigned)(len)) & (KEYWORD_SLOTS - 1))
+
+typedef struct {
+    const char *name;
+    unsigned char len;
+    unsigned char token;            /* tui_keyword */
+} keyword_slot;
+
+static const keyword_slot keyword_table[KEYWORD_SLOTS] = {
+    [ 1] = {"space-around", 12, TUI_KW_SPACE_AROUND},
+    [ 2] = {"bold", 4, TUI_KW_BOLD},
+    [ 5] = {"wrap", 4, TUI_KW_WRAP},
+    [10] = {"space-between", 13, TUI_KW_SPACE_BETWEEN},
+    [12] = {"stretch", 7, TUI_KW_STRETCH},
+    [13] = {"row-reverse", 11, TUI_KW_ROW_REVERSE},
+    [15] = {"single", 6, TUI_KW_SINGLE},
+    [17] = {"rtl", 3, TUI_KW_RTL},
+    [18] = {"dashed", 6, TUI_KW_DASHED},
+    [19] = {"absolute", 8, TUI_KW_ABSOLUTE},
+    [21] = {"word", 4, TUI_KW_WORD},
+    [22] = {"end", 3, TUI_KW_END},
+    [23] = {"auto", 4, TUI_KW_AUTO},
+    [26] = {"baseline", 8, TUI_KW_BASELINE},
+    [27] = {"scroll", 6, TUI_KW_SCROLL},
+    [31] = {"ltr", 3, TUI_KW_LTR},
+    [33] = {"char", 4, TUI_KW_CHAR},
+    [34] = {"flex-end", 8, TUI_KW_FLEX_END},
+    [35] = {"center", 6, TUI_KW_CENTER},
+    [36] = {"flex-start", 10, TUI_KW_FLEX_START},
+    [37] = {"space-evenly", 12, TUI_KW_SPACE_EVENLY},
+    [38] = {"double", 6, TUI_KW_DOUBLE},
+    [39] = {"column-reverse", 14, TUI_KW_COLUMN_REVERSE},
+    [42] = {"none", 4, TUI_KW_NONE},
+    [45] = {"row", 3, TUI_KW_ROW},
+    [49] = {"wrap-reverse", 12, TUI_KW_WRAP_REVERSE},
+    [50] = {"word-char", 9, TUI_KW_WORD_CHAR},
+    [51] = {"round", 5, TUI_KW_ROUND},
+    [54] = {"hidden", 6, TUI_KW_HIDDEN},
+    [58] = {"start", 5, TUI_KW_START},
+};
+
+tui_keyword tui_keyword_lookup(const char *str, size_t len)
+{
+    if (!str || len == 0 || len > KEYWORD_MAX_LEN) return TUI_KW_UNKNOWN;
+
+    const keyword_slot *slot = &keyword_table[
+        KEYWORD_HASH((unsigned char)str[0], (unsigned char)str[len - 1], len)];
+
+    if (slot->len == len && memcmp(slot->name, str, len) == 0) {
+        return (tui_keyword)slot->token;
+    }
+    return TUI_KW_UNKNOWN;
+}
@@ -0,0 +1,66 @@
+/*
+  +----------------------------------------------------------------------+
+  | ext-tui: Style keywords                                             |
+  +----------------------------------------------------------------------+
+  | The string values node properties accept (flexDirection: 'row',     |
+  | borderStyle: 'round', ...) mapped to one token each, so converting  |
+  | a node costs one table probe per property instead of a strcmp()     |
+  | chain.                                                               |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef TUI_KEYWORDS_H
+#define TUI_KEYWORDS_H
+
+#include <stddef.h>
+
+typedef enum {
+    TUI_KW_UNKNOWN = 0,
+    /* flexDirection */
+    TUI_KW_ROW,
+    TUI_KW_ROW_REVERSE,
+    TUI_KW_COLUMN_REVERSE,
+    /* alignItems, alignSelf, justifyContent */
+    TUI_KW_FLEX_START,
+    TUI_KW_START,
+    TUI_KW_CENTER,
+    TUI_KW_FLEX_END,
+    TUI_KW_END,
+    TUI_KW_STRETCH,
+    TUI_KW_BASELINE,
+    TUI_KW_AUTO,
+    TUI_KW_SPACE_BETWEEN,
+    TUI_KW_SPACE_AROUND,
+    TUI_KW_SPACE_EVENLY,
+    /* flexWrap */
+    TUI_KW_WRAP,
+    TUI_KW_WRAP_REVERSE,
+    /* overflow, display, position */
+    TUI_KW_HIDDEN,
+    TUI_KW_SCROLL,
+    TUI_KW_NONE,
+    TUI_KW_ABSOLUTE,
+    /* direction */
+    TUI_KW_RTL,
+    TUI_KW_LTR,
+    /* borderStyle */
+    TUI_KW_SINGLE,
+    TUI_KW_DOUBLE,
+    TUI_KW_ROUND,
+    TUI_KW_BOLD,
+    TUI_KW_DASHED,
+    /* Text wrap */
+    TUI_KW_WORD,
+    TUI_KW_CHAR,
+    TUI_KW_WORD_CHAR
+} tui_keyword;
+
+/**
+ * Look up a style keyword (case-sensitive, exact match).
+ * @param str Keyword bytes (need not be NUL-terminated)
+ * @param len Length of str
+ * @return Its token, or TUI_KW_UNKNOWN
+ */
+tui_keyword tui_keyword_lookup(const char *str, size_t len);
+
+#endif /* TUI_KEYWORDS_H */
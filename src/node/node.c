@@ -22,10 +22,22 @@
   |    - When growing, we may transition from malloc to pool             |
   |    - Free operations check the flag to call the correct deallocator  |
   |                                                                      |
-  | Node structs themselves always use standard malloc/free.             |
+  | Node structs themselves use standard malloc/free.                    |
   | Text strings (node->text) use strdup/free.                           |
   | Keys and IDs use the string intern pool for memory efficiency.       |
   |                                                                      |
+  | 4. NODE ARENA (tui.node_arena):                                      |
+  |    While an arena is set (tui_node_set_arena), node structs and the |
+  |    strings they own are bump-allocated from it and node->arena       |
+  |    records that. Such nodes skip free() on destroy; the arena is     |
+  |    reset as a whole. Children arrays, Yoga nodes and glyph runs are  |
+  |    allocated as above either way.                                    |
+  |                                                                      |
+  | 5. YOGA NODES:                                                       |
+  |    Freed Yoga nodes are reset and kept in the pools (up to           |
+  |    YOGA_NODE_POOL_MAX) for the next node created, see               |
+  |    yoga_node_new().                                                  |
+  |                                                                      |
   +----------------------------------------------------------------------+
 */
 
@@ -99,16 +111,113 @@ static int ensure_children_capacity(tui_node *parent)
     return 0;
 }
 
+/*
+ * Yoga node recycler. Freed Yoga nodes are detached, reset with
+ * YGNodeReset() and pooled; creating a node takes one back instead of
+ * allocating a new yoga::Node.
+ */
+static YGNodeRef yoga_node_new(void)
+{
+    YGConfigRef config = tui_get_yoga_config();
+    tui_pools *pools = TUI_G(pools);
+
+    if (pools) {
+        YGConfigConstRef wanted = config ? config : YGConfigGetDefault();
+        while (pools->yoga.head) {
+            YGNodeRef yn = pools->yoga.head;
+            pools->yoga.head = YGNodeGetContext(yn);
+            pools->yoga.count--;
+            YGNodeSetContext(yn, NULL);
+            if (YGNodeGetConfig(yn) == wanted) {
+                pools->yoga_hits++;
+                return yn;
+            }
+            /* Pooled under another config: not reusable */
+            YGNodeFree(yn);
+        }
+        pools->yoga_misses++;
+    }
+
+    return config ? YGNodeNewWithConfig(config) : YGNodeNew();
+}
+
+static void yoga_node_free(YGNodeRef yn)
+{
+    tui_pools *pools = TUI_G(pools);
+
+    if (!pools || pools->yoga.count >= YOGA_NODE_POOL_MAX) {
+        if (pools) pools->yoga_discards++;
+        YGNodeFree(yn);
+        return;
+    }
+
+    /* Detach like YGNodeFree() does; no callbacks into the dying tui_node */
+    YGNodeSetDirtiedFunc(yn, NULL);
+    YGNodeSetContext(yn, NULL);
+    YGNodeRef owner = YGNodeGetOwner(yn);
+    if (owner) YGNodeRemoveChild(owner, yn);
+    YGNodeRemoveAllChildren(yn);
+    YGNodeReset(yn);
+
+    YGNodeSetContext(yn, pools->yoga.head);
+    pools->yoga.head = yn;
+    pools->yoga.count++;
+    pools->yoga_returns++;
+}
+
+/* Arena new nodes go to, NULL = heap */
+static tui_arena* current_arena(void)
+{
+    return TUI_G(pools) ? TUI_G(pools)->node_arena : NULL;
+}
+
+static tui_node* node_alloc(void)
+{
+    tui_arena *arena = current_arena();
+    if (arena) {
+        tui_node *node = tui_arena_calloc(arena, sizeof(tui_node));
+        if (node) node->arena = arena;
+        return node;
+    }
+    return calloc(1, sizeof(tui_node));
+}
+
+static void node_free(tui_node *node)
+{
+    if (!node->arena) free(node);
+}
+
+/* Strings a node owns live where the node does */
+static char* node_strndup(const tui_node *node, const char *str, size_t len)
+{
+    if (node->arena) return tui_arena_strndup(node->arena, str, len);
+
+    char *copy = malloc(len + 1);
+    if (!copy) return NULL;
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+    return copy;
+}
+
+static char* node_strdup(const tui_node *node, const char *str)
+{
+    return str ? node_strndup(node, str, strlen(str)) : NULL;
+}
+
+static void node_strfree(const tui_node *node, char *str)
+{
+    if (!node->arena) free(str);
+}
+
 tui_node* tui_node_create_box(void)
 {
-    tui_node *node = calloc(1, sizeof(tui_node));
+    tui_node *node = node_alloc();
     if (!node) return NULL;
 
     node->type = TUI_NODE_BOX;
-    YGConfigRef config = tui_get_yoga_config();
-    node->yoga_node = config ? YGNodeNewWithConfig(config) : YGNodeNew();
+    node->yoga_node = yoga_node_new();
     if (!node->yoga_node) {
-        free(node);
+        node_free(node);
         return NULL;
     }
 
@@ -122,8 +231,8 @@ tui_node* tui_node_create_box(void)
         node->children_from_pool = 0;
     }
     if (!node->children) {
-        YGNodeFree(node->yoga_node);
-        free(node);
+        yoga_node_free(node->yoga_node);
+        node_free(node);
         return NULL;
     }
     node->child_capacity = actual_capacity;
@@ -151,21 +260,20 @@ tui_node* tui_node_create_text(const char *text)
         }
     }
 
-    tui_node *node = calloc(1, sizeof(tui_node));
+    tui_node *node = node_alloc();
     if (!node) return NULL;
 
     node->type = TUI_NODE_TEXT;
-    YGConfigRef config = tui_get_yoga_config();
-    node->yoga_node = config ? YGNodeNewWithConfig(config) : YGNodeNew();
+    node->yoga_node = yoga_node_new();
     if (!node->yoga_node) {
-        free(node);
+        node_free(node);
         return NULL;
     }
 
-    node->text = strdup(text ? text : "");
+    node->text = node_strdup(node, text ? text : "");
     if (!node->text) {
-        YGNodeFree(node->yoga_node);
-        free(node);
+        yoga_node_free(node->yoga_node);
+        node_free(node);
         return NULL;
     }
 
@@ -182,16 +290,24 @@ tui_node* tui_node_create_text(const char *text)
     return node;
 }
 
+const tui_text_run* tui_node_text_run(tui_node *node)
+{
+    if (!node || !node->text) return NULL;
+    if (!node->text_run) {
+        node->text_run = tui_text_run_create(node->text);
+    }
+    return node->text_run;
+}
+
 tui_node* tui_node_create_static(void)
 {
-    tui_node *node = calloc(1, sizeof(tui_node));
+    tui_node *node = node_alloc();
     if (!node) return NULL;
 
     node->type = TUI_NODE_STATIC;
-    YGConfigRef config = tui_get_yoga_config();
-    node->yoga_node = config ? YGNodeNewWithConfig(config) : YGNodeNew();
+    node->yoga_node = yoga_node_new();
     if (!node->yoga_node) {
-        free(node);
+        node_free(node);
         return NULL;
     }
 
@@ -205,8 +321,8 @@ tui_node* tui_node_create_static(void)
         node->children_from_pool = 0;
     }
     if (!node->children) {
-        YGNodeFree(node->yoga_node);
-        free(node);
+        yoga_node_free(node->yoga_node);
+        node_free(node);
         return NULL;
     }
     node->child_capacity = actual_capacity;
@@ -224,15 +340,14 @@ tui_node* tui_node_create_static(void)
 
 tui_node* tui_node_create_newline(int count)
 {
-    tui_node *node = calloc(1, sizeof(tui_node));
+    tui_node *node = node_alloc();
     if (!node) return NULL;
 
     node->type = TUI_NODE_NEWLINE;
     node->newline_count = count > 0 ? count : 1;
-    YGConfigRef config = tui_get_yoga_config();
-    node->yoga_node = config ? YGNodeNewWithConfig(config) : YGNodeNew();
+    node->yoga_node = yoga_node_new();
     if (!node->yoga_node) {
-        free(node);
+        node_free(node);
         return NULL;
     }
 
@@ -251,14 +366,13 @@ tui_node* tui_node_create_newline(int count)
 
 tui_node* tui_node_create_spacer(void)
 {
-    tui_node *node = calloc(1, sizeof(tui_node));
+    tui_node *node = node_alloc();
     if (!node) return NULL;
 
     node->type = TUI_NODE_SPACER;
-    YGConfigRef config = tui_get_yoga_config();
-    node->yoga_node = config ? YGNodeNewWithConfig(config) : YGNodeNew();
+    node->yoga_node = yoga_node_new();
     if (!node->yoga_node) {
-        free(node);
+        node_free(node);
         return NULL;
     }
 
@@ -291,7 +405,7 @@ int tui_node_set_key(tui_node *node, const char *key, size_t len)
         if (node->key_interned && TUI_G(pools)) {
             tui_intern_release(&TUI_G(pools)->intern, node->key);
         } else {
-            free(node->key);
+            node_strfree(node, node->key);
         }
         node->key = NULL;
         node->key_interned = 0;
@@ -308,10 +422,8 @@ int tui_node_set_key(tui_node *node, const char *key, size_t len)
             }
         }
         /* Fallback to regular allocation if pool not available or intern failed */
-        node->key = malloc(len + 1);
+        node->key = node_strndup(node, key, len);
         if (!node->key) return -1;
-        memcpy(node->key, key, len);
-        node->key[len] = '\0';
         node->key_interned = 0;
     }
     return 0;
@@ -326,7 +438,7 @@ int tui_node_set_id(tui_node *node, const char *id)
         if (node->id_interned && TUI_G(pools)) {
             tui_intern_release(&TUI_G(pools)->intern, node->id);
         } else {
-            free(node->id);
+            node_strfree(node, node->id);
         }
         node->id = NULL;
         node->id_interned = 0;
@@ -352,7 +464,7 @@ int tui_node_set_id(tui_node *node, const char *id)
             }
         }
         /* Fallback to strdup if pool not available or intern failed */
-        node->id = strdup(id);
+        node->id = node_strdup(node, id);
         if (!node->id) return -1;
         node->id_interned = 0;
     }
@@ -375,20 +487,20 @@ int tui_node_set_hyperlink(tui_node *node, const char *url, const char *id)
         return -1;
     }
 
-    free(node->hyperlink_url);
-    free(node->hyperlink_id);
+    node_strfree(node, node->hyperlink_url);
+    node_strfree(node, node->hyperlink_id);
 
     if (url) {
-        node->hyperlink_url = strdup(url);
+        node->hyperlink_url = node_strdup(node, url);
         if (!node->hyperlink_url) return -1;
     } else {
         node->hyperlink_url = NULL;
     }
 
     if (id) {
-        node->hyperlink_id = strdup(id);
+        node->hyperlink_id = node_strdup(node, id);
         if (!node->hyperlink_id) {
-            free(node->hyperlink_url);
+            node_strfree(node, node->hyperlink_url);
             node->hyperlink_url = NULL;
             return -1;
         }
@@ -399,6 +511,51 @@ int tui_node_set_hyperlink(tui_node *node, const char *url, const char *id)
     return 0;
 }
 
+tui_node* tui_node_clone(const tui_node *src)
+{
+    if (!src) return NULL;
+
+    tui_node *node;
+    switch (src->type) {
+        case TUI_NODE_TEXT:    node = tui_node_create_text(src->text); break;
+        case TUI_NODE_STATIC:  node = tui_node_create_static(); break;
+        case TUI_NODE_NEWLINE: node = tui_node_create_newline(src->newline_count); break;
+        case TUI_NODE_SPACER:  node = tui_node_create_spacer(); break;
+        default:               node = tui_node_create_box(); break;
+    }
+    if (!node) return NULL;
+
+    YGNodeCopyStyle(node->yoga_node, src->yoga_node);
+
+    node->style = src->style;
+    node->wrap_mode = src->wrap_mode;
+    node->border_style = src->border_style;
+    node->border_color = src->border_color;
+    node->border_top_color = src->border_top_color;
+    node->border_right_color = src->border_right_color;
+    node->border_bottom_color = src->border_bottom_color;
+    node->border_left_color = src->border_left_color;
+    node->clip_x = src->clip_x;
+    node->clip_y = src->clip_y;
+    node->focusable = src->focusable;
+    node->focused = src->focused;
+    node->tab_index = src->tab_index;
+    node->auto_focus = src->auto_focus;
+    node->focus_trap = src->focus_trap;
+    node->show_cursor = src->show_cursor;
+
+    if ((src->key && tui_node_set_key(node, src->key, strlen(src->key)) < 0) ||
+        (src->id && tui_node_set_id(node, src->id) < 0) ||
+        (src->focus_group && tui_node_set_focus_group(node, src->focus_group) < 0) ||
+        (src->hyperlink_url && tui_node_set_hyperlink(node, src->hyperlink_url, src->hyperlink_id) < 0)) {
+        tui_node_destroy(node);
+        return NULL;
+    }
+
+    return node;
+}
+
+
 /*
  * Free a single node's resources (not its children).
  * Helper for iterative destruction.
@@ -416,7 +573,7 @@ static void free_node_resources(tui_node *node)
 
     /* Free Yoga node */
     if (node->yoga_node) {
-        YGNodeFree(node->yoga_node);
+        yoga_node_free(node->yoga_node);
     }
 
     /* Return children array to pool or free based on origin */
@@ -428,29 +585,30 @@ static void free_node_resources(tui_node *node)
         }
     }
 
-    /* Free string properties */
-    free(node->text);
+    /* Free string properties (arena strings go with the arena) */
+    node_strfree(node, node->text);
+    tui_text_run_free(node->text_run);
 
     /* Release interned strings via pool, or free if not interned */
     if (node->key) {
         if (node->key_interned && TUI_G(pools)) {
             tui_intern_release(&TUI_G(pools)->intern, node->key);
         } else {
-            free(node->key);
+            node_strfree(node, node->key);
         }
     }
     if (node->id) {
         if (node->id_interned && TUI_G(pools)) {
             tui_intern_release(&TUI_G(pools)->intern, node->id);
         } else {
-            free(node->id);
+            node_strfree(node, node->id);
         }
     }
 
-    free(node->hyperlink_url);
-    free(node->hyperlink_id);
-    free(node->focus_group);
-    free(node);
+    node_strfree(node, node->hyperlink_url);
+    node_strfree(node, node->hyperlink_id);
+    node_strfree(node, node->focus_group);
+    node_free(node);
 }
 
 /*
@@ -518,6 +676,113 @@ void tui_node_destroy(tui_node *node)
     free(stack);
 }
 
+/* ----------------------------------------------------------------
+ * Arena
+ * ---------------------------------------------------------------- */
+
+tui_arena* tui_node_arena_acquire(void)
+{
+    tui_pools *pools = TUI_G(pools);
+    if (!pools || !TUI_G(node_arena) || pools->frame_arena_busy) return NULL;
+
+    pools->frame_arena_busy = 1;
+    pools->node_arena = &pools->frame_arena;
+    return &pools->frame_arena;
+}
+
+void tui_node_arena_release(tui_arena *arena)
+{
+    tui_pools *pools = TUI_G(pools);
+    if (!arena || !pools) return;
+
+    if (pools->node_arena == arena) pools->node_arena = NULL;
+    tui_arena_reset(arena);
+    if (arena == &pools->frame_arena) pools->frame_arena_busy = 0;
+}
+
+tui_arena* tui_node_set_arena(tui_arena *arena)
+{
+    tui_pools *pools = TUI_G(pools);
+    if (!pools) return NULL;
+
+    tui_arena *previous = pools->node_arena;
+    pools->node_arena = arena;
+    return previous;
+}
+
+/* Heap copy of a string field; 0 on failure */
+static int promote_string(char **field)
+{
+    if (!*field) return 1;
+    *field = strdup(*field);
+    return *field != NULL;
+}
+
+static tui_node* promote_recursive(tui_node *node, int depth)
+{
+    tui_node *copy = malloc(sizeof(tui_node));
+    if (!copy) return NULL;
+
+    memcpy(copy, node, sizeof(tui_node));
+    copy->arena = NULL;
+
+    /* Interned keys and IDs aren't in the arena and move as they are */
+    int ok = promote_string(&copy->text) &&
+             promote_string(&copy->focus_group) &&
+             promote_string(&copy->hyperlink_url) &&
+             promote_string(&copy->hyperlink_id) &&
+             (copy->key_interned || promote_string(&copy->key)) &&
+             (copy->id_interned || promote_string(&copy->id));
+    if (!ok) {
+        /* Copied fields differ from the original; the rest still point into the arena */
+        if (copy->text != node->text) free(copy->text);
+        if (copy->focus_group != node->focus_group) free(copy->focus_group);
+        if (copy->hyperlink_url != node->hyperlink_url) free(copy->hyperlink_url);
+        if (copy->hyperlink_id != node->hyperlink_id) free(copy->hyperlink_id);
+        if (copy->key != node->key) free(copy->key);
+        if (copy->id != node->id) free(copy->id);
+        free(copy);
+        return NULL;
+    }
+
+    /* The copy takes over everything that isn't in the arena */
+    if (copy->yoga_node) YGNodeSetContext(copy->yoga_node, copy);
+    node->yoga_node = NULL;
+    node->children = NULL;
+    node->child_count = 0;
+    node->child_capacity = 0;
+    node->text_run = NULL;
+    node->key = NULL;
+    node->id = NULL;
+
+    for (int i = 0; i < copy->child_count; i++) {
+        tui_node *child = copy->children[i];
+        if (!child->arena) {
+            child->parent = copy;
+            continue;
+        }
+
+        tui_node *moved = depth < MAX_TREE_DEPTH ? promote_recursive(child, depth + 1) : NULL;
+        if (!moved) {
+            tui_node_remove_child(copy, child);
+            tui_node_destroy(child);
+            i--;
+            continue;
+        }
+        copy->children[i] = moved;
+        moved->parent = copy;
+    }
+
+    if (TUI_G(pools)) TUI_G(pools)->arena_promotions++;
+    return copy;
+}
+
+tui_node* tui_node_promote(tui_node *node)
+{
+    if (!node || !node->arena) return node;
+    return promote_recursive(node, 0);
+}
+
 int tui_node_append_child(tui_node *parent, tui_node *child)
 {
     if (!parent || !child) return -1;
@@ -727,15 +992,19 @@ static YGSize text_measure_func(YGNodeConstRef yg_node, float width,
         return size;
     }
 
-    /* Calculate text width using our text measurement */
-    int text_width = tui_string_width(node->text);
-
-    /* Count lines for height */
-    int lines = 1;
-    const char *p = node->text;
-    while (*p) {
-        if (*p == '\n') lines++;
-        p++;
+    /* Yoga measures a node several times per layout; the run holds the
+     * width and line count from the first call */
+    int text_width, lines;
+    const tui_text_run *run = tui_node_text_run(node);
+    if (run) {
+        text_width = run->width;
+        lines = run->lines;
+    } else {
+        text_width = tui_string_width(node->text);
+        lines = 1;
+        for (const char *p = node->text; *p; p++) {
+            if (*p == '\n') lines++;
+        }
     }
 
     /* Apply width constraints */
@@ -775,8 +1044,8 @@ static float text_baseline_func(YGNodeConstRef yg_node, float width, float heigh
     }
 
     /* For multi-line text, baseline is at the bottom of the first line (1 char tall) */
-    const char *nl = strchr(node->text, '\n');
-    if (nl) {
+    const tui_text_run *run = tui_node_text_run(node);
+    if (run ? run->lines > 1 : strchr(node->text, '\n') != NULL) {
         return 1.0f;
     }
 
@@ -796,6 +1065,40 @@ static void node_dirtied_func(YGNodeConstRef yg_node)
     }
 }
 
+/*
+ * Compute the area the subtree draws into: the node's box plus whatever
+ * children overflow it, except on axes the node clips. Lets the
+ * rasterizer skip subtrees that are entirely off screen.
+ */
+static void update_extent(tui_node *node)
+{
+    float x0 = 0, y0 = 0;
+    float x1 = node->width, y1 = node->height;
+
+    for (int i = 0; i < node->child_count; i++) {
+        const tui_node *child = node->children[i];
+        if (!child) continue;
+        if (child->x + child->extent_x0 < x0) x0 = child->x + child->extent_x0;
+        if (child->y + child->extent_y0 < y0) y0 = child->y + child->extent_y0;
+        if (child->x + child->extent_x1 > x1) x1 = child->x + child->extent_x1;
+        if (child->y + child->extent_y1 > y1) y1 = child->y + child->extent_y1;
+    }
+
+    if (node->clip_x) {
+        x0 = 0;
+        x1 = node->width;
+    }
+    if (node->clip_y) {
+        y0 = 0;
+        y1 = node->height;
+    }
+
+    node->extent_x0 = x0;
+    node->extent_y0 = y0;
+    node->extent_x1 = x1;
+    node->extent_y1 = y1;
+}
+
 /*
  * Recursively copy layout results from Yoga to tui_node.
  * Only copies nodes that have new layout data (optimization).
@@ -834,6 +1137,8 @@ static int copy_layout_recursive(tui_node *node, int depth)
         }
     }
 
+    update_extent(node);
+
     return had_changes;
 }
 
@@ -852,9 +1157,9 @@ int tui_node_set_focus_group(tui_node *node, const char *group)
         return -1;
     }
 
-    free(node->focus_group);
+    node_strfree(node, node->focus_group);
     if (group) {
-        node->focus_group = strdup(group);
+        node->focus_group = node_strdup(node, group);
         if (!node->focus_group) return -1;
     } else {
         node->focus_group = NULL;
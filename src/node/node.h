@@ -7,6 +7,9 @@
   |                                                                      |
   | Memory Management: Nodes are allocated on the heap. Call            |
   | tui_node_destroy() to free a node and all its children recursively. |
+  | With tui.node_arena, trees built for one frame come from a bump     |
+  | arena instead (node structs and their strings); see the Arena       |
+  | section below.                                                       |
   |                                                                      |
   | Thread Safety: NOT thread-safe. All operations must be on the       |
   | same thread.                                                        |
@@ -19,6 +22,8 @@
 #include <stdint.h>
 #include <yoga/Yoga.h>
 #include "../text/wrap.h"
+#include "../text/run.h"
+#include "../pool/arena.h"
 
 /**
  * Node types in the virtual DOM tree.
@@ -74,6 +79,7 @@ typedef enum {
  */
 typedef struct tui_node {
     tui_node_type type;           /* Node type */
+    tui_arena *arena;             /* Holds this struct and its strings, NULL = heap */
     char *key;                    /* Node identity for reconciler */
     char *id;                     /* ID for focus-by-id */
     uint8_t key_interned;         /* 1 if key is interned (use tui_intern_release) */
@@ -82,6 +88,7 @@ typedef struct tui_node {
 
     /* For text nodes */
     char *text;                   /* Text content (NULL for box nodes) */
+    tui_text_run *text_run;       /* Glyphs of text, built on first use */
     tui_wrap_mode wrap_mode;      /* Text wrapping mode */
 
     /* For box nodes with borders */
@@ -92,6 +99,10 @@ typedef struct tui_node {
     tui_color border_bottom_color;
     tui_color border_left_color;
 
+    /* Overflow (box nodes): children are clipped to the box on each axis */
+    uint8_t clip_x;               /* overflowX hidden/scroll */
+    uint8_t clip_y;               /* overflowY hidden/scroll */
+
     /* Focus management */
     int focusable;                /* Whether node can receive focus */
     int focused;                  /* Currently focused */
@@ -117,10 +128,18 @@ typedef struct tui_node {
 
     /* Computed layout (from Yoga) */
     float x, y, width, height;    /* Position and size in characters */
+    float extent_x0, extent_y0;   /* Bounds of everything the subtree draws, */
+    float extent_x1, extent_y1;   /* relative to (x, y); exceed the box on overflow */
 
     /* Layout dirty flag */
     int layout_dirty;             /* Set by dirtied callback */
 
+    /* Retained rasterization: what was painted last frame (absolute cells)
+     * and what must be repainted in the next one */
+    int paint_x, paint_y, paint_w, paint_h;   /* Box as last painted */
+    int lost_x, lost_y, lost_w, lost_h;       /* Area of removed children */
+    uint8_t paint_dirty;          /* Visual properties changed since painted */
+
     /* For STATIC nodes */
     int static_items_rendered;    /* Track rendered items */
 
@@ -145,6 +164,14 @@ tui_node* tui_node_create_box(void);
  */
 tui_node* tui_node_create_text(const char *text);
 
+/**
+ * Glyph run of a text node's content, decoded on first use and kept
+ * until the text changes.
+ * @param node Text node
+ * @return Run, or NULL for nodes without text (or on allocation failure)
+ */
+const tui_text_run* tui_node_text_run(tui_node *node);
+
 /**
  * Create a static node (renders above dynamic content).
  * @return New node, or NULL on allocation failure
@@ -170,6 +197,60 @@ tui_node* tui_node_create_spacer(void);
  */
 void tui_node_destroy(tui_node *node);
 
+/**
+ * Copy a node without its children: type, text, Yoga style, styling,
+ * borders, focus settings, key, id and hyperlink. Layout results and
+ * paint state are not copied. The copy goes to the current arena.
+ * @param src Node to copy
+ * @return New node, or NULL on allocation failure
+ */
+tui_node* tui_node_clone(const tui_node *src);
+
+/* ================================================================
+ * Arena
+ * ================================================================
+ * A tree that only lives for one reconcile (or one test frame) can be
+ * built in a bump arena: node structs and the strings they own come
+ * from it, and resetting the arena releases them all at once.
+ * tui_node_destroy() still frees what isn't in the arena (Yoga nodes,
+ * children arrays, glyph runs, interned keys).
+ *
+ * Retained trees never hold arena nodes: the reconciler promotes any
+ * arena node it adopts, so an arena can be reset as soon as the tree
+ * built in it has been reconciled and destroyed.
+ */
+
+/**
+ * Build nodes in the pools' frame arena until tui_node_arena_release(),
+ * if tui.node_arena is on and the arena isn't already in use.
+ * @return The arena, or NULL when nodes go to the heap as usual
+ */
+tui_arena* tui_node_arena_acquire(void);
+
+/**
+ * Stop building nodes in the frame arena and reset it. Every node built
+ * since tui_node_arena_acquire() must be destroyed or promoted by now.
+ * @param arena Result of tui_node_arena_acquire() (NULL-safe)
+ */
+void tui_node_arena_release(tui_arena *arena);
+
+/**
+ * Route new nodes into an arena (NULL for the heap).
+ * @param arena Arena, or NULL
+ * @return The previous setting, to restore afterwards
+ */
+tui_arena* tui_node_set_arena(tui_arena *arena);
+
+/**
+ * Move an arena subtree to the heap so it can outlive its arena.
+ * The arena copies are left behind detached. Children that can't be
+ * moved (out of memory) are dropped.
+ * @param node Detached subtree root (heap nodes are returned as is)
+ * @return Heap copy of node, or NULL on allocation failure (node is
+ *         left as it was)
+ */
+tui_node* tui_node_promote(tui_node *node);
+
 /* ================================================================
  * Key, ID and hyperlink management
  * ================================================================ */
@@ -42,9 +42,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
+#include <stdint.h>
 
 #define INITIAL_DIFF_CAPACITY 16
 #define MAX_RECONCILE_DEPTH 100  /* Prevent stack overflow on deep trees */
+#define MAX_TREE_DEPTH 256       /* Matches the layout/render depth limit */
 
 static tui_diff_result* diff_result_create(void)
 {
@@ -72,10 +74,17 @@ static int diff_result_add(tui_diff_result *result, tui_diff_type type,
 
     if (result->count >= result->capacity) {
         /* Check for overflow before doubling */
-        if (result->capacity > INT_MAX / 2) return -1;
+        if (result->capacity > INT_MAX / 2) {
+            result->failed = 1;
+            return -1;
+        }
         int new_capacity = result->capacity * 2;
         tui_diff_op *new_ops = realloc(result->ops, new_capacity * sizeof(tui_diff_op));
-        if (!new_ops) return -1;  /* Allocation failed */
+        if (!new_ops) {
+            /* Allocation failed: the diff is incomplete, don't apply it */
+            result->failed = 1;
+            return -1;
+        }
         result->ops = new_ops;
         result->capacity = new_capacity;
     }
@@ -103,6 +112,13 @@ static int nodes_same_type(tui_node *a, tui_node *b)
     return a->type == b->type;
 }
 
+/* New children of a Static node that were already printed (inline mode).
+ * They are left out of the diff; old child i pairs with new child i + n. */
+static inline int printed_items(const tui_node *old_node)
+{
+    return (old_node && old_node->type == TUI_NODE_STATIC) ? old_node->static_items_rendered : 0;
+}
+
 static int has_any_keys(tui_node **children, int count)
 {
     for (int i = 0; i < count; i++) {
@@ -157,7 +173,10 @@ static void diff_children_keyed_with_depth(tui_diff_result *result,
 
     /* Build hash-based key map for old children (O(1) lookup) */
     tui_keymap *old_keys = tui_keymap_create(old_count > 0 ? old_count : 1);
-    if (!old_keys) return;
+    if (!old_keys) {
+        result->failed = 1;
+        return;
+    }
 
     for (int i = 0; i < old_count; i++) {
         tui_node *child = old_node->children[i];
@@ -169,6 +188,7 @@ static void diff_children_keyed_with_depth(tui_diff_result *result,
     /* Track which old indices have been matched (for non-keyed fallback) */
     int *old_matched = calloc(old_count > 0 ? old_count : 1, sizeof(int));
     if (!old_matched) {
+        result->failed = 1;
         tui_keymap_destroy(old_keys);
         return;
     }
@@ -180,7 +200,8 @@ static void diff_children_keyed_with_depth(tui_diff_result *result,
     int last_placed_index = 0;
 
     /* Process new children */
-    for (int new_idx = 0; new_idx < new_count; new_idx++) {
+    int first = printed_items(old_node);
+    for (int new_idx = first; new_idx < new_count; new_idx++) {
         tui_node *new_child = new_node->children[new_idx];
         if (!new_child) continue;
 
@@ -198,12 +219,13 @@ static void diff_children_keyed_with_depth(tui_diff_result *result,
             }
         } else {
             /* Non-keyed child: try to match by index if that old child is also non-keyed */
-            if (new_idx < old_count) {
-                tui_node *old_child = old_node->children[new_idx];
-                if (old_child && !old_child->key && !old_matched[new_idx]) {
+            int old_idx = new_idx - first;
+            if (old_idx < old_count) {
+                tui_node *old_child = old_node->children[old_idx];
+                if (old_child && !old_child->key && !old_matched[old_idx]) {
                     matched_old = old_child;
-                    matched_old_idx = new_idx;
-                    old_matched[new_idx] = 1;
+                    matched_old_idx = old_idx;
+                    old_matched[old_idx] = 1;
                 }
             }
         }
@@ -227,12 +249,13 @@ static void diff_children_keyed_with_depth(tui_diff_result *result,
                     last_placed_index = matched_old_idx;
                 }
 
-                /* Add operation with combined flags */
-                diff_result_add(result, flags, matched_old, new_child,
-                               matched_old_idx, new_idx);
-
-                /* Recurse into children with increased depth */
-                diff_children_with_depth(result, matched_old, new_child, depth + 1);
+                /* Add operation with combined flags, then recurse into
+                 * children with increased depth (child pairs without
+                 * their parent pair would be patched into the wrong tree) */
+                if (diff_result_add(result, flags, matched_old, new_child,
+                                    matched_old_idx, new_idx) == 0) {
+                    diff_children_with_depth(result, matched_old, new_child, depth + 1);
+                }
             }
         } else {
             /* No match: create new */
@@ -267,29 +290,30 @@ static void diff_children_indexed_with_depth(tui_diff_result *result,
         return;
     }
 
+    int first = printed_items(old_node);
     int old_count = old_node ? old_node->child_count : 0;
-    int new_count = new_node ? new_node->child_count : 0;
+    int new_count = new_node ? new_node->child_count - first : 0;
+    if (new_count < 0) new_count = 0;
     int max_count = old_count > new_count ? old_count : new_count;
 
     for (int i = 0; i < max_count; i++) {
         tui_node *old_child = i < old_count ? old_node->children[i] : NULL;
-        tui_node *new_child = i < new_count ? new_node->children[i] : NULL;
+        tui_node *new_child = i < new_count ? new_node->children[first + i] : NULL;
 
         if (!old_child && new_child) {
             /* Create new node */
-            diff_result_add(result, TUI_DIFF_CREATE, NULL, new_child, -1, i);
+            diff_result_add(result, TUI_DIFF_CREATE, NULL, new_child, -1, first + i);
         } else if (old_child && !new_child) {
             /* Delete old node */
             diff_result_add(result, TUI_DIFF_DELETE, old_child, NULL, i, -1);
         } else if (!nodes_same_type(old_child, new_child)) {
             /* Replace with different type */
-            diff_result_add(result, TUI_DIFF_REPLACE, old_child, new_child, i, i);
+            diff_result_add(result, TUI_DIFF_REPLACE, old_child, new_child, i, first + i);
         } else {
-            /* Same type: update */
-            diff_result_add(result, TUI_DIFF_UPDATE, old_child, new_child, i, i);
-
-            /* Recurse into children with increased depth */
-            diff_children_with_depth(result, old_child, new_child, depth + 1);
+            /* Same type: update, then recurse into children with increased depth */
+            if (diff_result_add(result, TUI_DIFF_UPDATE, old_child, new_child, i, first + i) == 0) {
+                diff_children_with_depth(result, old_child, new_child, depth + 1);
+            }
         }
     }
 }
@@ -300,6 +324,9 @@ static void diff_children_indexed_with_depth(tui_diff_result *result,
 static void diff_children_with_depth(tui_diff_result *result, tui_node *old_node,
                                       tui_node *new_node, int depth)
 {
+    /* Nothing more will be applied */
+    if (result->failed) return;
+
     int old_count = old_node ? old_node->child_count : 0;
     int new_count = new_node ? new_node->child_count : 0;
 
@@ -341,199 +368,393 @@ tui_diff_result* tui_reconciler_diff(tui_node *old_tree, tui_node *new_tree)
         if (!nodes_same_type(old_tree, new_tree)) {
             diff_result_add(result, TUI_DIFF_REPLACE, old_tree, new_tree, 0, 0);
         } else {
-            diff_result_add(result, TUI_DIFF_UPDATE, old_tree, new_tree, 0, 0);
-            diff_children(result, old_tree, new_tree);
+            if (diff_result_add(result, TUI_DIFF_UPDATE, old_tree, new_tree, 0, 0) == 0) {
+                diff_children(result, old_tree, new_tree);
+            }
         }
     }
 
     return result;
 }
 
-void tui_reconciler_apply(tui_node *tree, tui_diff_result *diff)
+/* ----------------------------------------------------------------
+ * Patching
+ * ----------------------------------------------------------------
+ * The diff pairs every surviving old node with its counterpart in the
+ * freshly built tree. Patching copies properties from the new node onto
+ * the old one (so Yoga nodes and their measure cache survive), then
+ * rebuilds each surviving parent's child list to mirror the new order.
+ * Nodes that only exist in the new tree are detached from it and moved
+ * over whole; old nodes without a counterpart are destroyed.
+ */
+
+/* Open-addressed pointer -> pointer map used to pair old and new nodes */
+typedef struct {
+    tui_node *from;
+    tui_node *to;
+} node_pair;
+
+typedef struct {
+    node_pair *slots;
+    size_t mask;
+} node_pair_map;
+
+static inline size_t node_pair_hash(const tui_node *node)
 {
-    if (!diff) return;
+    uintptr_t p = (uintptr_t)node;
+    p ^= p >> 17;
+    p *= (uintptr_t)0x9E3779B97F4A7C15ULL;
+    return (size_t)(p ^ (p >> 29));
+}
 
-    /*
-     * Process operations in order using bit flag checks:
-     * 1. First pass: DELETE and REPLACE (remove old nodes)
-     * 2. Second pass: UPDATE (copy properties, preserves Yoga nodes)
-     * 3. Third pass: REORDER (move nodes to new positions)
-     * 4. Fourth pass: CREATE (add new nodes)
-     *
-     * With bit flags, a single operation can have multiple effects
-     * (e.g., UPDATE | REORDER). We check each flag independently.
-     */
+static int node_pair_map_init(node_pair_map *map, int entries)
+{
+    size_t capacity = 16;
+    while (capacity < (size_t)entries * 2) {
+        capacity <<= 1;
+    }
+    map->slots = calloc(capacity, sizeof(node_pair));
+    map->mask = capacity - 1;
+    return map->slots ? 0 : -1;
+}
 
-    /* Pass 1: Deletions (batched - all deletions collected before destroy) */
-    for (int i = 0; i < diff->count; i++) {
-        tui_diff_op *op = &diff->ops[i];
+static void node_pair_map_put(node_pair_map *map, tui_node *from, tui_node *to)
+{
+    size_t i = node_pair_hash(from) & map->mask;
+    while (map->slots[i].from && map->slots[i].from != from) {
+        i = (i + 1) & map->mask;
+    }
+    map->slots[i].from = from;
+    map->slots[i].to = to;
+}
 
-        if (op->type & TUI_DIFF_DELETE) {
-            if (op->old_node && op->old_node->parent) {
-                tui_node_remove_child(op->old_node->parent, op->old_node);
-                tui_node_destroy(op->old_node);
-            }
+static tui_node* node_pair_map_get(const node_pair_map *map, const tui_node *from)
+{
+    size_t i = node_pair_hash(from) & map->mask;
+    while (map->slots[i].from) {
+        if (map->slots[i].from == from) return map->slots[i].to;
+        i = (i + 1) & map->mask;
+    }
+    return NULL;
+}
+
+/* Yoga only allows nodes with a measure function to be dirtied by hand */
+static void mark_measure_dirty(tui_node *node)
+{
+    if (node->yoga_node && YGNodeHasMeasureFunc(node->yoga_node)) {
+        YGNodeMarkDirty(node->yoga_node);
+    }
+}
+
+static int strings_differ(const char *a, const char *b)
+{
+    if (a == b) return 0;
+    if (!a || !b) return 1;
+    return strcmp(a, b) != 0;
+}
+
+/* Does the patch change what the rasterizer draws for this node? */
+static int paint_props_differ(const tui_node *a, const tui_node *b)
+{
+    return memcmp(&a->style, &b->style, sizeof(tui_style)) != 0 ||
+           a->border_style != b->border_style ||
+           memcmp(&a->border_color, &b->border_color, sizeof(tui_color)) != 0 ||
+           a->wrap_mode != b->wrap_mode ||
+           a->clip_x != b->clip_x || a->clip_y != b->clip_y ||
+           strings_differ(a->text, b->text) ||
+           strings_differ(a->hyperlink_url, b->hyperlink_url) ||
+           strings_differ(a->hyperlink_id, b->hyperlink_id);
+}
+
+/* Grow node's lost area by the rect x, y, w, h */
+static void add_lost_area(tui_node *node, int x, int y, int w, int h)
+{
+    if (w <= 0 || h <= 0) return;
+
+    if (node->lost_w <= 0 || node->lost_h <= 0) {
+        node->lost_x = x;
+        node->lost_y = y;
+        node->lost_w = w;
+        node->lost_h = h;
+        return;
+    }
+
+    int x0 = x < node->lost_x ? x : node->lost_x;
+    int y0 = y < node->lost_y ? y : node->lost_y;
+    int x1 = x + w > node->lost_x + node->lost_w ? x + w : node->lost_x + node->lost_w;
+    int y1 = y + h > node->lost_y + node->lost_h ? y + h : node->lost_y + node->lost_h;
+    node->lost_x = x0;
+    node->lost_y = y0;
+    node->lost_w = x1 - x0;
+    node->lost_h = y1 - y0;
+}
+
+/* Record everything a subtree painted, so the next frame clears it */
+static void note_painted_area(tui_node *parent, const tui_node *node, int depth)
+{
+    if (!node || depth >= MAX_TREE_DEPTH) return;
+
+    add_lost_area(parent, node->paint_x, node->paint_y, node->paint_w, node->paint_h);
+    add_lost_area(parent, node->lost_x, node->lost_y, node->lost_w, node->lost_h);
+    for (int i = 0; i < node->child_count; i++) {
+        note_painted_area(parent, node->children[i], depth + 1);
+    }
+}
+
+/*
+ * Copy properties from new_node onto old_node.
+ * Focus state and static progress are owned by the app and kept.
+ */
+static void patch_node_props(tui_node *old_node, tui_node *new_node)
+{
+    if (!old_node->paint_dirty && paint_props_differ(old_node, new_node)) {
+        old_node->paint_dirty = 1;
+        /* Toggling overflow changes what the subtree shows outside the box */
+        if (old_node->clip_x != new_node->clip_x || old_node->clip_y != new_node->clip_y) {
+            note_painted_area(old_node, old_node, 0);
         }
     }
 
-    /* Pass 2: Updates (property sync - preserves Yoga nodes!) */
-    for (int i = 0; i < diff->count; i++) {
-        tui_diff_op *op = &diff->ops[i];
+    old_node->style = new_node->style;
+
+    /* Border properties */
+    old_node->border_style = new_node->border_style;
+    old_node->border_color = new_node->border_color;
+    old_node->border_top_color = new_node->border_top_color;
+    old_node->border_right_color = new_node->border_right_color;
+    old_node->border_bottom_color = new_node->border_bottom_color;
+    old_node->border_left_color = new_node->border_left_color;
+    old_node->clip_x = new_node->clip_x;
+    old_node->clip_y = new_node->clip_y;
+
+    /* Focus configuration (focused state is managed by the app, not copied) */
+    old_node->focusable = new_node->focusable;
+    old_node->tab_index = new_node->tab_index;
+    old_node->auto_focus = new_node->auto_focus;
+    old_node->focus_trap = new_node->focus_trap;
+    old_node->show_cursor = new_node->show_cursor;
+    if (strings_differ(old_node->focus_group, new_node->focus_group)) {
+        tui_node_set_focus_group(old_node, new_node->focus_group);
+    }
 
-        if (op->type & TUI_DIFF_UPDATE) {
-            if (op->old_node && op->new_node) {
-                /* Update style */
-                op->old_node->style = op->new_node->style;
-
-                /* Update border properties */
-                op->old_node->border_style = op->new_node->border_style;
-                op->old_node->border_color = op->new_node->border_color;
-                op->old_node->border_top_color = op->new_node->border_top_color;
-                op->old_node->border_right_color = op->new_node->border_right_color;
-                op->old_node->border_bottom_color = op->new_node->border_bottom_color;
-                op->old_node->border_left_color = op->new_node->border_left_color;
-
-                /* Update focus state */
-                op->old_node->focusable = op->new_node->focusable;
-                /* Note: focused state is managed by the app, not copied */
-
-                /* Update text content for text nodes */
-                if (op->old_node->type == TUI_NODE_TEXT &&
-                    op->new_node->type == TUI_NODE_TEXT) {
-                    /* Only update if text actually changed */
-                    int text_changed = 0;
-                    if (op->old_node->text && op->new_node->text) {
-                        text_changed = strcmp(op->old_node->text, op->new_node->text) != 0;
-                    } else {
-                        text_changed = op->old_node->text != op->new_node->text;
-                    }
-
-                    if (text_changed) {
-                        if (op->new_node->text) {
-                            /* Validate length before strdup */
-                            size_t text_len = strlen(op->new_node->text);
-                            if (text_len <= TUI_MAX_TEXT_LENGTH) {
-                                char *new_text = strdup(op->new_node->text);
-                                if (new_text) {
-                                    free(op->old_node->text);
-                                    op->old_node->text = new_text;
-                                    /* Mark Yoga node dirty for text measurement */
-                                    if (op->old_node->yoga_node) {
-                                        YGNodeMarkDirty(op->old_node->yoga_node);
-                                    }
-                                }
-                            }
-                            /* Silently ignore oversized text in reconciler -
-                             * the create path already validated */
-                        } else {
-                            free(op->old_node->text);
-                            op->old_node->text = NULL;
-                            if (op->old_node->yoga_node) {
-                                YGNodeMarkDirty(op->old_node->yoga_node);
-                            }
-                        }
-                    }
-                }
+    if (strings_differ(old_node->id, new_node->id)) {
+        tui_node_set_id(old_node, new_node->id);
+    }
 
-                /* Update wrap mode */
-                op->old_node->wrap_mode = op->new_node->wrap_mode;
-            }
+    if (strings_differ(old_node->hyperlink_url, new_node->hyperlink_url) ||
+        strings_differ(old_node->hyperlink_id, new_node->hyperlink_id)) {
+        tui_node_set_hyperlink(old_node, new_node->hyperlink_url, new_node->hyperlink_id);
+    }
+
+    old_node->newline_count = new_node->newline_count;
+
+    /* Text content - swap buffers instead of copying, new_node is discarded.
+     * Arena text dies with the arena, so that one is copied. */
+    if (strings_differ(old_node->text, new_node->text)) {
+        char *text = new_node->text;
+        if (new_node->arena && text) {
+            text = strdup(text);    /* Keeps the old text if this fails */
+        }
+        if (text || !new_node->text) {
+            free(old_node->text);
+            old_node->text = text;
+            new_node->text = NULL;
+            tui_text_run_free(old_node->text_run);
+            old_node->text_run = new_node->text_run;
+            new_node->text_run = NULL;
+            mark_measure_dirty(old_node);
         }
     }
 
-    /* Pass 3: Replacements */
-    for (int i = 0; i < diff->count; i++) {
-        tui_diff_op *op = &diff->ops[i];
+    if (old_node->wrap_mode != new_node->wrap_mode) {
+        old_node->wrap_mode = new_node->wrap_mode;
+        mark_measure_dirty(old_node);
+    }
 
-        if (op->type & TUI_DIFF_REPLACE) {
-            if (op->old_node && op->new_node && op->old_node->parent) {
-                tui_node *parent = op->old_node->parent;
-                int insert_index = op->new_index >= 0 ? op->new_index : 0;
+    /* Layout style: Yoga only dirties the node if the style actually differs */
+    if (old_node->yoga_node && new_node->yoga_node) {
+        YGNodeCopyStyle(old_node->yoga_node, new_node->yoga_node);
+    }
+}
 
-                /* Remove old node */
-                tui_node_remove_child(parent, op->old_node);
+/* Forget the focused node if it is in the subtree about to be destroyed.
+ * Walks up from the focused node, so only live nodes are dereferenced. */
+static void drop_focus_in(tui_node **focused, const tui_node *subtree)
+{
+    if (!focused) return;
 
-                /* Insert new node at target position */
-                int result;
-                if (insert_index < parent->child_count) {
-                    result = tui_node_insert_before(parent, op->new_node, parent->children[insert_index]);
-                } else {
-                    result = tui_node_append_child(parent, op->new_node);
-                }
+    for (const tui_node *p = *focused; p; p = p->parent) {
+        if (p == subtree) {
+            *focused = NULL;
+            return;
+        }
+    }
+}
 
-                if (result < 0) {
-                    /* Failed to insert - destroy new node to prevent leak */
-                    tui_node_destroy(op->new_node);
-                    op->new_node = NULL;
-                }
+/*
+ * Make old_parent's children mirror new_parent's children.
+ * Matched children are looked up through new_to_old; anything else is
+ * moved over from the new tree.
+ */
+static void patch_children(tui_node *old_parent, tui_node *new_parent,
+                           const node_pair_map *new_to_old,
+                           const node_pair_map *old_to_new,
+                           tui_node **focused)
+{
+    int new_count = new_parent->child_count;
+
+    /* A Static node's leading items were already printed (inline mode);
+     * their twins stay in the new tree and are discarded with it */
+    int first = old_parent->type == TUI_NODE_STATIC ? old_parent->static_items_rendered : 0;
+
+    /* Delete old children that have no counterpart (includes replaced nodes) */
+    for (int i = old_parent->child_count - 1; i >= 0; i--) {
+        tui_node *old_child = old_parent->children[i];
+        if (old_child && !node_pair_map_get(old_to_new, old_child)) {
+            note_painted_area(old_parent, old_child, 0);
+            drop_focus_in(focused, old_child);
+            tui_node_remove_child(old_parent, old_child);
+            tui_node_destroy(old_child);
+        }
+    }
+
+    if (new_count <= first) return;
+
+    /* Snapshot targets: moving a node out of new_parent mutates its array */
+    tui_node **targets = malloc((size_t)new_count * sizeof(tui_node*));
+    if (!targets) return;
+
+    for (int i = first; i < new_count; i++) {
+        tui_node *new_child = new_parent->children[i];
+        tui_node *matched = new_child ? node_pair_map_get(new_to_old, new_child) : NULL;
+        targets[i] = matched ? matched : new_child;
+    }
+
+    int pos = 0;
+    for (int i = first; i < new_count; i++) {
+        tui_node *target = targets[i];
+        if (!target) continue;
 
-                tui_node_destroy(op->old_node);
+        if (pos < old_parent->child_count && old_parent->children[pos] == target) {
+            pos++;
+            continue;
+        }
+
+        /* Detach from wherever it lives now (old_parent on reorder, new tree on create) */
+        if (target->parent) {
+            tui_node_remove_child(target->parent, target);
+        }
+
+        /* Created in the frame arena: move to the heap to outlive it */
+        if (target->arena) {
+            tui_node *moved = tui_node_promote(target);
+            if (!moved) {
+                tui_node_destroy(target);
+                continue;
             }
+            target = moved;
+        }
+
+        int result;
+        if (pos < old_parent->child_count) {
+            result = tui_node_insert_before(old_parent, target, old_parent->children[pos]);
+        } else {
+            result = tui_node_append_child(old_parent, target);
+        }
+
+        if (result < 0) {
+            /* Only a node moved in from the new tree can need a larger
+             * children array, and its subtree holds no paired nodes. */
+            tui_node_destroy(target);
+            continue;
         }
+        pos++;
     }
 
-    /* Pass 4: Reorders - move nodes to new positions */
+    free(targets);
+}
+
+void tui_reconciler_apply(tui_node *tree, tui_diff_result *diff, tui_node **focused)
+{
+    if (!tree || !diff || diff->count == 0 || diff->failed) return;
+
+    /*
+     * Two passes over the diff:
+     * 1. UPDATE pairs: copy properties, record old <-> new mapping.
+     * 2. UPDATE pairs again (pre-order): rebuild each child list, which
+     *    covers DELETE, REPLACE, REORDER and CREATE in one step.
+     */
+    int pairs = 0;
     for (int i = 0; i < diff->count; i++) {
-        tui_diff_op *op = &diff->ops[i];
+        if (diff->ops[i].type & TUI_DIFF_UPDATE) pairs++;
+    }
+    if (pairs == 0) return;
 
-        if (op->type & TUI_DIFF_REORDER) {
-            if (op->old_node && op->old_node->parent) {
-                tui_node *parent = op->old_node->parent;
-                tui_node *node = op->old_node;
-                int target_index = op->new_index;
-
-                /* Find current position */
-                int current_index = -1;
-                for (int j = 0; j < parent->child_count; j++) {
-                    if (parent->children[j] == node) {
-                        current_index = j;
-                        break;
-                    }
-                }
+    node_pair_map new_to_old;
+    node_pair_map old_to_new;
+    if (node_pair_map_init(&new_to_old, pairs) != 0) return;
+    if (node_pair_map_init(&old_to_new, pairs) != 0) {
+        free(new_to_old.slots);
+        return;
+    }
 
-                if (current_index >= 0 && current_index != target_index) {
-                    /* Remove from current position */
-                    tui_node_remove_child(parent, node);
-
-                    /* Insert at target position - if this fails, the node
-                     * becomes orphaned. This is an edge case (OOM) that we
-                     * can't fully recover from, but at least we don't leak. */
-                    int result;
-                    if (target_index < parent->child_count) {
-                        result = tui_node_insert_before(parent, node, parent->children[target_index]);
-                    } else {
-                        result = tui_node_append_child(parent, node);
-                    }
-                    (void)result;  /* Node stays orphaned on failure - unavoidable in reorder */
-                }
-            }
+    /* Pass 1: Updates (property sync - preserves Yoga nodes!) */
+    for (int i = 0; i < diff->count; i++) {
+        tui_diff_op *op = &diff->ops[i];
+        if ((op->type & TUI_DIFF_UPDATE) && op->old_node && op->new_node) {
+            patch_node_props(op->old_node, op->new_node);
+            node_pair_map_put(&new_to_old, op->new_node, op->old_node);
+            node_pair_map_put(&old_to_new, op->old_node, op->new_node);
         }
     }
 
-    /* Pass 5: Creations */
+    /* Pass 2: Structure. Parents precede their children in the diff, so
+     * every paired node is already in its final parent when visited. */
     for (int i = 0; i < diff->count; i++) {
         tui_diff_op *op = &diff->ops[i];
+        if ((op->type & TUI_DIFF_UPDATE) && op->old_node && op->new_node) {
+            patch_children(op->old_node, op->new_node, &new_to_old, &old_to_new, focused);
+        }
+    }
 
-        if (op->type & TUI_DIFF_CREATE) {
-            if (op->new_node && op->new_node->parent) {
-                tui_node *parent = op->new_node->parent;
-                int target_index = op->new_index >= 0 ? op->new_index : parent->child_count;
+    free(new_to_old.slots);
+    free(old_to_new.slots);
+}
 
-                int result;
-                if (target_index < parent->child_count) {
-                    result = tui_node_insert_before(parent, op->new_node, parent->children[target_index]);
-                } else {
-                    result = tui_node_append_child(parent, op->new_node);
-                }
+/* The new tree becomes the live one; arena nodes move to the heap */
+static tui_node* adopt_tree(tui_node *tree)
+{
+    if (!tree || !tree->arena) return tree;
 
-                if (result < 0) {
-                    /* Failed to insert - destroy node to prevent leak */
-                    tui_node_destroy(op->new_node);
-                    op->new_node = NULL;
-                }
-            }
-        }
+    tui_node *moved = tui_node_promote(tree);
+    if (!moved) tui_node_destroy(tree);
+    return moved;
+}
+
+tui_node* tui_reconciler_reconcile(tui_node *old_tree, tui_node *new_tree, tui_node **focused)
+{
+    if (!old_tree) return adopt_tree(new_tree);
+    if (!new_tree) {
+        drop_focus_in(focused, old_tree);
+        tui_node_destroy(old_tree);
+        return NULL;
     }
+
+    tui_diff_result *diff = tui_reconciler_diff(old_tree, new_tree);
+    if (!diff || diff->failed || diff->count == 0 || !(diff->ops[0].type & TUI_DIFF_UPDATE)) {
+        /* Root type changed (or OOM): swap trees wholesale */
+        tui_reconciler_free_diff(diff);
+        drop_focus_in(focused, old_tree);
+        tui_node_destroy(old_tree);
+        return adopt_tree(new_tree);
+    }
+
+    tui_reconciler_apply(old_tree, diff, focused);
+    tui_reconciler_free_diff(diff);
+
+    /* Whatever is left of the new tree are the discarded twins of patched nodes */
+    tui_node_destroy(new_tree);
+    return old_tree;
 }
 
 void tui_reconciler_free_diff(tui_diff_result *diff)
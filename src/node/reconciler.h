@@ -35,13 +35,25 @@ typedef struct {
     tui_diff_op *ops;
     int count;
     int capacity;
+    int failed;      /* 1 if an allocation failed and ops are incomplete */
 } tui_diff_result;
 
 /* Diff two trees */
 tui_diff_result* tui_reconciler_diff(tui_node *old_tree, tui_node *new_tree);
 
-/* Apply diff to tree */
-void tui_reconciler_apply(tui_node *tree, tui_diff_result *diff);
+/*
+ * Apply diff to tree in place (moves created nodes out of the new tree).
+ * If *focused (when focused is not NULL) is destroyed, it is set to NULL.
+ */
+void tui_reconciler_apply(tui_node *tree, tui_diff_result *diff, tui_node **focused);
+
+/*
+ * Diff new_tree against old_tree and patch old_tree in place, keeping its
+ * Yoga nodes and cached measurements. Consumes new_tree. Returns the root
+ * to keep: old_tree when patched, new_tree when the root had to be replaced
+ * (or the diff ran out of memory). *focused is cleared like in apply.
+ */
+tui_node* tui_reconciler_reconcile(tui_node *old_tree, tui_node *new_tree, tui_node **focused);
 
 /* Free diff result */
 void tui_reconciler_free_diff(tui_diff_result *diff);
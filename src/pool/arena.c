@@ -0,0 +1,140 @@
+/*
+  +----------------------------------------------------------------------+
+  | ext-tui: Bump arena implementation                                  |
+  +----------------------------------------------------------------------+
+  | Requests larger than a quarter chunk get a chunk of their own, so   |
+  | one big string doesn't waste the rest of a regular chunk.           |
+  +----------------------------------------------------------------------+
+*/
+
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Chunk header rounded up so the payload stays aligned */
+#define CHUNK_HEADER \
+    ((sizeof(tui_arena_chunk) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+#define CHUNK_DATA(chunk) ((char*)(chunk) + CHUNK_HEADER)
+
+static tui_arena_chunk* chunk_new(tui_arena *arena, size_t size)
+{
+    if (size > SIZE_MAX - CHUNK_HEADER) return NULL;
+
+    tui_arena_chunk *chunk = malloc(CHUNK_HEADER + size);
+    if (!chunk) return NULL;
+
+    chunk->size = size;
+    chunk->used = 0;
+    arena->chunks++;
+    return chunk;
+}
+
+static void* arena_alloc(tui_arena *arena, size_t size)
+{
+    if (!arena || size == 0) return NULL;
+    if (size > SIZE_MAX - ARENA_ALIGN) return NULL;
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    tui_arena_chunk *chunk = arena->head;
+    if (!chunk || chunk->size - chunk->used < size) {
+        if (size > ARENA_CHUNK_SIZE / 4) {
+            /* Oversized: own chunk, kept behind head so head keeps filling */
+            tui_arena_chunk *big = chunk_new(arena, size);
+            if (!big) return NULL;
+            big->used = size;
+            if (chunk) {
+                big->next = chunk->next;
+                chunk->next = big;
+            } else {
+                big->next = NULL;
+                arena->head = big;
+            }
+            arena->used += size;
+            if (arena->used > arena->peak) arena->peak = arena->used;
+            return CHUNK_DATA(big);
+        }
+
+        if (arena->spare) {
+            chunk = arena->spare;
+            arena->spare = chunk->next;
+            chunk->used = 0;
+        } else {
+            chunk = chunk_new(arena, ARENA_CHUNK_SIZE);
+            if (!chunk) return NULL;
+        }
+        chunk->next = arena->head;
+        arena->head = chunk;
+    }
+
+    void *p = CHUNK_DATA(chunk) + chunk->used;
+    chunk->used += size;
+    arena->used += size;
+    if (arena->used > arena->peak) arena->peak = arena->used;
+    return p;
+}
+
+int tui_arena_init(tui_arena *arena)
+{
+    if (!arena) return -1;
+
+    memset(arena, 0, sizeof(tui_arena));
+    return 0;
+}
+
+void tui_arena_shutdown(tui_arena *arena)
+{
+    if (!arena) return;
+
+    tui_arena_reset(arena);
+    while (arena->spare) {
+        tui_arena_chunk *next = arena->spare->next;
+        free(arena->spare);
+        arena->spare = next;
+    }
+    arena->chunks = 0;
+}
+
+void tui_arena_reset(tui_arena *arena)
+{
+    if (!arena) return;
+
+    tui_arena_chunk *chunk = arena->head;
+    while (chunk) {
+        tui_arena_chunk *next = chunk->next;
+        if (chunk->size == ARENA_CHUNK_SIZE) {
+            chunk->next = arena->spare;
+            arena->spare = chunk;
+        } else {
+            free(chunk);
+            arena->chunks--;
+        }
+        chunk = next;
+    }
+    arena->head = NULL;
+    arena->used = 0;
+    arena->resets++;
+}
+
+void* tui_arena_calloc(tui_arena *arena, size_t size)
+{
+    void *p = arena_alloc(arena, size);
+    if (p) memset(p, 0, size);
+    return p;
+}
+
+char* tui_arena_strndup(tui_arena *arena, const char *str, size_t len)
+{
+    if (!str || len == SIZE_MAX) return NULL;
+
+    char *copy = arena_alloc(arena, len + 1);
+    if (!copy) return NULL;
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+    return copy;
+}
+
+char* tui_arena_strdup(tui_arena *arena, const char *str)
+{
+    return str ? tui_arena_strndup(arena, str, strlen(str)) : NULL;
+}
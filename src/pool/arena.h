@@ -0,0 +1,88 @@
+/*
+  +----------------------------------------------------------------------+
+  | ext-tui: Bump arena                                                 |
+  +----------------------------------------------------------------------+
+  | Chunked bump allocator for memory that dies all at once: the node   |
+  | tree built for one frame and the strings it owns. Allocation is a   |
+  | pointer bump; nothing is freed individually. tui_arena_reset()      |
+  | releases everything and keeps the chunks for the next frame.        |
+  |                                                                       |
+  | Thread Safety: NOT thread-safe. Owned by the pools or a test        |
+  | renderer and used only from the main thread.                          |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef TUI_ARENA_H
+#define TUI_ARENA_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Arena configuration */
+#define ARENA_CHUNK_SIZE  65536      /* Bytes per regular chunk */
+#define ARENA_ALIGN       16         /* Alignment of every allocation */
+
+typedef struct tui_arena_chunk {
+    struct tui_arena_chunk *next;
+    size_t size;                     /* Usable bytes after the header */
+    size_t used;
+} tui_arena_chunk;
+
+/**
+ * Bump arena. Zero-initialized memory is a valid empty arena.
+ */
+typedef struct tui_arena {
+    tui_arena_chunk *head;           /* Chunk being filled */
+    tui_arena_chunk *spare;          /* Regular chunks kept by reset */
+    size_t used;                     /* Bytes handed out since reset */
+    size_t peak;                     /* Most bytes handed out between resets */
+    int chunks;                      /* Chunks allocated (in use and spare) */
+    int64_t resets;                  /* Times reset */
+} tui_arena;
+
+/**
+ * Initialize an arena (allocates nothing).
+ * @param arena Arena to initialize
+ * @return 0 on success, -1 on failure
+ */
+int tui_arena_init(tui_arena *arena);
+
+/**
+ * Free all chunks.
+ * @param arena Arena to shutdown (NULL-safe)
+ */
+void tui_arena_shutdown(tui_arena *arena);
+
+/**
+ * Release every allocation at once. Regular chunks are kept for reuse,
+ * oversized ones are freed.
+ * @param arena Arena to reset (NULL-safe)
+ */
+void tui_arena_reset(tui_arena *arena);
+
+/**
+ * Allocate zeroed memory, aligned to ARENA_ALIGN.
+ * @param arena Arena
+ * @param size  Bytes (> 0)
+ * @return Pointer valid until the next reset, or NULL on failure
+ */
+void* tui_arena_calloc(tui_arena *arena, size_t size);
+
+/**
+ * Copy len bytes of str plus a terminating NUL into the arena.
+ * @param arena Arena
+ * @param str   Bytes to copy (need not be NUL-terminated)
+ * @param len   Length of str
+ * @return Copy, or NULL on failure
+ */
+char* tui_arena_strndup(tui_arena *arena, const char *str, size_t len);
+
+/**
+ * Copy a NUL-terminated string into the arena.
+ * @param arena Arena
+ * @param str   String to copy
+ * @return Copy, or NULL on failure (or NULL str)
+ */
+char* tui_arena_strdup(tui_arena *arena, const char *str);
+
+#endif /* TUI_ARENA_H */
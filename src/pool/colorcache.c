@@ -0,0 +1,62 @@
+/*
+  +----------------------------------------------------------------------+
+  | ext-tui: Parsed color cache implementation                          |
+  +----------------------------------------------------------------------+
+  | Slot from a multiplicative hash of the key address; the low bits    |
+  | alone are zero (allocation alignment) and would crowd a few slots.  |
+  +----------------------------------------------------------------------+
+*/
+
+#include "colorcache.h"
+#include <string.h>
+
+static int slot_of(const void *key)
+{
+    uint64_t h = (uint64_t)(uintptr_t)key * 0x9E3779B97F4A7C15ULL;
+    return (int)((h >> 32) & (COLOR_CACHE_ENTRIES - 1));
+}
+
+int tui_color_cache_init(tui_color_cache *cache)
+{
+    if (!cache) return -1;
+
+    memset(cache, 0, sizeof(tui_color_cache));
+    return 0;
+}
+
+void tui_color_cache_reset(tui_color_cache *cache)
+{
+    if (!cache) return;
+
+    memset(cache->entries, 0, sizeof(cache->entries));
+}
+
+int tui_color_cache_get(tui_color_cache *cache, const void *key, tui_color *color, int *parsed)
+{
+    if (!cache || !key) return 0;
+
+    tui_color_cache_entry *e = &cache->entries[slot_of(key)];
+    if (e->key != key) {
+        cache->misses++;
+        return 0;
+    }
+
+    cache->hits++;
+    if (e->parsed && color) *color = e->color;
+    if (parsed) *parsed = e->parsed;
+    return 1;
+}
+
+void tui_color_cache_put(tui_color_cache *cache, const void *key, const tui_color *color, int parsed)
+{
+    if (!cache || !key) return;
+
+    tui_color_cache_entry *e = &cache->entries[slot_of(key)];
+    e->key = key;
+    e->parsed = parsed && color;
+    if (e->parsed) {
+        e->color = *color;
+    } else {
+        memset(&e->color, 0, sizeof(tui_color));
+    }
+}
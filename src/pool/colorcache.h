@@ -0,0 +1,77 @@
+/*
+  +----------------------------------------------------------------------+
+  | ext-tui: Parsed color cache                                         |
+  +----------------------------------------------------------------------+
+  | Remembers what color strings ('#ff8800', 'coral', ...) parsed to,   |
+  | keyed by the address of the PHP interned string holding them, so   |
+  | the same literal on every node of every frame is parsed once.       |
+  |                                                                       |
+  | Only interned strings may be used as keys: they stay at one address |
+  | until the request ends, and the cache is cleared at the start of   |
+  | each request. Direct-mapped; a colliding string replaces the entry. |
+  |                                                                       |
+  | Thread Safety: NOT thread-safe. Lives in the per-thread pools and is |
+  | only used from the main thread while converting nodes.               |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef TUI_COLORCACHE_H
+#define TUI_COLORCACHE_H
+
+#include <stdint.h>
+#include "../node/node.h"
+
+/* Cache configuration */
+#define COLOR_CACHE_ENTRIES 256     /* Slots (power of two) */
+
+/**
+ * Cached parse result. A string that isn't a color is cached too.
+ */
+typedef struct {
+    const void *key;                /* Interned string, NULL if empty */
+    tui_color color;                /* Parsed color (when parsed) */
+    int parsed;                     /* 1 if the string was a valid color */
+} tui_color_cache_entry;
+
+/**
+ * Parsed color cache.
+ */
+typedef struct tui_color_cache {
+    tui_color_cache_entry entries[COLOR_CACHE_ENTRIES];
+    int64_t hits;                   /* Lookups answered from the cache */
+    int64_t misses;                 /* Lookups that had to parse */
+} tui_color_cache;
+
+/**
+ * Initialize the cache.
+ * @param cache Cache to initialize
+ * @return 0 on success, -1 on failure
+ */
+int tui_color_cache_init(tui_color_cache *cache);
+
+/**
+ * Drop all entries between requests (counters are kept).
+ * @param cache Cache to reset
+ */
+void tui_color_cache_reset(tui_color_cache *cache);
+
+/**
+ * Find a cached parse result. Counts a hit or a miss.
+ * @param cache  Cache
+ * @param key    Interned string
+ * @param color  Receives the color on a hit (if parsed)
+ * @param parsed Receives 1 if the string was a valid color, 0 if not
+ * @return 1 on hit, 0 on miss
+ */
+int tui_color_cache_get(tui_color_cache *cache, const void *key, tui_color *color, int *parsed);
+
+/**
+ * Store a parse result, replacing whatever shared its slot.
+ * @param cache  Cache
+ * @param key    Interned string
+ * @param color  Parsed color (ignored unless parsed)
+ * @param parsed 1 if the string was a valid color, 0 if not
+ */
+void tui_color_cache_put(tui_color_cache *cache, const void *key, const tui_color *color, int parsed);
+
+#endif /* TUI_COLORCACHE_H */
@@ -35,6 +35,18 @@ int tui_pools_init(tui_pools *pools)
         return -1;
     }
 
+    if (tui_wrap_cache_init(&pools->wrap_cache) != 0) {
+        return -1;
+    }
+
+    if (tui_color_cache_init(&pools->color_cache) != 0) {
+        return -1;
+    }
+
+    if (tui_arena_init(&pools->frame_arena) != 0) {
+        return -1;
+    }
+
     return 0;
 }
 
@@ -45,6 +57,12 @@ void tui_pools_shutdown(tui_pools *pools)
     /* Shutdown intern pool first (nodes may reference interned strings) */
     tui_intern_pool_shutdown(&pools->intern);
 
+    tui_wrap_cache_shutdown(&pools->wrap_cache);
+
+    /* Nodes are gone by now, so nothing points into the arena */
+    tui_arena_shutdown(&pools->frame_arena);
+    pools->node_arena = NULL;
+
     /* Free any pooled children arrays */
     for (int i = 0; i < pools->children.count_4; i++) {
         free(pools->children.arrays_4[i]);
@@ -68,19 +86,38 @@ void tui_pools_shutdown(tui_pools *pools)
     /* Free key map */
     free(pools->key_map.entries);
     pools->key_map.entries = NULL;
+
+    /* Free pooled Yoga nodes (before the Yoga config, see lifecycle above) */
+    while (pools->yoga.head) {
+        YGNodeRef next = YGNodeGetContext(pools->yoga.head);
+        YGNodeFree(pools->yoga.head);
+        pools->yoga.head = next;
+    }
+    pools->yoga.count = 0;
 }
 
 void tui_pools_reset(tui_pools *pools)
 {
     if (!pools) return;
 
-    /* Don't free children arrays - they can be reused across requests */
+    /* Don't free children arrays or Yoga nodes - they can be reused across requests */
 
     /* Key map can be reused */
     pools->key_map.in_use = 0;
 
     /* Reset intern pool (frees all interned strings for next request) */
     tui_intern_pool_reset(&pools->intern);
+
+    /* Drop last request's wrapped lines */
+    tui_wrap_cache_reset(&pools->wrap_cache);
+
+    /* Request-interned strings the color cache is keyed by are gone */
+    tui_color_cache_reset(&pools->color_cache);
+
+    /* An aborted request may have left the frame arena acquired */
+    tui_arena_reset(&pools->frame_arena);
+    pools->frame_arena_busy = 0;
+    pools->node_arena = NULL;
 }
 
 /*
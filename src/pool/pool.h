@@ -27,6 +27,9 @@
 
 #include <stdint.h>
 #include "intern.h"
+#include "wrapcache.h"
+#include "colorcache.h"
+#include "arena.h"
 
 /* Forward declarations */
 struct tui_node;
@@ -69,13 +72,34 @@ typedef struct {
     int in_use;
 } tui_key_map_pool;
 
+/*
+ * Yoga Node Pool
+ * Freed Yoga nodes, already reset, kept for the next tui_node_create_*().
+ * Chained through their context pointer, so the list costs no memory.
+ * Sized for a large tree being rebuilt every frame.
+ */
+#define YOGA_NODE_POOL_MAX      16384
+
+typedef struct {
+    struct YGNode *head;        /* First free node (YGNodeRef) */
+    int count;
+} tui_yoga_pool;
+
 /*
  * Combined pool structure for module globals
  */
 typedef struct tui_pools {
     tui_children_pool children;
     tui_key_map_pool key_map;
+    tui_yoga_pool yoga;             /* Recycled Yoga nodes */
     tui_intern_pool intern;         /* String interning pool for keys/IDs */
+    tui_wrap_cache wrap_cache;      /* Wrapped text lines across frames */
+    tui_color_cache color_cache;    /* Parsed color strings */
+
+    /* Node arena (tui.node_arena): see tui_node_arena_acquire() */
+    tui_arena frame_arena;          /* Tree built for one reconcile */
+    int frame_arena_busy;           /* frame_arena acquired */
+    tui_arena *node_arena;          /* Where new nodes go, NULL = heap */
 
     /* Pool metrics */
     int64_t children_hits;          /* Successful pool allocations */
@@ -83,6 +107,11 @@ typedef struct tui_pools {
     int64_t children_returns;       /* Arrays returned to pool */
     int64_t key_map_reuses;         /* Key map reuses (pool hits) */
     int64_t key_map_misses;         /* Key map fallbacks to malloc */
+    int64_t arena_promotions;       /* Arena nodes moved to the heap by the reconciler */
+    int64_t yoga_hits;              /* Yoga nodes handed out from the pool */
+    int64_t yoga_misses;            /* Yoga nodes allocated because the pool was empty */
+    int64_t yoga_returns;           /* Yoga nodes reset and pooled */
+    int64_t yoga_discards;          /* Yoga nodes freed because the pool was full */
 } tui_pools;
 
 /* Pool lifecycle (called from MINIT/MSHUTDOWN) */
@@ -0,0 +1,192 @@
+/*
+  +----------------------------------------------------------------------+
+  | ext-tui: Wrapped text cache implementation                          |
+  +----------------------------------------------------------------------+
+  | Fixed entry array with chained buckets and an intrusive LRU list.   |
+  | The run's 64-bit FNV-1a hash plus its length, glyph count and width |
+  | pick the candidate; its stored text is compared before it is used.  |
+  +----------------------------------------------------------------------+
+*/
+
+#include "wrapcache.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ENTRY(cache, link) (&(cache)->entries[(link) - 1])
+
+static int bucket_of(uint64_t hash, int width, int mode)
+{
+    uint64_t h = hash ^ ((uint64_t)(unsigned)width * 0x9E3779B97F4A7C15ULL) ^ (uint64_t)mode;
+    return (int)((h ^ (h >> 32)) & (WRAP_CACHE_BUCKETS - 1));
+}
+
+static int entry_matches(const tui_wrap_cache_entry *e, const char *text,
+                         const tui_text_run *run, int width, int mode)
+{
+    return e->hash == run->hash && e->bytes == run->bytes &&
+           e->glyphs == run->count && e->text_width == run->width &&
+           e->width == width && e->mode == mode &&
+           memcmp(e->text, text, (size_t)run->bytes) == 0;
+}
+
+static void lru_unlink(tui_wrap_cache *cache, int link)
+{
+    tui_wrap_cache_entry *e = ENTRY(cache, link);
+
+    if (e->prev) ENTRY(cache, e->prev)->next = e->next;
+    else cache->head = e->next;
+    if (e->next) ENTRY(cache, e->next)->prev = e->prev;
+    else cache->tail = e->prev;
+    e->prev = e->next = 0;
+}
+
+static void lru_push_front(tui_wrap_cache *cache, int link)
+{
+    tui_wrap_cache_entry *e = ENTRY(cache, link);
+
+    e->prev = 0;
+    e->next = cache->head;
+    if (cache->head) ENTRY(cache, cache->head)->prev = link;
+    cache->head = link;
+    if (!cache->tail) cache->tail = link;
+}
+
+static void bucket_unlink(tui_wrap_cache *cache, int link)
+{
+    tui_wrap_cache_entry *e = ENTRY(cache, link);
+    int *p = &cache->buckets[bucket_of(e->hash, e->width, e->mode)];
+
+    while (*p && *p != link) p = &ENTRY(cache, *p)->chain;
+    if (*p) *p = e->chain;
+    e->chain = 0;
+}
+
+/* Wrap the whole run. Returns the spans (caller frees) or NULL. */
+static tui_line_span* wrap_spans(const tui_text_run *run, int width, tui_wrap_mode mode, int *count)
+{
+    int capacity = run->lines < 8 ? 8 : run->lines;
+    if (capacity > WRAP_CACHE_MAX_LINES) capacity = WRAP_CACHE_MAX_LINES;
+
+    tui_line_span *spans = malloc((size_t)capacity * sizeof(tui_line_span));
+    if (!spans) return NULL;
+
+    tui_wrap_iter it;
+    int offset, len, n = 0;
+    tui_wrap_iter_init(&it, run, width, mode);
+    while (tui_wrap_iter_next(&it, &offset, &len)) {
+        if (n == capacity) {
+            if (capacity >= WRAP_CACHE_MAX_LINES) {
+                free(spans);
+                return NULL;
+            }
+            int grown = capacity * 2 > WRAP_CACHE_MAX_LINES ? WRAP_CACHE_MAX_LINES : capacity * 2;
+            tui_line_span *more = realloc(spans, (size_t)grown * sizeof(tui_line_span));
+            if (!more) {
+                free(spans);
+                return NULL;
+            }
+            spans = more;
+            capacity = grown;
+        }
+        spans[n].offset = offset;
+        spans[n].len = len;
+        n++;
+    }
+
+    *count = n;
+    return spans;
+}
+
+int tui_wrap_cache_init(tui_wrap_cache *cache)
+{
+    if (!cache) return -1;
+
+    memset(cache, 0, sizeof(tui_wrap_cache));
+    return 0;
+}
+
+void tui_wrap_cache_shutdown(tui_wrap_cache *cache)
+{
+    if (!cache) return;
+
+    for (int i = 0; i < cache->used; i++) {
+        free(cache->entries[i].spans);
+        free(cache->entries[i].text);
+    }
+    memset(cache->entries, 0, sizeof(cache->entries));
+    memset(cache->buckets, 0, sizeof(cache->buckets));
+    cache->used = 0;
+    cache->head = cache->tail = 0;
+}
+
+void tui_wrap_cache_reset(tui_wrap_cache *cache)
+{
+    tui_wrap_cache_shutdown(cache);
+}
+
+const tui_line_span* tui_wrap_cache_get(tui_wrap_cache *cache, const char *text,
+                                        const tui_text_run *run, int width,
+                                        tui_wrap_mode mode, int *count)
+{
+    if (!cache || !text || !run || width < 1 || !count) return NULL;
+
+    /* Hard lines alone rule it out, no need to wrap to find out */
+    if (run->lines > WRAP_CACHE_MAX_LINES) return NULL;
+
+    int bucket = bucket_of(run->hash, width, (int)mode);
+    for (int link = cache->buckets[bucket]; link; link = ENTRY(cache, link)->chain) {
+        tui_wrap_cache_entry *e = ENTRY(cache, link);
+        if (entry_matches(e, text, run, width, (int)mode)) {
+            if (cache->head != link) {
+                lru_unlink(cache, link);
+                lru_push_front(cache, link);
+            }
+            cache->hits++;
+            *count = e->count;
+            return e->spans;
+        }
+    }
+
+    cache->misses++;
+
+    int n;
+    tui_line_span *spans = wrap_spans(run, width, mode, &n);
+    if (!spans) return NULL;
+
+    char *copy = malloc(run->bytes > 0 ? (size_t)run->bytes : 1);
+    if (!copy) {
+        free(spans);
+        return NULL;
+    }
+    memcpy(copy, text, (size_t)run->bytes);
+
+    /* Take a free entry, or the least recently used one */
+    int link;
+    if (cache->used < WRAP_CACHE_ENTRIES) {
+        link = ++cache->used;
+    } else {
+        link = cache->tail;
+        lru_unlink(cache, link);
+        bucket_unlink(cache, link);
+        free(ENTRY(cache, link)->spans);
+        free(ENTRY(cache, link)->text);
+        cache->evictions++;
+    }
+
+    tui_wrap_cache_entry *e = ENTRY(cache, link);
+    e->hash = run->hash;
+    e->text = copy;
+    e->bytes = run->bytes;
+    e->glyphs = run->count;
+    e->text_width = run->width;
+    e->width = width;
+    e->mode = (int)mode;
+    e->spans = spans;
+    e->count = n;
+    e->chain = cache->buckets[bucket];
+    cache->buckets[bucket] = link;
+    lru_push_front(cache, link);
+
+    *count = n;
+    return spans;
+}
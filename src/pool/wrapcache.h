@@ -0,0 +1,109 @@
+/*
+  +----------------------------------------------------------------------+
+  | ext-tui: Wrapped text cache                                         |
+  +----------------------------------------------------------------------+
+  | Remembers how recently wrapped texts were split into lines, keyed    |
+  | by (text hash, width, wrap mode), so unchanged paragraphs aren't     |
+  | wrapped again every frame.                                           |
+  |                                                                       |
+  | Entries hold line spans (byte offset and length into the text), so  |
+  | one entry serves every node showing the same string, plus a copy of  |
+  | the text that a hash match is confirmed against. Bounded to          |
+  | WRAP_CACHE_ENTRIES, least recently used entry evicted first.         |
+  |                                                                       |
+  | Thread Safety: NOT thread-safe. Lives in the per-thread pools and is |
+  | only used from the main thread while rendering.                      |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef TUI_WRAPCACHE_H
+#define TUI_WRAPCACHE_H
+
+#include <stdint.h>
+#include "../text/run.h"
+
+/* Cache configuration */
+#define WRAP_CACHE_ENTRIES   128     /* Wrapped texts kept */
+#define WRAP_CACHE_BUCKETS   256     /* Hash table buckets (power of two) */
+#define WRAP_CACHE_MAX_LINES 1024    /* Longer results aren't cached */
+
+/**
+ * One wrapped line: a byte range of the original text.
+ */
+typedef struct {
+    int offset;
+    int len;
+} tui_line_span;
+
+/**
+ * Cached wrap result. Links are entry index + 1, 0 meaning none.
+ */
+typedef struct {
+    uint64_t hash;                  /* tui_text_run hash */
+    char *text;                     /* Copy of the text (not terminated) */
+    int bytes;                      /* Text length */
+    int glyphs;                     /* Glyph count */
+    int text_width;                 /* Display width of the text */
+    int width;                      /* Wrap width */
+    int mode;                       /* tui_wrap_mode */
+    tui_line_span *spans;
+    int count;                      /* Lines */
+    int chain;                      /* Next entry in bucket */
+    int prev;                       /* LRU neighbour, more recent */
+    int next;                       /* LRU neighbour, less recent */
+} tui_wrap_cache_entry;
+
+/**
+ * Wrapped text cache.
+ */
+typedef struct tui_wrap_cache {
+    tui_wrap_cache_entry entries[WRAP_CACHE_ENTRIES];
+    int buckets[WRAP_CACHE_BUCKETS];
+    int used;                       /* Entries filled so far */
+    int head;                       /* Most recently used */
+    int tail;                       /* Least recently used */
+    int64_t hits;                   /* Lookups answered from the cache */
+    int64_t misses;                 /* Lookups that had to wrap */
+    int64_t evictions;              /* Entries dropped to make room */
+} tui_wrap_cache;
+
+/**
+ * Initialize the cache.
+ * @param cache Cache to initialize
+ * @return 0 on success, -1 on failure
+ */
+int tui_wrap_cache_init(tui_wrap_cache *cache);
+
+/**
+ * Free all entries.
+ * @param cache Cache to shutdown
+ */
+void tui_wrap_cache_shutdown(tui_wrap_cache *cache);
+
+/**
+ * Drop all entries between requests (counters are kept).
+ * @param cache Cache to reset
+ */
+void tui_wrap_cache_reset(tui_wrap_cache *cache);
+
+/**
+ * Lines of a run wrapped at width, as tui_wrap_iter_next() yields them.
+ * Wraps and stores the result on a miss.
+ *
+ * The spans are shared and read-only, and stay valid until the next
+ * call on this cache.
+ *
+ * @param cache Cache
+ * @param text  The run's text (run->bytes bytes)
+ * @param run   Run to wrap
+ * @param width Maximum display width per line (>= 1)
+ * @param mode  TUI_WRAP_CHAR, TUI_WRAP_WORD or TUI_WRAP_WORD_CHAR
+ * @param count Receives the number of lines
+ * @return Spans, or NULL when the result is too long to cache or on
+ *         allocation failure (wrap with tui_wrap_iter instead)
+ */
+const tui_line_span* tui_wrap_cache_get(tui_wrap_cache *cache, const char *text,
+                                        const tui_text_run *run, int width,
+                                        tui_wrap_mode mode, int *count);
+
+#endif /* TUI_WRAPCACHE_H */
@@ -6,6 +6,7 @@
 
 #include "buffer.h"
 #include "../text/measure.h"
+#include "../text/grapheme.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -35,6 +36,592 @@ int tui_buffer_get_max_height(void)
     return g_max_buffer_height;
 }
 
+/* Extend a row's dirty span; caller guarantees y and columns are in bounds */
+static inline void row_touch(tui_buffer *buf, int y, int x0, int x1)
+{
+    tui_row_info *row = &buf->rows[y];
+    if (x0 < row->min_x) row->min_x = x0;
+    if (x1 > row->max_x) row->max_x = x1;
+    row->hash_valid = 0;
+}
+
+/* Blank cell: space in the default style */
+static const tui_cell blank_cell = { ' ', 0, 0 };
+
+/* Fill a cell run with one value; compiles to wide stores */
+static inline void cells_fill(tui_cell *cells, size_t count, tui_cell value)
+{
+    for (size_t i = 0; i < count; i++) {
+        cells[i] = value;
+    }
+}
+
+static void rows_mark_all(tui_row_info *rows, int width, int height, int dirty)
+{
+    for (int y = 0; y < height; y++) {
+        rows[y].min_x = dirty ? 0 : width;
+        rows[y].max_x = dirty ? width - 1 : -1;
+        rows[y].hash_valid = 0;
+    }
+}
+
+/* ----------------------------------------------------------------
+ * Style table
+ * ---------------------------------------------------------------- */
+
+#define STYLE_TABLE_INITIAL 64
+
+/*
+ * Pack a style into 56 bits: fg (25) | bg (25) | attributes (6).
+ * RGB of an unset color is ignored, so equal-looking styles share a key.
+ */
+static inline uint64_t color_key(const tui_color *c)
+{
+    return c->is_set ? ((uint64_t)1 << 24 | (uint64_t)c->r << 16 | (uint64_t)c->g << 8 | c->b) : 0;
+}
+
+static inline uint64_t style_key(const tui_style *st)
+{
+    return color_key(&st->fg) |
+           color_key(&st->bg) << 25 |
+           (uint64_t)(st->bold != 0) << 50 |
+           (uint64_t)(st->dim != 0) << 51 |
+           (uint64_t)(st->italic != 0) << 52 |
+           (uint64_t)(st->underline != 0) << 53 |
+           (uint64_t)(st->inverse != 0) << 54 |
+           (uint64_t)(st->strikethrough != 0) << 55;
+}
+
+static inline void key_to_color(uint64_t k, tui_color *c)
+{
+    c->is_set = (uint8_t)((k >> 24) & 1);
+    c->r = (uint8_t)(k >> 16);
+    c->g = (uint8_t)(k >> 8);
+    c->b = (uint8_t)k;
+}
+
+static void key_to_style(uint64_t k, tui_style *st)
+{
+    key_to_color(k & 0x1FFFFFF, &st->fg);
+    key_to_color((k >> 25) & 0x1FFFFFF, &st->bg);
+    st->bold = (uint8_t)((k >> 50) & 1);
+    st->dim = (uint8_t)((k >> 51) & 1);
+    st->italic = (uint8_t)((k >> 52) & 1);
+    st->underline = (uint8_t)((k >> 53) & 1);
+    st->inverse = (uint8_t)((k >> 54) & 1);
+    st->strikethrough = (uint8_t)((k >> 55) & 1);
+}
+
+static inline int key_slot(uint64_t key, int mask)
+{
+    key *= 0x9E3779B97F4A7C15ULL;
+    return (int)(key >> 40) & mask;
+}
+
+static tui_style_table* style_table_create(void)
+{
+    tui_style_table *t = calloc(1, sizeof(tui_style_table));
+    if (!t) return NULL;
+
+    t->capacity = STYLE_TABLE_INITIAL;
+    t->slot_mask = STYLE_TABLE_INITIAL * 2 - 1;
+    t->styles = calloc((size_t)t->capacity, sizeof(tui_style));
+    t->keys = calloc((size_t)t->capacity, sizeof(uint64_t));
+    t->slots = calloc((size_t)t->slot_mask + 1, sizeof(uint16_t));
+    if (!t->styles || !t->keys || !t->slots) {
+        free(t->styles);
+        free(t->keys);
+        free(t->slots);
+        free(t);
+        return NULL;
+    }
+
+    /* Id 0: default style (all zero), indexed like any other entry */
+    t->count = 1;
+    t->slots[key_slot(0, t->slot_mask)] = 1;
+    t->refcount = 1;
+    return t;
+}
+
+static void cluster_arena_free(tui_cluster_arena *a);
+static void link_table_free(tui_link_table *l);
+
+static void style_table_release(tui_style_table *t)
+{
+    if (t && --t->refcount <= 0) {
+        free(t->styles);
+        free(t->keys);
+        free(t->slots);
+        cluster_arena_free(&t->clusters);
+        link_table_free(&t->links);
+        free(t);
+    }
+}
+
+static int style_table_grow(tui_style_table *t)
+{
+    int new_capacity = t->capacity * 2;
+    if (new_capacity > TUI_STYLE_TABLE_MAX) new_capacity = TUI_STYLE_TABLE_MAX;
+    if (new_capacity <= t->capacity) return -1;
+
+    tui_style *styles = realloc(t->styles, (size_t)new_capacity * sizeof(tui_style));
+    if (!styles) return -1;
+    t->styles = styles;
+
+    uint64_t *keys = realloc(t->keys, (size_t)new_capacity * sizeof(uint64_t));
+    if (!keys) return -1;
+    t->keys = keys;
+
+    /* Keep the index at most half full */
+    int slot_count = t->slot_mask + 1;
+    while (slot_count < new_capacity * 2) slot_count *= 2;
+    if (slot_count != t->slot_mask + 1) {
+        uint16_t *slots = calloc((size_t)slot_count, sizeof(uint16_t));
+        if (!slots) return -1;
+        int mask = slot_count - 1;
+        for (int id = 0; id < t->count; id++) {
+            int i = key_slot(t->keys[id], mask);
+            while (slots[i]) i = (i + 1) & mask;
+            slots[i] = (uint16_t)(id + 1);
+        }
+        free(t->slots);
+        t->slots = slots;
+        t->slot_mask = mask;
+    }
+
+    t->capacity = new_capacity;
+    return 0;
+}
+
+/* Returns the id for key, or -1 if the table is full */
+static int style_table_intern(tui_style_table *t, uint64_t key)
+{
+    if (key == t->last_key) return t->last_id;
+
+    int i = key_slot(key, t->slot_mask);
+    while (t->slots[i]) {
+        int id = t->slots[i] - 1;
+        if (t->keys[id] == key) {
+            t->last_key = key;
+            t->last_id = (uint16_t)id;
+            return id;
+        }
+        i = (i + 1) & t->slot_mask;
+    }
+
+    if (t->count >= t->capacity) {
+        if (style_table_grow(t) != 0) return -1;
+        /* Index may have been rebuilt */
+        i = key_slot(key, t->slot_mask);
+        while (t->slots[i]) i = (i + 1) & t->slot_mask;
+    }
+
+    int id = t->count++;
+    t->keys[id] = key;
+    key_to_style(key, &t->styles[id]);
+    t->slots[i] = (uint16_t)(id + 1);
+    t->last_key = key;
+    t->last_id = (uint16_t)id;
+    return id;
+}
+
+/* ----------------------------------------------------------------
+ * Cluster arena
+ * ---------------------------------------------------------------- */
+
+#define CLUSTER_ARENA_INITIAL_IDS 32
+#define CLUSTER_ARENA_INITIAL_BYTES 512
+
+/* FNV-1a over the cluster's bytes */
+static inline uint32_t cluster_hash(const char *bytes, size_t len)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint8_t)bytes[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void cluster_arena_free(tui_cluster_arena *a)
+{
+    free(a->bytes);
+    free(a->offsets);
+    free(a->lengths);
+    free(a->widths);
+    free(a->slots);
+    memset(a, 0, sizeof(*a));
+}
+
+static int cluster_arena_grow_ids(tui_cluster_arena *a)
+{
+    int new_capacity = a->id_capacity ? a->id_capacity * 2 : CLUSTER_ARENA_INITIAL_IDS;
+    if (new_capacity > TUI_CLUSTER_TABLE_MAX) new_capacity = TUI_CLUSTER_TABLE_MAX;
+    if (new_capacity <= a->id_capacity) return -1;
+
+    uint32_t *offsets = realloc(a->offsets, (size_t)new_capacity * sizeof(uint32_t));
+    if (!offsets) return -1;
+    a->offsets = offsets;
+
+    uint8_t *lengths = realloc(a->lengths, (size_t)new_capacity);
+    if (!lengths) return -1;
+    a->lengths = lengths;
+
+    uint8_t *widths = realloc(a->widths, (size_t)new_capacity);
+    if (!widths) return -1;
+    a->widths = widths;
+
+    /* Keep the index at most half full */
+    int slot_count = new_capacity * 2;
+    uint32_t *slots = calloc((size_t)slot_count, sizeof(uint32_t));
+    if (!slots) return -1;
+    int mask = slot_count - 1;
+    for (int id = 0; id < a->count; id++) {
+        int i = (int)(cluster_hash(a->bytes + a->offsets[id], a->lengths[id]) & (uint32_t)mask);
+        while (slots[i]) i = (i + 1) & mask;
+        slots[i] = (uint32_t)id + 1;
+    }
+    free(a->slots);
+    a->slots = slots;
+    a->slot_mask = mask;
+
+    a->id_capacity = new_capacity;
+    return 0;
+}
+
+/* Returns the id for the cluster, or -1 if it can't be stored */
+static int cluster_arena_intern(tui_cluster_arena *a, const char *bytes, size_t len, int width)
+{
+    if (len == 0 || len > TUI_CLUSTER_MAX_BYTES) return -1;
+
+    uint32_t h = cluster_hash(bytes, len);
+    if (a->slots) {
+        int i = (int)(h & (uint32_t)a->slot_mask);
+        while (a->slots[i]) {
+            int id = (int)a->slots[i] - 1;
+            if (a->lengths[id] == len && memcmp(a->bytes + a->offsets[id], bytes, len) == 0) {
+                return id;
+            }
+            i = (i + 1) & a->slot_mask;
+        }
+    }
+
+    if (a->count >= a->id_capacity && cluster_arena_grow_ids(a) != 0) return -1;
+
+    if (a->len + len > a->capacity) {
+        size_t new_capacity = a->capacity ? a->capacity * 2 : CLUSTER_ARENA_INITIAL_BYTES;
+        while (new_capacity < a->len + len) new_capacity *= 2;
+        if (new_capacity > UINT32_MAX) return -1;
+        char *grown = realloc(a->bytes, new_capacity);
+        if (!grown) return -1;
+        a->bytes = grown;
+        a->capacity = new_capacity;
+    }
+
+    int id = a->count++;
+    a->offsets[id] = (uint32_t)a->len;
+    a->lengths[id] = (uint8_t)len;
+    a->widths[id] = (uint8_t)(width > 1 ? 2 : 1);
+    memcpy(a->bytes + a->len, bytes, len);
+    a->len += len;
+
+    int i = (int)(h & (uint32_t)a->slot_mask);
+    while (a->slots[i]) i = (i + 1) & a->slot_mask;
+    a->slots[i] = (uint32_t)id + 1;
+    return id;
+}
+
+/* ----------------------------------------------------------------
+ * Link table
+ * ---------------------------------------------------------------- */
+
+#define LINK_TABLE_INITIAL 16
+
+static inline uint32_t link_hash(const char *url, const char *id)
+{
+    uint32_t h = cluster_hash(url, strlen(url));
+    if (id) {
+        h ^= 0xFF;
+        h *= 16777619u;
+        h ^= cluster_hash(id, strlen(id));
+    }
+    return h;
+}
+
+static inline int link_matches(const tui_link_table *l, int link, const char *url, const char *id)
+{
+    const char *have = l->ids[link];
+    return strcmp(l->urls[link], url) == 0 &&
+           (have == id || (have && id && strcmp(have, id) == 0));
+}
+
+static void link_table_free(tui_link_table *l)
+{
+    for (int i = 1; i <= l->count; i++) {
+        free(l->urls[i]);
+        free(l->ids[i]);
+    }
+    free(l->urls);
+    free(l->ids);
+    free(l->slots);
+    memset(l, 0, sizeof(*l));
+}
+
+static int link_table_grow(tui_link_table *l)
+{
+    int new_capacity = l->capacity ? l->capacity * 2 : LINK_TABLE_INITIAL;
+    if (new_capacity > TUI_LINK_TABLE_MAX + 1) new_capacity = TUI_LINK_TABLE_MAX + 1;
+    if (new_capacity <= l->capacity) return -1;
+
+    char **urls = realloc(l->urls, (size_t)new_capacity * sizeof(char *));
+    if (!urls) return -1;
+    l->urls = urls;
+
+    char **ids = realloc(l->ids, (size_t)new_capacity * sizeof(char *));
+    if (!ids) return -1;
+    l->ids = ids;
+
+    /* Keep the index at most half full */
+    int slot_count = 1;
+    while (slot_count < new_capacity * 2) slot_count <<= 1;
+    uint16_t *slots = calloc((size_t)slot_count, sizeof(uint16_t));
+    if (!slots) return -1;
+    int mask = slot_count - 1;
+    for (int link = 1; link <= l->count; link++) {
+        int i = (int)(link_hash(l->urls[link], l->ids[link]) & (uint32_t)mask);
+        while (slots[i]) i = (i + 1) & mask;
+        slots[i] = (uint16_t)link;
+    }
+    free(l->slots);
+    l->slots = slots;
+    l->slot_mask = mask;
+
+    l->capacity = new_capacity;
+    return 0;
+}
+
+/* Returns the link id, or 0 if it can't be stored */
+static uint16_t link_table_intern(tui_link_table *l, const char *url, const char *id)
+{
+    if (!url || !url[0]) return 0;
+    if (id && !id[0]) id = NULL;
+
+    uint32_t h = link_hash(url, id);
+    if (l->slots) {
+        int i = (int)(h & (uint32_t)l->slot_mask);
+        while (l->slots[i]) {
+            if (link_matches(l, l->slots[i], url, id)) return l->slots[i];
+            i = (i + 1) & l->slot_mask;
+        }
+    }
+
+    if (l->count + 1 >= l->capacity && link_table_grow(l) != 0) return 0;
+
+    char *url_copy = strdup(url);
+    char *id_copy = id ? strdup(id) : NULL;
+    if (!url_copy || (id && !id_copy)) {
+        free(url_copy);
+        free(id_copy);
+        return 0;
+    }
+
+    int link = ++l->count;
+    l->urls[link] = url_copy;
+    l->ids[link] = id_copy;
+
+    int i = (int)(h & (uint32_t)l->slot_mask);
+    while (l->slots[i]) i = (i + 1) & l->slot_mask;
+    l->slots[i] = (uint16_t)link;
+    return (uint16_t)link;
+}
+
+/* Move a link id of table `from` to table `to`; sets *lost if `to` can't
+ * take it */
+static uint16_t link_remap(tui_style_table *to, const tui_style_table *from,
+                           uint16_t link, int *lost)
+{
+    if (link == 0) return 0;
+
+    const tui_link_table *l = &from->links;
+    uint16_t new_link = link_table_intern(&to->links, l->urls[link], l->ids[link]);
+    if (new_link == 0) *lost = 1;
+    return new_link;
+}
+
+/* Move a cluster cell of table `from` to table `to`. Returns the new cell
+ * codepoint, or the cluster's first codepoint (and sets *lost) if `to`
+ * can't take it. */
+static uint32_t cluster_remap(tui_style_table *to, const tui_style_table *from,
+                              uint32_t codepoint, int *lost)
+{
+    const tui_cluster_arena *a = &from->clusters;
+    uint32_t id = codepoint & ~TUI_CELL_CLUSTER;
+    const char *bytes = a->bytes + a->offsets[id];
+
+    int new_id = cluster_arena_intern(&to->clusters, bytes, a->lengths[id], a->widths[id]);
+    if (new_id >= 0) return TUI_CELL_CLUSTER | (uint32_t)new_id;
+
+    uint32_t first = ' ';
+    tui_utf8_decode_n(bytes, a->lengths[id], &first);
+    *lost = 1;
+    return first;
+}
+
+/*
+ * Rebuild the buffer's table from the styles, clusters and links its
+ * cells still use. Other buffers keep the old table until they re-share (see
+ * output.c).
+ */
+static int buffer_compact_table(tui_buffer *buf)
+{
+    tui_style_table *old = buf->styles;
+    tui_style_table *t = style_table_create();
+    if (!t) return -1;
+
+    size_t count = (size_t)buf->width * (size_t)buf->height;
+    for (size_t i = 0; i < count; i++) {
+        tui_cell *cell = &buf->cells[i];
+        int id = style_table_intern(t, old->keys[cell->style]);
+        cell->style = (uint16_t)(id < 0 ? 0 : id);
+        int lost = 0;
+        if (tui_cell_is_cluster(cell)) {
+            cell->codepoint = cluster_remap(t, old, cell->codepoint, &lost);
+        }
+        cell->link = link_remap(t, old, cell->link, &lost);
+    }
+
+    /* Cells about to be written keep their link */
+    int lost = 0;
+    buf->link = link_remap(t, old, buf->link, &lost);
+
+    /* Compacting again right away would free little; wait for the next frame */
+    t->compacted = t->count > TUI_STYLE_TABLE_MAX / 4 * 3 ||
+                   t->clusters.count > TUI_CLUSTER_TABLE_MAX / 4 * 3 ||
+                   t->links.count > TUI_LINK_TABLE_MAX / 4 * 3;
+    buf->styles = t;
+    style_table_release(old);
+    rows_mark_all(buf->rows, buf->width, buf->height, 1);
+    return 0;
+}
+
+uint16_t tui_buffer_intern_style(tui_buffer *buf, const tui_style *style)
+{
+    if (!buf || !style) return 0;
+
+    uint64_t key = style_key(style);
+    int id = style_table_intern(buf->styles, key);
+    if (id < 0 && !buf->styles->compacted && buffer_compact_table(buf) == 0) {
+        id = style_table_intern(buf->styles, key);
+    }
+    return (uint16_t)(id < 0 ? 0 : id);
+}
+
+uint32_t tui_buffer_intern_cluster(tui_buffer *buf, const char *bytes, size_t len, int width)
+{
+    uint32_t first = ' ';
+    if (!buf || !bytes || len == 0) return first;
+
+    int id = cluster_arena_intern(&buf->styles->clusters, bytes, len, width);
+    if (id < 0 && len <= TUI_CLUSTER_MAX_BYTES && !buf->styles->compacted &&
+        buffer_compact_table(buf) == 0) {
+        id = cluster_arena_intern(&buf->styles->clusters, bytes, len, width);
+    }
+    if (id >= 0) return TUI_CELL_CLUSTER | (uint32_t)id;
+
+    tui_utf8_decode_n(bytes, (int)len, &first);
+    return first;
+}
+
+uint16_t tui_buffer_intern_link(tui_buffer *buf, const char *url, const char *id)
+{
+    if (!buf || !url || !url[0]) return 0;
+
+    uint16_t link = link_table_intern(&buf->styles->links, url, id);
+    if (link == 0 && !buf->styles->compacted && buffer_compact_table(buf) == 0) {
+        link = link_table_intern(&buf->styles->links, url, id);
+    }
+    return link;
+}
+
+void tui_buffer_share_styles(tui_buffer *dst, tui_buffer *src)
+{
+    if (!dst || !src || dst->styles == src->styles) return;
+
+    tui_style_table *old = dst->styles;
+    tui_style_table *t = src->styles;
+
+    for (int y = 0; y < dst->height; y++) {
+        tui_cell *row = &dst->cells[(size_t)y * (size_t)dst->width];
+        for (int x = 0; x < dst->width; x++) {
+            int lost = 0;
+            int id = style_table_intern(t, old->keys[row[x].style]);
+            if (id < 0) {
+                id = 0;
+                lost = 1;
+            }
+            row[x].style = (uint16_t)id;
+            if (tui_cell_is_cluster(&row[x])) {
+                row[x].codepoint = cluster_remap(t, old, row[x].codepoint, &lost);
+            }
+            row[x].link = link_remap(t, old, row[x].link, &lost);
+            if (lost) {
+                /* Table full: cell content is now unknown, force a redraw */
+                row_touch(dst, y, x, x);
+            }
+        }
+        dst->rows[y].hash_valid = 0;
+    }
+
+    int lost = 0;
+    dst->link = link_remap(t, old, dst->link, &lost);
+
+    t->refcount++;
+    dst->styles = t;
+    style_table_release(old);
+}
+
+void tui_buffer_composite(tui_buffer *dst, const tui_buffer *src, tui_rect r)
+{
+    if (!dst || !src || dst->width != src->width || dst->height != src->height) return;
+
+    int x0 = r.x < 0 ? 0 : r.x;
+    int y0 = r.y < 0 ? 0 : r.y;
+    int x1 = r.x + r.w > dst->width ? dst->width : r.x + r.w;
+    int y1 = r.y + r.h > dst->height ? dst->height : r.y + r.h;
+
+    for (int y = y0; y < y1; y++) {
+        const tui_cell *from = &src->cells[(size_t)y * (size_t)src->width];
+        tui_cell *to = &dst->cells[(size_t)y * (size_t)dst->width];
+        int first = -1, last = -1;
+
+        /* Never split a wide character of src at the edges */
+        int start = x0 > 0 && from[x0].codepoint == 0 ? x0 - 1 : x0;
+        int end = x1 < src->width && from[x1].codepoint == 0 ? x1 + 1 : x1;
+
+        for (int x = start; x < end; x++) {
+            if (from[x].codepoint == TUI_CELL_TRANSPARENT) continue;
+
+            /* Overwriting half of a wide character underneath */
+            if (to[x].codepoint == 0 && x > 0 && from[x].codepoint != 0 &&
+                (x == start || from[x - 1].codepoint == TUI_CELL_TRANSPARENT)) {
+                to[x - 1].codepoint = ' ';
+                if (first < 0 || x - 1 < first) first = x - 1;
+            }
+            if (x + 1 < dst->width && to[x + 1].codepoint == 0 &&
+                (x + 1 >= end || from[x + 1].codepoint == TUI_CELL_TRANSPARENT)) {
+                to[x + 1].codepoint = ' ';
+                last = x + 1;
+            }
+
+            to[x] = from[x];
+            if (first < 0) first = x;
+            if (x > last) last = x;
+        }
+
+        if (first >= 0) row_touch(dst, y, first, last);
+    }
+}
+
 tui_buffer* tui_buffer_create(int width, int height)
 {
     /* Validate dimensions against configurable limits */
@@ -50,18 +637,22 @@ tui_buffer* tui_buffer_create(int width, int height)
 
     buf->width = width;
     buf->height = height;
-    buf->cells = calloc(cell_count, sizeof(tui_cell));
+    buf->cells = malloc(cell_count * sizeof(tui_cell));
+    buf->rows = calloc((size_t)height, sizeof(tui_row_info));
+    buf->styles = style_table_create();
 
-    if (!buf->cells) {
+    if (!buf->cells || !buf->rows || !buf->styles) {
+        free(buf->cells);
+        free(buf->rows);
+        style_table_release(buf->styles);
         free(buf);
         return NULL;
     }
 
     /* Initialize with spaces */
-    for (size_t i = 0; i < cell_count; i++) {
-        buf->cells[i].codepoint = ' ';
-        buf->cells[i].dirty = 1;
-    }
+    cells_fill(buf->cells, cell_count, blank_cell);
+    rows_mark_all(buf->rows, width, height, 1);
+    tui_buffer_reset_clip(buf);
 
     return buf;
 }
@@ -70,6 +661,8 @@ void tui_buffer_destroy(tui_buffer *buf)
 {
     if (buf) {
         free(buf->cells);
+        free(buf->rows);
+        style_table_release(buf->styles);
         free(buf);
     }
 }
@@ -84,29 +677,36 @@ int tui_buffer_resize(tui_buffer *buf, int width, int height)
     size_t cell_count = (size_t)width * (size_t)height;
     if (cell_count > SIZE_MAX / sizeof(tui_cell)) return -1;
 
-    tui_cell *new_cells = calloc(cell_count, sizeof(tui_cell));
+    tui_cell *new_cells = malloc(cell_count * sizeof(tui_cell));
     if (!new_cells) return -1;  /* Keep buffer unchanged on failure */
 
-    /* Initialize with spaces */
-    for (size_t i = 0; i < cell_count; i++) {
-        new_cells[i].codepoint = ' ';
-        new_cells[i].dirty = 1;
+    tui_row_info *new_rows = calloc((size_t)height, sizeof(tui_row_info));
+    if (!new_rows) {
+        free(new_cells);
+        return -1;
     }
+    rows_mark_all(new_rows, width, height, 1);
+
+    /* Initialize with spaces */
+    cells_fill(new_cells, cell_count, blank_cell);
 
     /* Copy old content (what fits) */
     int copy_width = buf->width < width ? buf->width : width;
     int copy_height = buf->height < height ? buf->height : height;
 
     for (int y = 0; y < copy_height; y++) {
-        for (int x = 0; x < copy_width; x++) {
-            new_cells[y * width + x] = buf->cells[y * buf->width + x];
-        }
+        memcpy(&new_cells[(size_t)y * (size_t)width],
+               &buf->cells[(size_t)y * (size_t)buf->width],
+               (size_t)copy_width * sizeof(tui_cell));
     }
 
     free(buf->cells);
+    free(buf->rows);
     buf->cells = new_cells;
+    buf->rows = new_rows;
     buf->width = width;
     buf->height = height;
+    tui_buffer_reset_clip(buf);
     return 0;
 }
 
@@ -114,25 +714,94 @@ void tui_buffer_clear(tui_buffer *buf)
 {
     if (!buf) return;
 
-    for (int i = 0; i < buf->width * buf->height; i++) {
-        buf->cells[i].codepoint = ' ';
-        memset(&buf->cells[i].style, 0, sizeof(tui_style));
-        buf->cells[i].dirty = 1;
+    cells_fill(buf->cells, (size_t)buf->width * (size_t)buf->height, blank_cell);
+
+    /* Every cell is id 0 now: start over if the palette has filled up */
+    if (buf->styles->count > TUI_STYLE_TABLE_MAX / 2 ||
+        buf->styles->clusters.count > TUI_CLUSTER_TABLE_MAX / 2 ||
+        buf->styles->links.count > TUI_LINK_TABLE_MAX / 2) {
+        tui_style_table *t = style_table_create();
+        if (t) {
+            style_table_release(buf->styles);
+            buf->styles = t;
+        }
     }
+    rows_mark_all(buf->rows, buf->width, buf->height, 1);
+}
+
+/* ----------------------------------------------------------------
+ * Clipping
+ * ---------------------------------------------------------------- */
+
+static tui_rect rect_intersect(tui_rect a, tui_rect b)
+{
+    int x0 = a.x > b.x ? a.x : b.x;
+    int y0 = a.y > b.y ? a.y : b.y;
+    int x1 = a.x + a.w < b.x + b.w ? a.x + a.w : b.x + b.w;
+    int y1 = a.y + a.h < b.y + b.h ? a.y + a.h : b.y + b.h;
+
+    tui_rect r = { x0, y0, x1 > x0 ? x1 - x0 : 0, y1 > y0 ? y1 - y0 : 0 };
+    return r;
+}
+
+tui_rect tui_buffer_push_clip(tui_buffer *buf, tui_rect rect)
+{
+    tui_rect prev = buf->clip;
+    buf->clip = rect_intersect(buf->clip, rect);
+    return prev;
+}
+
+void tui_buffer_set_clip(tui_buffer *buf, tui_rect rect)
+{
+    tui_rect bounds = { 0, 0, buf->width, buf->height };
+    buf->clip = rect_intersect(bounds, rect);
+}
+
+void tui_buffer_reset_clip(tui_buffer *buf)
+{
+    buf->clip.x = 0;
+    buf->clip.y = 0;
+    buf->clip.w = buf->width;
+    buf->clip.h = buf->height;
+}
+
+/* Record a wide character at x, x + 1 that the clip rect cut in half */
+static void clip_cut(tui_buffer *buf, int x, int y)
+{
+    if (y < buf->clip.y || y >= buf->clip.y + buf->clip.h) return;
+
+    tui_rect r = { x, y, 2, 1 };
+    if (buf->cut.w > 0) {
+        int x1 = buf->cut.x + buf->cut.w > x + 2 ? buf->cut.x + buf->cut.w : x + 2;
+        int y1 = buf->cut.y + buf->cut.h > y + 1 ? buf->cut.y + buf->cut.h : y + 1;
+        r.x = buf->cut.x < x ? buf->cut.x : x;
+        r.y = buf->cut.y < y ? buf->cut.y : y;
+        r.w = x1 - r.x;
+        r.h = y1 - r.y;
+    }
+    buf->cut = r;
+}
+
+/* Clip rect is kept inside the buffer, so it is the only bounds check */
+static inline int clip_contains(const tui_buffer *buf, int x, int y)
+{
+    return x >= buf->clip.x && x < buf->clip.x + buf->clip.w &&
+           y >= buf->clip.y && y < buf->clip.y + buf->clip.h;
 }
 
 void tui_buffer_set_cell(tui_buffer *buf, int x, int y, uint32_t ch, const tui_style *style)
 {
-    if (!buf || x < 0 || x >= buf->width || y < 0 || y >= buf->height) {
+    if (!buf || !clip_contains(buf, x, y)) {
         return;
     }
 
     tui_cell *cell = &buf->cells[y * buf->width + x];
     cell->codepoint = ch;
     if (style) {
-        cell->style = *style;
+        cell->style = tui_buffer_intern_style(buf, style);
     }
-    cell->dirty = 1;
+    cell->link = buf->link;
+    row_touch(buf, y, x, x);
 }
 
 /**
@@ -150,16 +819,47 @@ void tui_buffer_set_cell(tui_buffer *buf, int x, int y, uint32_t ch, const tui_s
  * @param style Style to apply (may be NULL for default)
  */
 void tui_buffer_write_text(tui_buffer *buf, int x, int y, const char *text, const tui_style *style)
+{
+    if (!buf || !text) return;
+    tui_buffer_write_text_n(buf, x, y, text, strlen(text), style);
+}
+
+void tui_buffer_write_text_n(tui_buffer *buf, int x, int y, const char *text, size_t len,
+                             const tui_style *style)
 {
     if (!buf || !text) return;
 
     const char *p = text;
+    const char *text_end = text + len;
     int cx = x;
     int cy = y;
+    int clip_right = buf->clip.x + buf->clip.w;
+    int clip_bottom = buf->clip.y + buf->clip.h;
 
-    while (*p && cy < buf->height) {
+    while (p < text_end && *p && cy < clip_bottom) {
         uint32_t codepoint;
-        int bytes = tui_utf8_decode(p, &codepoint);
+        int bytes;
+        int cluster = 0;
+
+        if ((unsigned char)p[0] < 0x80 &&
+            (p + 1 == text_end || (unsigned char)p[1] < 0x80)) {
+            /* ASCII followed by ASCII never forms a cluster */
+            codepoint = (unsigned char)p[0];
+            bytes = 1;
+        } else {
+            bytes = tui_utf8_decode_n(p, (int)(text_end - p), &codepoint);
+
+            /* Keep a multi-codepoint grapheme cluster in one cell */
+            tui_grapheme_iter it;
+            const char *start;
+            size_t cluster_len = 0;
+            tui_grapheme_iter_init(&it, p, (size_t)(text_end - p));
+            if (tui_grapheme_iter_next(&it, &start, &cluster_len) &&
+                cluster_len > (size_t)bytes && codepoint != '\r') {
+                bytes = (int)cluster_len;
+                cluster = 1;
+            }
+        }
 
         /* Handle newlines: advance to next row, reset x */
         if (codepoint == '\n') {
@@ -170,21 +870,40 @@ void tui_buffer_write_text(tui_buffer *buf, int x, int y, const char *text, cons
         }
 
         /* Skip if past right edge */
-        if (cx >= buf->width) {
+        if (cx >= clip_right) {
             p += bytes;
             continue;
         }
 
-        int char_width = tui_char_width(codepoint);
+        int char_width;
+        if (cluster) {
+            char_width = tui_grapheme_width(p, (size_t)bytes);
+            if (char_width > 2) char_width = 2;
+            if (char_width > 0) {
+                codepoint = tui_buffer_intern_cluster(buf, p, (size_t)bytes, char_width);
+            }
+        } else {
+            char_width = tui_char_width(codepoint);
+        }
 
         if (char_width > 0) {
-            /* Set the main cell */
-            tui_buffer_set_cell(buf, cx, cy, codepoint, style);
+            /* A wide character cut by the clip rect can't be drawn by
+             * half: the visible half is shown as a blank */
+            if (char_width == 2 && cx + 1 == clip_right && clip_right < buf->width) {
+                tui_buffer_set_cell(buf, cx, cy, ' ', style);
+                clip_cut(buf, cx, cy);
+            } else if (char_width == 2 && cx + 1 == buf->clip.x) {
+                tui_buffer_set_cell(buf, cx + 1, cy, ' ', style);
+                clip_cut(buf, cx, cy);
+            } else {
+                /* Set the main cell */
+                tui_buffer_set_cell(buf, cx, cy, codepoint, style);
 
-            /* For wide characters (CJK, emoji), mark the next cell as a continuation
-             * Use NULL style so it doesn't inherit colors that could bleed */
-            if (char_width == 2 && cx + 1 < buf->width) {
-                tui_buffer_set_cell(buf, cx + 1, cy, 0, NULL);  /* 0 = continuation, no style */
+                /* For wide characters (CJK, emoji), mark the next cell as a continuation
+                 * Use NULL style so it doesn't inherit colors that could bleed */
+                if (char_width == 2 && cx + 1 < clip_right) {
+                    tui_buffer_set_cell(buf, cx + 1, cy, 0, NULL);  /* 0 = continuation, no style */
+                }
             }
 
             cx += char_width;
@@ -198,13 +917,66 @@ void tui_buffer_fill_rect(tui_buffer *buf, int x, int y, int w, int h, uint32_t
 {
     if (!buf) return;
 
-    for (int dy = 0; dy < h; dy++) {
-        for (int dx = 0; dx < w; dx++) {
-            tui_buffer_set_cell(buf, x + dx, y + dy, ch, style);
+    /* Clip once instead of per cell */
+    int x0 = x < buf->clip.x ? buf->clip.x : x;
+    int y0 = y < buf->clip.y ? buf->clip.y : y;
+    int x1 = x + w > buf->clip.x + buf->clip.w ? buf->clip.x + buf->clip.w : x + w;
+    int y1 = y + h > buf->clip.y + buf->clip.h ? buf->clip.y + buf->clip.h : y + h;
+    if (x0 >= x1 || y0 >= y1) return;
+
+    size_t run = (size_t)(x1 - x0);
+
+    if (style) {
+        uint16_t id = tui_buffer_intern_style(buf, style);
+        tui_cell value = { ch, id, buf->link };
+        for (int row = y0; row < y1; row++) {
+            cells_fill(&buf->cells[(size_t)row * (size_t)buf->width + (size_t)x0], run, value);
+            row_touch(buf, row, x0, x1 - 1);
         }
+    } else {
+        /* NULL style keeps each cell's existing style */
+        for (int row = y0; row < y1; row++) {
+            tui_cell *cell = &buf->cells[(size_t)row * (size_t)buf->width + (size_t)x0];
+            for (size_t i = 0; i < run; i++) {
+                cell[i].codepoint = ch;
+            }
+            row_touch(buf, row, x0, x1 - 1);
+        }
+    }
+}
+
+void tui_buffer_clear_rect(tui_buffer *buf, int x, int y, int w, int h)
+{
+    if (!buf) return;
+
+    int x0 = x < buf->clip.x ? buf->clip.x : x;
+    int y0 = y < buf->clip.y ? buf->clip.y : y;
+    int x1 = x + w > buf->clip.x + buf->clip.w ? buf->clip.x + buf->clip.w : x + w;
+    int y1 = y + h > buf->clip.y + buf->clip.h ? buf->clip.y + buf->clip.h : y + h;
+    if (x0 >= x1 || y0 >= y1) return;
+
+    for (int row = y0; row < y1; row++) {
+        cells_fill(&buf->cells[(size_t)row * (size_t)buf->width + (size_t)x0], (size_t)(x1 - x0), blank_cell);
+        row_touch(buf, row, x0, x1 - 1);
     }
 }
 
+tui_rect tui_buffer_align_rect(const tui_buffer *buf, tui_rect r)
+{
+    if (!buf || r.w <= 0 || r.h <= 0) return r;
+
+    int grow_left = 0, grow_right = 0;
+    for (int row = r.y; row < r.y + r.h; row++) {
+        const tui_cell *cells = &buf->cells[(size_t)row * (size_t)buf->width];
+        if (r.x > 0 && cells[r.x].codepoint == 0) grow_left = 1;
+        if (r.x + r.w < buf->width && cells[r.x + r.w].codepoint == 0) grow_right = 1;
+    }
+
+    r.x -= grow_left;
+    r.w += grow_left + grow_right;
+    return r;
+}
+
 tui_cell* tui_buffer_get_cell(tui_buffer *buf, int x, int y)
 {
     if (!buf || x < 0 || x >= buf->width || y < 0 || y >= buf->height) {
@@ -217,133 +989,59 @@ void tui_buffer_mark_all_dirty(tui_buffer *buf)
 {
     if (!buf) return;
 
-    for (int i = 0; i < buf->width * buf->height; i++) {
-        buf->cells[i].dirty = 1;
-    }
+    rows_mark_all(buf->rows, buf->width, buf->height, 1);
 }
 
 void tui_buffer_mark_clean(tui_buffer *buf)
 {
     if (!buf) return;
 
-    for (int i = 0; i < buf->width * buf->height; i++) {
-        buf->cells[i].dirty = 0;
+    buf->styles->compacted = 0;
+
+    for (int y = 0; y < buf->height; y++) {
+        buf->rows[y].min_x = buf->width;
+        buf->rows[y].max_x = -1;
     }
 }
 
-char* tui_buffer_to_string(tui_buffer *buf)
+void tui_buffer_mark_row_dirty(tui_buffer *buf, int y, int x0, int x1)
 {
-    if (!buf || !buf->cells) return NULL;
+    if (!buf || y < 0 || y >= buf->height) return;
 
-    /* Estimate output size: each cell could be up to ~60 bytes with full ANSI codes + UTF-8 */
-    size_t max_size = (size_t)buf->width * buf->height * 60 + buf->height * 10 + 64;
-    char *output = malloc(max_size);
-    if (!output) return NULL;
-
-    char *p = output;
-    char *end = output + max_size - 64;  /* Reserve space for final reset + safety margin */
-    tui_style prev_style = {0};
-    int first_cell = 1;
-
-    for (int y = 0; y < buf->height && p < end; y++) {
-        for (int x = 0; x < buf->width && p < end; x++) {
-            tui_cell *cell = &buf->cells[y * buf->width + x];
-
-            /* Skip continuation cells (for wide characters) */
-            if (cell->codepoint == 0) continue;
-
-            /* Check if style changed */
-            int style_changed = first_cell ||
-                cell->style.fg.is_set != prev_style.fg.is_set ||
-                (cell->style.fg.is_set && (cell->style.fg.r != prev_style.fg.r ||
-                                           cell->style.fg.g != prev_style.fg.g ||
-                                           cell->style.fg.b != prev_style.fg.b)) ||
-                cell->style.bg.is_set != prev_style.bg.is_set ||
-                (cell->style.bg.is_set && (cell->style.bg.r != prev_style.bg.r ||
-                                           cell->style.bg.g != prev_style.bg.g ||
-                                           cell->style.bg.b != prev_style.bg.b)) ||
-                cell->style.bold != prev_style.bold ||
-                cell->style.dim != prev_style.dim ||
-                cell->style.italic != prev_style.italic ||
-                cell->style.underline != prev_style.underline ||
-                cell->style.inverse != prev_style.inverse ||
-                cell->style.strikethrough != prev_style.strikethrough;
-
-            if (style_changed) {
-                size_t remaining = (size_t)(end - p);
-                int written;
-
-                /* Reset and apply new style */
-                written = snprintf(p, remaining, "\033[0m");
-                if (written > 0 && (size_t)written < remaining) p += written;
-
-                if (cell->style.bold) {
-                    written = snprintf(p, remaining, "\033[1m");
-                    if (written > 0 && (size_t)written < remaining) p += written;
-                }
-                if (cell->style.dim) {
-                    written = snprintf(p, remaining, "\033[2m");
-                    if (written > 0 && (size_t)written < remaining) p += written;
-                }
-                if (cell->style.italic) {
-                    written = snprintf(p, remaining, "\033[3m");
-                    if (written > 0 && (size_t)written < remaining) p += written;
-                }
-                if (cell->style.underline) {
-                    written = snprintf(p, remaining, "\033[4m");
-                    if (written > 0 && (size_t)written < remaining) p += written;
-                }
-                if (cell->style.inverse) {
-                    written = snprintf(p, remaining, "\033[7m");
-                    if (written > 0 && (size_t)written < remaining) p += written;
-                }
-                if (cell->style.strikethrough) {
-                    written = snprintf(p, remaining, "\033[9m");
-                    if (written > 0 && (size_t)written < remaining) p += written;
-                }
+    if (x0 < 0) x0 = 0;
+    if (x1 >= buf->width) x1 = buf->width - 1;
+    if (x0 > x1) return;
 
-                if (cell->style.fg.is_set) {
-                    written = snprintf(p, remaining, "\033[38;2;%d;%d;%dm",
-                                       cell->style.fg.r, cell->style.fg.g, cell->style.fg.b);
-                    if (written > 0 && (size_t)written < remaining) p += written;
-                }
-                if (cell->style.bg.is_set) {
-                    written = snprintf(p, remaining, "\033[48;2;%d;%d;%dm",
-                                       cell->style.bg.r, cell->style.bg.g, cell->style.bg.b);
-                    if (written > 0 && (size_t)written < remaining) p += written;
-                }
+    row_touch(buf, y, x0, x1);
+}
 
-                prev_style = cell->style;
-                first_cell = 0;
-            }
+/* 64-bit multiply-rotate mix; cheap and order sensitive */
+static inline uint64_t hash_mix(uint64_t h, uint64_t v)
+{
+    h ^= v;
+    h *= 0x9E3779B97F4A7C15ULL;
+    return (h << 31) | (h >> 33);
+}
 
-            /* Encode codepoint to UTF-8 (max 4 bytes) */
-            if (p + 4 < end) {
-                p += tui_utf8_encode(cell->codepoint, p);
-            }
-        }
+uint64_t tui_buffer_row_hash(tui_buffer *buf, int y)
+{
+    if (!buf || y < 0 || y >= buf->height) return 0;
 
-        /* Reset style at end of row to prevent bleeding across newlines */
-        if (p + 8 < end) {
-            int written = snprintf(p, (size_t)(end - p), "\033[0m");
-            if (written > 0) p += written;
-            prev_style = (tui_style){0};
-            first_cell = 1;
-        }
+    tui_row_info *row = &buf->rows[y];
+    if (row->hash_valid) return row->hash;
 
-        /* Add newline (except for last row) */
-        if (y < buf->height - 1 && p < end) {
-            *p++ = '\n';
-        }
-    }
+    /* Style ids are only comparable between buffers sharing a table */
+    uint64_t h = 0xCBF29CE484222325ULL;
+    h ^= (uint64_t)buf->width;
+    const tui_cell *cell = &buf->cells[(size_t)y * (size_t)buf->width];
 
-    /* Reset style at end */
-    size_t remaining = (size_t)(output + max_size - p);
-    if (remaining > 5) {
-        snprintf(p, remaining, "\033[0m");
+    for (int x = 0; x < buf->width; x++, cell++) {
+        h = hash_mix(h, (uint64_t)cell->codepoint |
+                        (uint64_t)cell->style << 32 |
+                        (uint64_t)cell->link << 48);
     }
-    /* Ensure null termination */
-    output[max_size - 1] = '\0';
 
-    return output;
+    row->hash = h;
+    row->hash_valid = 1;
+    return h;
 }
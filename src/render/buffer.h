@@ -18,21 +18,123 @@
 #include "../node/node.h"
 
 /**
- * A single terminal cell containing character and style.
+ * A single terminal cell: codepoint plus ids into the buffer's style and
+ * link tables. Packed to 8 bytes so a cell compares and stores as one word.
  */
 typedef struct {
-    uint32_t codepoint;  /* Unicode codepoint (0 = empty cell) */
-    tui_style style;     /* Foreground, background, attributes */
-    uint8_t dirty;       /* 1 if cell needs redraw, 0 otherwise */
+    uint32_t codepoint;  /* Unicode codepoint (0 = wide-char continuation),
+                          * or TUI_CELL_CLUSTER | cluster id */
+    uint16_t style;      /* Style id (0 = default style) */
+    uint16_t link;       /* Hyperlink id (0 = not a link) */
 } tui_cell;
 
+/* Codepoint of cells a layer buffer leaves see-through (never output) */
+#define TUI_CELL_TRANSPARENT 0x110000
+
+/* Set in the codepoint of cells holding a multi-codepoint grapheme
+ * cluster (ZWJ emoji, flags, combining sequences); the low bits are an
+ * id into the table's cluster arena */
+#define TUI_CELL_CLUSTER 0x80000000u
+
+/* Maximum number of distinct styles per table (ids are 16-bit) */
+#define TUI_STYLE_TABLE_MAX 65535
+
+/* Maximum number of distinct clusters per table */
+#define TUI_CLUSTER_TABLE_MAX 65536
+
+/* Longest cluster stored whole; longer ones keep their first codepoint */
+#define TUI_CLUSTER_MAX_BYTES 64
+
+/* Maximum number of distinct hyperlinks per table (ids are 16-bit, 0 = none) */
+#define TUI_LINK_TABLE_MAX 65535
+
+/**
+ * Interned grapheme clusters, each stored once as UTF-8 so the output
+ * copies its bytes instead of segmenting and encoding it every frame.
+ * Allocated on first use; plain text never touches it.
+ */
+typedef struct {
+    char *bytes;         /* UTF-8 of every cluster, back to back */
+    size_t len;          /* Bytes used */
+    size_t capacity;     /* Bytes allocated */
+    uint32_t *offsets;   /* id -> offset into bytes */
+    uint8_t *lengths;    /* id -> length in bytes */
+    uint8_t *widths;     /* id -> display width (1 or 2) */
+    uint32_t *slots;     /* Open-addressed index: id + 1, 0 = empty */
+    int count;           /* Clusters stored */
+    int id_capacity;     /* Allocated entries in offsets/lengths/widths */
+    int slot_mask;       /* Index size - 1 (power of two) */
+} tui_cluster_arena;
+
+/**
+ * Interned OSC 8 hyperlinks (URL plus optional id parameter).
+ * Allocated on first use. Link ids start at 1; index 0 is unused.
+ */
+typedef struct {
+    char **urls;         /* id -> URL */
+    char **ids;          /* id -> OSC 8 id parameter (NULL if none) */
+    uint16_t *slots;     /* Open-addressed index: id, 0 = empty */
+    int count;           /* Links stored (highest id) */
+    int capacity;        /* Allocated entries in urls/ids */
+    int slot_mask;       /* Index size - 1 (power of two) */
+} tui_link_table;
+
+/**
+ * Interned style palette, grapheme clusters and hyperlinks. Buffers that
+ * are diffed against each other (front/back) share one table so style,
+ * cluster and link ids compare directly.
+ * Reference counted; id 0 is always the default style.
+ */
+typedef struct {
+    tui_style *styles;   /* id -> canonical style */
+    uint64_t *keys;      /* id -> packed style key */
+    uint16_t *slots;     /* Open-addressed index: id + 1, 0 = empty */
+    int count;           /* Styles in use */
+    int capacity;        /* Allocated entries in styles/keys */
+    int slot_mask;       /* Index size - 1 (power of two) */
+    int refcount;        /* Buffers using this table */
+    int compacted;       /* 1 if compaction left it mostly full (not again this frame) */
+    uint64_t last_key;   /* One-entry cache for repeated lookups */
+    uint16_t last_id;
+    tui_cluster_arena clusters; /* Multi-codepoint cell contents */
+    tui_link_table links;       /* Hyperlink targets */
+} tui_style_table;
+
+/**
+ * Per-row change tracking.
+ * The dirty span covers every column written since the last
+ * tui_buffer_mark_clean(); min_x > max_x means the row is clean.
+ * The content hash is computed lazily and cached until the row changes.
+ */
+typedef struct {
+    int min_x;           /* First dirty column */
+    int max_x;           /* Last dirty column */
+    uint64_t hash;       /* Content hash (valid if hash_valid) */
+    int hash_valid;      /* 1 if hash matches current row content */
+} tui_row_info;
+
+/**
+ * Rectangle in buffer cells.
+ */
+typedef struct {
+    int x, y;            /* Top-left corner */
+    int w, h;            /* Size (empty if either is <= 0) */
+} tui_rect;
+
 /**
  * 2D grid of terminal cells.
  */
 typedef struct {
     tui_cell *cells;     /* Contiguous array of width*height cells */
+    tui_style_table *styles; /* Style palette (possibly shared) */
+    tui_row_info *rows;  /* Per-row dirty span and hash (height entries) */
     int width;           /* Buffer width in columns */
     int height;          /* Buffer height in rows */
+    tui_rect clip;       /* Drawing outside this rect is dropped (always
+                          * within the buffer; the whole buffer by default) */
+    tui_rect cut;        /* Cells of wide characters the clip rect cut in
+                          * half since the caller last emptied it */
+    uint16_t link;       /* Link id given to written cells (0 = none) */
 } tui_buffer;
 
 /* ----------------------------------------------------------------
@@ -93,6 +195,18 @@ void tui_buffer_set_cell(tui_buffer *buf, int x, int y, uint32_t ch, const tui_s
  */
 void tui_buffer_write_text(tui_buffer *buf, int x, int y, const char *text, const tui_style *style);
 
+/**
+ * Write the first len bytes of text (stops early at a NUL).
+ * @param buf   Buffer
+ * @param x     Starting column (0-indexed)
+ * @param y     Row (0-indexed)
+ * @param text  UTF-8 text (NULL-safe)
+ * @param len   Bytes to write
+ * @param style Text style (NULL uses default)
+ */
+void tui_buffer_write_text_n(tui_buffer *buf, int x, int y, const char *text, size_t len,
+                             const tui_style *style);
+
 /**
  * Fill rectangle with character and style.
  * @param buf   Buffer
@@ -105,6 +219,63 @@ void tui_buffer_write_text(tui_buffer *buf, int x, int y, const char *text, cons
  */
 void tui_buffer_fill_rect(tui_buffer *buf, int x, int y, int w, int h, uint32_t ch, const tui_style *style);
 
+/**
+ * Reset a rectangle to blank cells, as tui_buffer_clear() does for the
+ * whole buffer. Limited to the clip rect.
+ * @param buf Buffer
+ * @param x   Left column (0-indexed)
+ * @param y   Top row (0-indexed)
+ * @param w   Width in columns
+ * @param h   Height in rows
+ */
+void tui_buffer_clear_rect(tui_buffer *buf, int x, int y, int w, int h);
+
+/**
+ * Grow a rect horizontally so its edges don't split a wide character.
+ * @param buf Buffer
+ * @param r   Rect (buffer coordinates, within bounds)
+ * @return Widened rect
+ */
+tui_rect tui_buffer_align_rect(const tui_buffer *buf, tui_rect r);
+
+/* ----------------------------------------------------------------
+ * Clipping
+ * ---------------------------------------------------------------- */
+
+/**
+ * Narrow the clip rect to its intersection with rect.
+ * set_cell, write_text and fill_rect drop cells outside the clip rect.
+ * Restore the returned rect with tui_buffer_set_clip() when done, so
+ * nested calls form a stack.
+ * @param buf  Buffer
+ * @param rect Region to clip to (buffer coordinates)
+ * @return Clip rect before the call
+ */
+tui_rect tui_buffer_push_clip(tui_buffer *buf, tui_rect rect);
+
+/**
+ * Replace the clip rect (intersected with the buffer bounds).
+ * @param buf  Buffer
+ * @param rect New clip rect, e.g. the value returned by tui_buffer_push_clip()
+ */
+void tui_buffer_set_clip(tui_buffer *buf, tui_rect rect);
+
+/**
+ * Reset the clip rect to the whole buffer.
+ * @param buf Buffer
+ */
+void tui_buffer_reset_clip(tui_buffer *buf);
+
+/**
+ * Check whether any part of a rect lies inside the clip rect.
+ */
+static inline int tui_buffer_clip_intersects(const tui_buffer *buf, int x, int y, int w, int h)
+{
+    return w > 0 && h > 0 &&
+           x < buf->clip.x + buf->clip.w && x + w > buf->clip.x &&
+           y < buf->clip.y + buf->clip.h && y + h > buf->clip.y;
+}
+
 /* ----------------------------------------------------------------
  * Cell access
  * ---------------------------------------------------------------- */
@@ -118,6 +289,140 @@ void tui_buffer_fill_rect(tui_buffer *buf, int x, int y, int w, int h, uint32_t
  */
 tui_cell* tui_buffer_get_cell(tui_buffer *buf, int x, int y);
 
+/* ----------------------------------------------------------------
+ * Styles
+ * ---------------------------------------------------------------- */
+
+/**
+ * Intern a style into the buffer's style table.
+ * When the table is full it is compacted to the styles still in use.
+ * @param buf   Buffer
+ * @param style Style (NULL = default)
+ * @return Style id (0 for the default style, or if the table overflows)
+ */
+uint16_t tui_buffer_intern_style(tui_buffer *buf, const tui_style *style);
+
+/**
+ * Resolve a style id.
+ * @param buf Buffer
+ * @param id  Style id from a cell of this buffer
+ * @return Style (never NULL for valid ids)
+ */
+static inline const tui_style* tui_buffer_style(const tui_buffer *buf, uint16_t id)
+{
+    return &buf->styles->styles[id];
+}
+
+/* ----------------------------------------------------------------
+ * Grapheme clusters
+ * ---------------------------------------------------------------- */
+
+/**
+ * Intern a grapheme cluster into the buffer's table.
+ * @param buf   Buffer
+ * @param bytes UTF-8 of the cluster
+ * @param len   Length in bytes
+ * @param width Display width (1 or 2)
+ * @return Cell codepoint (TUI_CELL_CLUSTER | id), or the cluster's first
+ *         codepoint if it is too long or the arena is full
+ */
+uint32_t tui_buffer_intern_cluster(tui_buffer *buf, const char *bytes, size_t len, int width);
+
+/**
+ * Check whether a cell holds a grapheme cluster.
+ */
+static inline int tui_cell_is_cluster(const tui_cell *cell)
+{
+    return (cell->codepoint & TUI_CELL_CLUSTER) != 0;
+}
+
+/**
+ * Resolve a cluster cell to its UTF-8 bytes.
+ * @param buf   Buffer the cell belongs to
+ * @param cell  Cell for which tui_cell_is_cluster() is true
+ * @param len   Receives the length in bytes
+ * @param width Receives the display width (may be NULL)
+ * @return Bytes inside the arena (valid until the table changes)
+ */
+static inline const char* tui_buffer_cluster(const tui_buffer *buf, const tui_cell *cell,
+                                             size_t *len, int *width)
+{
+    const tui_cluster_arena *a = &buf->styles->clusters;
+    uint32_t id = cell->codepoint & ~TUI_CELL_CLUSTER;
+
+    *len = a->lengths[id];
+    if (width) *width = a->widths[id];
+    return a->bytes + a->offsets[id];
+}
+
+/* ----------------------------------------------------------------
+ * Hyperlinks
+ * ---------------------------------------------------------------- */
+
+/**
+ * Intern a hyperlink into the buffer's table.
+ * @param buf Buffer
+ * @param url Link target (NULL or empty = no link)
+ * @param id  OSC 8 id parameter (may be NULL)
+ * @return Link id, or 0 if url is empty or the table is full
+ */
+uint16_t tui_buffer_intern_link(tui_buffer *buf, const char *url, const char *id);
+
+/**
+ * Set the link id that set_cell, write_text and fill_rect give the cells
+ * they write. Restore the returned id when done, as with the clip rect.
+ * @param buf  Buffer
+ * @param link Link id from tui_buffer_intern_link() (0 = none)
+ * @return Link id before the call
+ */
+static inline uint16_t tui_buffer_set_link(tui_buffer *buf, uint16_t link)
+{
+    uint16_t previous = buf->link;
+    buf->link = link;
+    return previous;
+}
+
+/**
+ * Resolve a link id.
+ * @param buf  Buffer
+ * @param link Non-zero link id from a cell of this buffer
+ * @param id   Receives the OSC 8 id parameter (may be NULL)
+ * @return URL
+ */
+static inline const char* tui_buffer_link(const tui_buffer *buf, uint16_t link, const char **id)
+{
+    if (id) *id = buf->styles->links.ids[link];
+    return buf->styles->links.urls[link];
+}
+
+/**
+ * Make dst use src's style table, remapping dst's cells.
+ * Afterwards cells of both buffers can be compared with tui_cell_equal().
+ * Cells whose style, cluster or link could not be remapped are marked dirty.
+ * @param dst Buffer to remap
+ * @param src Buffer owning the table to share
+ */
+void tui_buffer_share_styles(tui_buffer *dst, tui_buffer *src);
+
+/**
+ * Copy the cells of src inside r onto dst, skipping TUI_CELL_TRANSPARENT
+ * cells. Both buffers must have the same size and share a style table.
+ * Wide characters on dst that a copied cell cuts in half are blanked.
+ * @param dst Destination buffer
+ * @param src Source (layer) buffer
+ * @param r   Region to copy (clipped to bounds)
+ */
+void tui_buffer_composite(tui_buffer *dst, const tui_buffer *src, tui_rect r);
+
+/**
+ * Compare two cells from buffers sharing a style table.
+ */
+static inline int tui_cell_equal(const tui_cell *a, const tui_cell *b)
+{
+    return a->codepoint == b->codepoint && a->style == b->style &&
+           a->link == b->link;
+}
+
 /* ----------------------------------------------------------------
  * Dirty tracking for differential rendering
  * ---------------------------------------------------------------- */
@@ -129,21 +434,42 @@ tui_cell* tui_buffer_get_cell(tui_buffer *buf, int x, int y);
 void tui_buffer_mark_all_dirty(tui_buffer *buf);
 
 /**
- * Mark all cells as clean (no redraw needed).
+ * Mark all cells as clean (no redraw needed). This ends the frame: a
+ * style table left mostly full by compaction may be compacted again.
  * @param buf Buffer
  */
 void tui_buffer_mark_clean(tui_buffer *buf);
 
-/* ----------------------------------------------------------------
- * Serialization
- * ---------------------------------------------------------------- */
+/**
+ * Mark a column range of a row as dirty.
+ * Use after writing cells directly through tui_buffer_get_cell().
+ * @param buf Buffer
+ * @param y   Row (0-indexed)
+ * @param x0  First column (clipped to bounds)
+ * @param x1  Last column, inclusive (clipped to bounds)
+ */
+void tui_buffer_mark_row_dirty(tui_buffer *buf, int y, int x0, int x1);
 
 /**
- * Render buffer to string with ANSI escape codes.
+ * Check whether a row was written since the last tui_buffer_mark_clean().
  * @param buf Buffer
- * @return Newly allocated string (caller must free), or NULL on failure
+ * @param y   Row (0-indexed)
+ * @return 1 if dirty, 0 if clean or out of bounds
+ */
+static inline int tui_buffer_row_dirty(const tui_buffer *buf, int y)
+{
+    return buf && y >= 0 && y < buf->height && buf->rows[y].min_x <= buf->rows[y].max_x;
+}
+
+/**
+ * Get the 64-bit content hash of a row (codepoints and styles).
+ * Cached until the row is written again. Equal rows hash equal; unequal
+ * rows collide with negligible probability.
+ * @param buf Buffer
+ * @param y   Row (0-indexed)
+ * @return Row hash, or 0 if out of bounds
  */
-char* tui_buffer_to_string(tui_buffer *buf);
+uint64_t tui_buffer_row_hash(tui_buffer *buf, int y);
 
 /* ----------------------------------------------------------------
  * Configuration (set from INI values by tui.c)
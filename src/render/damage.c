@@ -0,0 +1,142 @@
+/*
+  +----------------------------------------------------------------------+
+  | ext-tui: Damage regions                                             |
+  +----------------------------------------------------------------------+
+*/
+
+#include "damage.h"
+
+static inline long rect_area(tui_rect r)
+{
+    return (long)r.w * (long)r.h;
+}
+
+static tui_rect rect_union(tui_rect a, tui_rect b)
+{
+    int x0 = a.x < b.x ? a.x : b.x;
+    int y0 = a.y < b.y ? a.y : b.y;
+    int x1 = a.x + a.w > b.x + b.w ? a.x + a.w : b.x + b.w;
+    int y1 = a.y + a.h > b.y + b.h ? a.y + a.h : b.y + b.h;
+    return (tui_rect){ x0, y0, x1 - x0, y1 - y0 };
+}
+
+static inline int rects_overlap(tui_rect a, tui_rect b)
+{
+    return a.x < b.x + b.w && b.x < a.x + a.w &&
+           a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+/* Overlapping, or side by side so the union adds no area */
+static int rects_mergeable(tui_rect a, tui_rect b)
+{
+    return rects_overlap(a, b) ||
+           rect_area(rect_union(a, b)) == rect_area(a) + rect_area(b);
+}
+
+static void remove_rect(tui_damage *d, int i)
+{
+    d->rects[i] = d->rects[--d->count];
+}
+
+void tui_damage_init(tui_damage *d, int width, int height)
+{
+    d->count = 0;
+    d->width = width;
+    d->height = height;
+    d->full = 0;
+}
+
+void tui_damage_add_all(tui_damage *d)
+{
+    d->rects[0] = (tui_rect){ 0, 0, d->width, d->height };
+    d->count = d->width > 0 && d->height > 0 ? 1 : 0;
+    d->full = 1;
+}
+
+void tui_damage_add(tui_damage *d, tui_rect r)
+{
+    if (d->full) return;
+
+    /* Clip to the screen */
+    if (r.x < 0) { r.w += r.x; r.x = 0; }
+    if (r.y < 0) { r.h += r.y; r.y = 0; }
+    if (r.x + r.w > d->width) r.w = d->width - r.x;
+    if (r.y + r.h > d->height) r.h = d->height - r.y;
+    if (r.w <= 0 || r.h <= 0) return;
+
+    for (;;) {
+        /* Absorb every rect the new one overlaps; the union may now reach
+         * rects it missed before, so rescan after each merge */
+        int merged = 0;
+        for (int i = 0; i < d->count; i++) {
+            if (rects_mergeable(d->rects[i], r)) {
+                r = rect_union(d->rects[i], r);
+                remove_rect(d, i);
+                merged = 1;
+                break;
+            }
+        }
+        if (merged) continue;
+
+        if (d->count < TUI_DAMAGE_MAX_RECTS) break;
+
+        /* List full: merge with the rect that wastes the least area */
+        int best = 0;
+        long best_waste = -1;
+        for (int i = 0; i < d->count; i++) {
+            long waste = rect_area(rect_union(d->rects[i], r)) -
+                         rect_area(d->rects[i]) - rect_area(r);
+            if (best_waste < 0 || waste < best_waste) {
+                best = i;
+                best_waste = waste;
+            }
+        }
+        r = rect_union(d->rects[best], r);
+        remove_rect(d, best);
+    }
+
+    if (r.w >= d->width && r.h >= d->height) {
+        tui_damage_add_all(d);
+        return;
+    }
+    d->rects[d->count++] = r;
+}
+
+void tui_damage_subtract(tui_damage *d, tui_rect r)
+{
+    if (r.w <= 0 || r.h <= 0) return;
+
+    tui_damage rest;
+    tui_damage_init(&rest, d->width, d->height);
+
+    for (int i = 0; i < d->count; i++) {
+        tui_rect a = d->rects[i];
+        if (!rects_overlap(a, r)) {
+            tui_damage_add(&rest, a);
+            continue;
+        }
+
+        /* Up to four pieces: full-width bands above and below the
+         * overlap, then the parts left and right of it */
+        int top = r.y > a.y ? r.y : a.y;
+        int bottom = r.y + r.h < a.y + a.h ? r.y + r.h : a.y + a.h;
+        int left = r.x > a.x ? r.x : a.x;
+        int right = r.x + r.w < a.x + a.w ? r.x + r.w : a.x + a.w;
+
+        tui_damage_add(&rest, (tui_rect){ a.x, a.y, a.w, top - a.y });
+        tui_damage_add(&rest, (tui_rect){ a.x, bottom, a.w, a.y + a.h - bottom });
+        tui_damage_add(&rest, (tui_rect){ a.x, top, left - a.x, bottom - top });
+        tui_damage_add(&rest, (tui_rect){ right, top, a.x + a.w - right, bottom - top });
+    }
+
+    *d = rest;
+}
+
+long tui_damage_area(const tui_damage *d)
+{
+    long area = 0;
+    for (int i = 0; i < d->count; i++) {
+        area += rect_area(d->rects[i]);
+    }
+    return area;
+}
@@ -0,0 +1,52 @@
+/*
+  +----------------------------------------------------------------------+
+  | ext-tui: Damage regions                                             |
+  +----------------------------------------------------------------------+
+  | Collects the screen areas that changed between two frames so the    |
+  | rasterizer only clears and redraws those. Overlapping or touching   |
+  | rects are merged; past TUI_DAMAGE_MAX_RECTS the pair whose union    |
+  | wastes the least area is merged instead.                            |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef TUI_RENDER_DAMAGE_H
+#define TUI_RENDER_DAMAGE_H
+
+#include "buffer.h"
+
+#define TUI_DAMAGE_MAX_RECTS 16
+
+typedef struct {
+    tui_rect rects[TUI_DAMAGE_MAX_RECTS];
+    int count;
+    int width, height;      /* Bounds every rect is clipped to */
+    int full;               /* Covers the whole screen */
+} tui_damage;
+
+/**
+ * Start an empty damage list for a width x height screen.
+ */
+void tui_damage_init(tui_damage *d, int width, int height);
+
+/**
+ * Add a region. Clipped to the screen; empty rects are ignored.
+ */
+void tui_damage_add(tui_damage *d, tui_rect r);
+
+/**
+ * Remove a region (e.g. one an opaque layer covers). Rects it overlaps
+ * are split into the parts outside it.
+ */
+void tui_damage_subtract(tui_damage *d, tui_rect r);
+
+/**
+ * Mark the whole screen as damaged.
+ */
+void tui_damage_add_all(tui_damage *d);
+
+/**
+ * Number of damaged cells (rects never overlap after merging).
+ */
+long tui_damage_area(const tui_damage *d);
+
+#endif /* TUI_RENDER_DAMAGE_H */
@@ -0,0 +1,271 @@
+/*
+  +----------------------------------------------------------------------+
+  | ext-tui: Row comparison kernels                                     |
+  +----------------------------------------------------------------------+
+  | Cells are 8 bytes, so a row compares as an array of 64-bit words.   |
+  | SSE2 handles 2 cells per step, AVX2 handles 4. Each kernel returns  |
+  | the same result as the reference loop (cell by cell, equality via   |
+  | tui_cell_equal), which the selftest checks at startup.              |
+  +----------------------------------------------------------------------+
+*/
+
+#include "diff.h"
+#include "../debug.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+# define TUI_ROW_DIFF_X86 1
+# include <immintrin.h>
+#endif
+
+#if defined(TUI_ROW_DIFF_X86) && defined(__SSE2__)
+# define TUI_ROW_DIFF_HAVE_SSE2 1
+#endif
+
+/* AVX2 is compiled via a target attribute and only called if the CPU has it */
+#if defined(TUI_ROW_DIFF_X86) && (defined(__clang__) || __GNUC__ >= 5)
+# define TUI_ROW_DIFF_HAVE_AVX2 1
+#endif
+
+typedef int (*row_diff_fn)(const tui_cell *a, const tui_cell *b, int from, int to);
+
+typedef struct {
+    const char *name;
+    row_diff_fn first;
+    row_diff_fn last;
+} row_diff_impl;
+
+/* ----------------------------------------------------------------
+ * Reference loop (what output.c did before, one cell at a time)
+ * ---------------------------------------------------------------- */
+
+static int ref_first(const tui_cell *a, const tui_cell *b, int from, int to)
+{
+    for (int i = from; i < to; i++) {
+        if (!tui_cell_equal(&a[i], &b[i])) return i;
+    }
+    return to;
+}
+
+static int ref_last(const tui_cell *a, const tui_cell *b, int from, int to)
+{
+    for (int i = to - 1; i >= from; i--) {
+        if (!tui_cell_equal(&a[i], &b[i])) return i;
+    }
+    return -1;
+}
+
+/* ----------------------------------------------------------------
+ * Scalar: one 64-bit compare per cell
+ * ---------------------------------------------------------------- */
+
+static inline uint64_t cell_word(const tui_cell *c)
+{
+    uint64_t w;
+    memcpy(&w, c, sizeof(w));
+    return w;
+}
+
+static int scalar_first(const tui_cell *a, const tui_cell *b, int from, int to)
+{
+    for (int i = from; i < to; i++) {
+        if (cell_word(&a[i]) != cell_word(&b[i])) return i;
+    }
+    return to;
+}
+
+static int scalar_last(const tui_cell *a, const tui_cell *b, int from, int to)
+{
+    for (int i = to - 1; i >= from; i--) {
+        if (cell_word(&a[i]) != cell_word(&b[i])) return i;
+    }
+    return -1;
+}
+
+/* ----------------------------------------------------------------
+ * SSE2: 2 cells per 128-bit compare
+ * ---------------------------------------------------------------- */
+
+#ifdef TUI_ROW_DIFF_HAVE_SSE2
+/* SSE2 has no 64-bit compare; a cell matches when both 32-bit lanes do */
+static inline unsigned sse2_neq_mask(const tui_cell *a, const tui_cell *b)
+{
+    __m128i va = _mm_loadu_si128((const __m128i *)(const void *)a);
+    __m128i vb = _mm_loadu_si128((const __m128i *)(const void *)b);
+    return ~(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi32(va, vb)) & 0xFFFFu;
+}
+
+static int sse2_first(const tui_cell *a, const tui_cell *b, int from, int to)
+{
+    int i = from;
+    for (; i + 2 <= to; i += 2) {
+        unsigned m = sse2_neq_mask(&a[i], &b[i]);
+        if (m) return i + (__builtin_ctz(m) >> 3);
+    }
+    return scalar_first(a, b, i, to);
+}
+
+static int sse2_last(const tui_cell *a, const tui_cell *b, int from, int to)
+{
+    int i = to;
+    for (; i - 2 >= from; i -= 2) {
+        unsigned m = sse2_neq_mask(&a[i - 2], &b[i - 2]);
+        if (m) return i - 2 + ((31 - __builtin_clz(m)) >> 3);
+    }
+    return scalar_last(a, b, from, i);
+}
+#endif
+
+/* ----------------------------------------------------------------
+ * AVX2: 4 cells per 256-bit compare
+ * ---------------------------------------------------------------- */
+
+#ifdef TUI_ROW_DIFF_HAVE_AVX2
+__attribute__((target("avx2")))
+static inline unsigned avx2_neq_mask(const tui_cell *a, const tui_cell *b)
+{
+    __m256i va = _mm256_loadu_si256((const __m256i *)(const void *)a);
+    __m256i vb = _mm256_loadu_si256((const __m256i *)(const void *)b);
+    return ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi64(va, vb));
+}
+
+__attribute__((target("avx2")))
+static int avx2_first(const tui_cell *a, const tui_cell *b, int from, int to)
+{
+    int i = from;
+    for (; i + 4 <= to; i += 4) {
+        unsigned m = avx2_neq_mask(&a[i], &b[i]);
+        if (m) return i + (__builtin_ctz(m) >> 3);
+    }
+    return scalar_first(a, b, i, to);
+}
+
+__attribute__((target("avx2")))
+static int avx2_last(const tui_cell *a, const tui_cell *b, int from, int to)
+{
+    int i = to;
+    for (; i - 4 >= from; i -= 4) {
+        unsigned m = avx2_neq_mask(&a[i - 4], &b[i - 4]);
+        if (m) return i - 4 + ((31 - __builtin_clz(m)) >> 3);
+    }
+    return scalar_last(a, b, from, i);
+}
+#endif
+
+/* ----------------------------------------------------------------
+ * Dispatch
+ * ---------------------------------------------------------------- */
+
+static const row_diff_impl impls[] = {
+    [TUI_ROW_DIFF_SCALAR] = { "scalar", scalar_first, scalar_last },
+#ifdef TUI_ROW_DIFF_HAVE_SSE2
+    [TUI_ROW_DIFF_SSE2] = { "sse2", sse2_first, sse2_last },
+#endif
+#ifdef TUI_ROW_DIFF_HAVE_AVX2
+    [TUI_ROW_DIFF_AVX2] = { "avx2", avx2_first, avx2_last },
+#endif
+};
+
+#define IMPL_COUNT ((int)(sizeof(impls) / sizeof(impls[0])))
+
+/* Written once from MINIT, read-only afterwards */
+static tui_row_diff_kernel active_kernel = TUI_ROW_DIFF_SCALAR;
+
+static int kernel_available(tui_row_diff_kernel k)
+{
+    if ((int)k >= IMPL_COUNT || !impls[k].first) return 0;
+
+#ifdef TUI_ROW_DIFF_HAVE_AVX2
+    if (k == TUI_ROW_DIFF_AVX2) {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? 1 : 0;
+    }
+#endif
+    return 1;
+}
+
+int tui_row_diff_first(const tui_cell *a, const tui_cell *b, int from, int to)
+{
+    return impls[active_kernel].first(a, b, from, to);
+}
+
+int tui_row_diff_last(const tui_cell *a, const tui_cell *b, int from, int to)
+{
+    return impls[active_kernel].last(a, b, from, to);
+}
+
+const char* tui_row_diff_kernel_name(void)
+{
+    return impls[active_kernel].name;
+}
+
+/* ----------------------------------------------------------------
+ * Selftest
+ * ---------------------------------------------------------------- */
+
+#define SELFTEST_WIDTH 67   /* Odd, not a multiple of any vector width */
+
+/* xorshift32: deterministic, no libc rand() state */
+static uint32_t selftest_next(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static int selftest_kernel(const row_diff_impl *impl)
+{
+    tui_cell a[SELFTEST_WIDTH];
+    tui_cell b[SELFTEST_WIDTH];
+    uint32_t state = 0x9E3779B9u;
+
+    for (int round = 0; round < 512; round++) {
+        for (int i = 0; i < SELFTEST_WIDTH; i++) {
+            a[i].codepoint = 'a' + (selftest_next(&state) % 4);
+            a[i].style = (uint16_t)(selftest_next(&state) % 3);
+            a[i].link = 0;
+            b[i] = a[i];
+        }
+
+        /* Sprinkle 0-3 differences, hitting each field of the cell */
+        int diffs = (int)(selftest_next(&state) % 4);
+        for (int d = 0; d < diffs; d++) {
+            int at = (int)(selftest_next(&state) % SELFTEST_WIDTH);
+            switch (selftest_next(&state) % 3) {
+                case 0: b[at].codepoint ^= 0x10000; break;
+                case 1: b[at].style ^= 0x8000; break;
+                default: b[at].link ^= 1; break;
+            }
+        }
+
+        int from = (int)(selftest_next(&state) % SELFTEST_WIDTH);
+        int to = from + (int)(selftest_next(&state) % (unsigned)(SELFTEST_WIDTH - from + 1));
+
+        if (impl->first(a, b, from, to) != ref_first(a, b, from, to) ||
+            impl->last(a, b, from, to) != ref_last(a, b, from, to)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+tui_row_diff_kernel tui_row_diff_init(void)
+{
+    active_kernel = TUI_ROW_DIFF_SCALAR;
+
+    /* Widest kernel that exists and agrees with the reference loop */
+    for (int k = IMPL_COUNT - 1; k > TUI_ROW_DIFF_SCALAR; k--) {
+        if (!kernel_available((tui_row_diff_kernel)k)) continue;
+        if (selftest_kernel(&impls[k]) == 0) {
+            active_kernel = (tui_row_diff_kernel)k;
+            break;
+        }
+        TUI_DEBUG_PRINT("row diff kernel '%s' failed selftest\n", impls[k].name);
+    }
+
+    return active_kernel;
+}
@@ -0,0 +1,52 @@
+/*
+  +----------------------------------------------------------------------+
+  | ext-tui: Row comparison kernels                                     |
+  +----------------------------------------------------------------------+
+  | Finds differing cells between two rows of the same width. Used by   |
+  | the output diff to skip unchanged runs without touching every cell. |
+  |                                                                      |
+  | Kernels: scalar (always), SSE2 (x86 baseline), AVX2 (selected at    |
+  | runtime). tui_row_diff_init() picks the widest kernel that passes   |
+  | the selftest; until then the scalar kernel is used.                 |
+  |                                                                      |
+  | Cells must come from buffers sharing a style table (see             |
+  | tui_buffer_share_styles()); comparison is on the raw 8-byte cell.   |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef TUI_RENDER_DIFF_H
+#define TUI_RENDER_DIFF_H
+
+#include "buffer.h"
+
+typedef enum {
+    TUI_ROW_DIFF_SCALAR,
+    TUI_ROW_DIFF_SSE2,
+    TUI_ROW_DIFF_AVX2
+} tui_row_diff_kernel;
+
+/**
+ * Select the row diff kernel for this CPU and verify it against the
+ * scalar loop. Call once at module startup.
+ * @return Active kernel
+ */
+tui_row_diff_kernel tui_row_diff_init(void);
+
+/**
+ * Name of the active kernel ("scalar", "sse2", "avx2").
+ */
+const char* tui_row_diff_kernel_name(void);
+
+/**
+ * Find the first differing cell in [from, to).
+ * @return Index of the first difference, or `to` if the range is equal
+ */
+int tui_row_diff_first(const tui_cell *a, const tui_cell *b, int from, int to);
+
+/**
+ * Find the last differing cell in [from, to).
+ * @return Index of the last difference, or -1 if the range is equal
+ */
+int tui_row_diff_last(const tui_cell *a, const tui_cell *b, int from, int to);
+
+#endif /* TUI_RENDER_DIFF_H */
@@ -5,17 +5,19 @@
 */
 
 #include "output.h"
+#include "diff.h"
 #include "../terminal/ansi.h"
+#include "../terminal/capabilities.h"
 #include "../text/measure.h"
 #include "../debug.h"
+#include "php.h"
+#include "php_tui.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <errno.h>
 
-#define OUTPUT_BUFFER_SIZE 65536
-
 /* Wrapper macro that logs failed writes in debug builds.
  * Terminal write failures are rare and non-recoverable (terminal is gone),
  * so we just log them for debugging purposes. */
@@ -52,10 +54,12 @@ int tui_write_all(int fd, const void *buf, size_t len)
 
     while (remaining > 0) {
         ssize_t written = write(fd, p, remaining);
+        TUI_METRIC_INC(output_writes);
         if (written < 0) {
             if (errno == EINTR) continue;
             return -1;
         }
+        TUI_METRIC_ADD(output_bytes, written);
         p += written;
         remaining -= (size_t)written;
     }
@@ -74,6 +78,15 @@ int tui_output_is_valid(void)
 /* Internal alias for backward compatibility within this file */
 #define write_all tui_write_all
 
+/* Capability flags can know better than the env-based depth (e.g. kitty
+ * without COLORTERM), so they take precedence */
+static int output_color_depth(const tui_capabilities *caps)
+{
+    if (caps->capabilities & TUI_CAP_TRUE_COLOR) return 16777216;
+    if (caps->capabilities & TUI_CAP_256_COLOR) return 256;
+    return caps->color_depth;
+}
+
 tui_output* tui_output_create(int width, int height)
 {
     tui_output *out = calloc(1, sizeof(tui_output));
@@ -83,6 +96,9 @@ tui_output* tui_output_create(int width, int height)
     out->back = tui_buffer_create(width, height);
     out->mode = TUI_OUTPUT_NORMAL;
     out->cursor_visible = 1;
+    out->capabilities = tui_get_capabilities()->capabilities;
+    out->color_depth = output_color_depth(tui_get_capabilities());
+    tui_output_queue_init(&out->queue);
 
     if (!out->front || !out->back) {
         tui_buffer_destroy(out->front);
@@ -91,12 +107,19 @@ tui_output* tui_output_create(int width, int height)
         return NULL;
     }
 
+    /* Front starts as a blank screen (matches a freshly cleared terminal);
+     * only tui_output_flush() forces a full redraw */
+    tui_buffer_mark_clean(out->front);
+
     return out;
 }
 
 void tui_output_destroy(tui_output *out)
 {
     if (out) {
+        tui_output_end_frame(out);
+        tui_output_set_encode_threads(out, 0);
+        tui_output_queue_free(&out->queue);
         tui_buffer_destroy(out->front);
         tui_buffer_destroy(out->back);
         free(out);
@@ -112,15 +135,15 @@ void tui_output_enter_alternate(tui_output *out)
 
     /* Enter alternate screen buffer */
     tui_ansi_alternate_screen_enter(buf, &len);
-    write_all(STDOUT_FILENO, buf, len);
+    tui_output_write(buf, len);
 
     /* Clear screen and move cursor to home position */
     tui_ansi_clear_screen(buf, &len);
-    write_all(STDOUT_FILENO, buf, len);
+    tui_output_write(buf, len);
 
     /* Hide cursor */
     tui_ansi_cursor_hide(buf, &len);
-    write_all(STDOUT_FILENO, buf, len);
+    tui_output_write(buf, len);
 
     out->mode = TUI_OUTPUT_ALTERNATE;
 }
@@ -133,194 +156,1070 @@ void tui_output_exit_alternate(tui_output *out)
     size_t len;
 
     tui_ansi_cursor_show(buf, &len);
-    write_all(STDOUT_FILENO, buf, len);
+    tui_output_write(buf, len);
 
     tui_ansi_alternate_screen_exit(buf, &len);
-    write_all(STDOUT_FILENO, buf, len);
+    tui_output_write(buf, len);
 
     out->mode = TUI_OUTPUT_NORMAL;
 }
 
-/**
- * Compare two styles for equality.
- * Uses explicit field comparison instead of memcmp to avoid
- * issues with struct padding bytes containing garbage.
+/* ----------------------------------------------------------------
+ * SGR transitions
+ * ----------------------------------------------------------------
+ * A style change is one CSI ... m carrying only the parameters that
+ * differ, using the per-attribute "off" codes (22/23/24/27/29/39/49).
+ * When resetting with 0 and re-applying the target is shorter, that
+ * form is used instead.
+ */
+
+/* Longest parameter list: every attribute plus two RGB colors */
+#define SGR_PARAMS_MAX 64
+
+typedef struct {
+    char data[SGR_PARAMS_MAX];
+    size_t len;
+} sgr_params;
+
+static void sgr_add(sgr_params *p, unsigned int value)
+{
+    char digits[4];
+    int n = 0;
+
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value && n < 4);
+
+    if (p->len) p->data[p->len++] = ';';
+    while (n) p->data[p->len++] = digits[--n];
+}
+
+/*
+ * Colors are compared and emitted as encoded codes so that two RGB values
+ * quantizing to the same palette entry don't produce a redundant SGR.
+ * Code 0 is the terminal default.
+ */
+#define COLOR_CODE_RGB     (1u << 24)
+#define COLOR_CODE_256     (2u << 24)
+#define COLOR_CODE_16      (3u << 24)
+#define COLOR_CODE_KIND(c) ((c) & (3u << 24))
+
+static uint8_t color_lut_lookup(tui_color_lut *lut, uint32_t rgb, int depth)
+{
+    uint32_t slot = (rgb ^ (rgb >> 7) ^ (rgb >> 15)) & (TUI_COLOR_LUT_SIZE - 1);
+
+    if (lut->rgb[slot] == (rgb | TUI_COLOR_LUT_VALID)) {
+        return lut->index[slot];
+    }
+
+    uint8_t r = (uint8_t)(rgb >> 16), g = (uint8_t)(rgb >> 8), b = (uint8_t)rgb;
+    int index = depth >= 256 ? tui_rgb_to_ansi256(r, g, b) : tui_rgb_to_ansi16(r, g, b);
+
+    /* 8-color terminals have no bright variants */
+    if (depth < 16) index &= 7;
+
+    lut->rgb[slot] = rgb | TUI_COLOR_LUT_VALID;
+    lut->index[slot] = (uint8_t)index;
+    return (uint8_t)index;
+}
+
+static uint32_t color_code(const tui_output *out, tui_color_lut *lut, const tui_color *c)
+{
+    if (!c->is_set || out->color_depth <= 0) return 0;
+
+    uint32_t rgb = ((uint32_t)c->r << 16) | ((uint32_t)c->g << 8) | c->b;
+    if (out->color_depth >= 16777216) return COLOR_CODE_RGB | rgb;
+
+    uint8_t index = color_lut_lookup(lut, rgb, out->color_depth);
+    return (out->color_depth >= 256 ? COLOR_CODE_256 : COLOR_CODE_16) | index;
+}
+
+/*
+ * 38;2;r;g;b / 38;5;n / 3n / 9n for foreground (base 30),
+ * the 48/4n/10n equivalents for background (base 40); 39/49 for default.
  */
-static int styles_equal(const tui_style *a, const tui_style *b)
+static void sgr_add_color(sgr_params *p, unsigned int base, uint32_t code)
+{
+    switch (COLOR_CODE_KIND(code)) {
+        case COLOR_CODE_RGB:
+            sgr_add(p, base + 8);
+            sgr_add(p, 2);
+            sgr_add(p, (code >> 16) & 0xFF);
+            sgr_add(p, (code >> 8) & 0xFF);
+            sgr_add(p, code & 0xFF);
+            break;
+        case COLOR_CODE_256:
+            sgr_add(p, base + 8);
+            sgr_add(p, 5);
+            sgr_add(p, code & 0xFF);
+            break;
+        case COLOR_CODE_16:
+            if ((code & 0xFF) < 8) {
+                sgr_add(p, base + (code & 0xFF));
+            } else {
+                sgr_add(p, base + 60 + (code & 0xFF) - 8);
+            }
+            break;
+        default:
+            sgr_add(p, base + 9);
+            break;
+    }
+}
+
+/* Parameters taking the terminal from `from` to `to` without a reset */
+static void sgr_transition(const tui_output *out, tui_color_lut *lut, sgr_params *p,
+                           const tui_style *from, const tui_style *to)
 {
-    return a->fg.is_set == b->fg.is_set &&
-           a->fg.r == b->fg.r && a->fg.g == b->fg.g && a->fg.b == b->fg.b &&
-           a->bg.is_set == b->bg.is_set &&
-           a->bg.r == b->bg.r && a->bg.g == b->bg.g && a->bg.b == b->bg.b &&
-           a->bold == b->bold && a->dim == b->dim &&
-           a->italic == b->italic && a->underline == b->underline &&
-           a->inverse == b->inverse && a->strikethrough == b->strikethrough;
+    /* Bold and dim share their off code */
+    if ((from->bold && !to->bold) || (from->dim && !to->dim)) {
+        sgr_add(p, 22);
+        if (to->bold) sgr_add(p, 1);
+        if (to->dim) sgr_add(p, 2);
+    } else {
+        if (to->bold && !from->bold) sgr_add(p, 1);
+        if (to->dim && !from->dim) sgr_add(p, 2);
+    }
+
+    if (to->italic != from->italic) sgr_add(p, to->italic ? 3 : 23);
+    if (to->underline != from->underline) sgr_add(p, to->underline ? 4 : 24);
+    if (to->inverse != from->inverse) sgr_add(p, to->inverse ? 7 : 27);
+    if (to->strikethrough != from->strikethrough) sgr_add(p, to->strikethrough ? 9 : 29);
+
+    uint32_t from_fg = color_code(out, lut, &from->fg), to_fg = color_code(out, lut, &to->fg);
+    if (from_fg != to_fg) sgr_add_color(p, 30, to_fg);
+
+    uint32_t from_bg = color_code(out, lut, &from->bg), to_bg = color_code(out, lut, &to->bg);
+    if (from_bg != to_bg) sgr_add_color(p, 40, to_bg);
 }
 
-static size_t apply_style_diff(char *buf, const tui_style *old_style, const tui_style *new_style)
+static size_t apply_style_diff(const tui_output *out, tui_color_lut *lut, char *buf,
+                               const tui_style *old_style, const tui_style *new_style)
 {
+    static const tui_style default_style = {0};
+    sgr_params delta = { .len = 0 };
+    sgr_params reset = { .len = 0 };
+
+    sgr_transition(out, lut, &delta, old_style, new_style);
+    if (delta.len == 0) return 0;
+
+    /* "0;<target>", or a bare CSI m when the target is the default */
+    sgr_transition(out, lut, &reset, &default_style, new_style);
+    size_t reset_len = reset.len ? reset.len + 2 : 0;
+
     size_t len = 0;
+    buf[len++] = '\x1b';
+    buf[len++] = '[';
+    if (reset_len < delta.len) {
+        if (reset.len) {
+            buf[len++] = '0';
+            buf[len++] = ';';
+            memcpy(buf + len, reset.data, reset.len);
+            len += reset.len;
+        }
+    } else {
+        memcpy(buf + len, delta.data, delta.len);
+        len += delta.len;
+    }
+    buf[len++] = 'm';
 
-    /* Check if we need to reset first - this includes:
-     * - Removing text styles (bold, dim, etc.)
-     * - Removing foreground or background colors */
-    int need_reset = 0;
-    if ((old_style->bold && !new_style->bold) ||
-        (old_style->dim && !new_style->dim) ||
-        (old_style->italic && !new_style->italic) ||
-        (old_style->underline && !new_style->underline) ||
-        (old_style->inverse && !new_style->inverse) ||
-        (old_style->strikethrough && !new_style->strikethrough) ||
-        (old_style->fg.is_set && !new_style->fg.is_set) ||
-        (old_style->bg.is_set && !new_style->bg.is_set)) {
-        need_reset = 1;
-    }
-
-    if (need_reset) {
-        size_t slen;
-        tui_ansi_reset(buf + len, &slen);
-        len += slen;
+    return len;
+}
+
+/* Maximum size for a single ANSI escape sequence (generous for RGB colors + attributes) */
+#define ANSI_BUFFER_SIZE 256
+
+/* ----------------------------------------------------------------
+ * Scroll detection
+ * ----------------------------------------------------------------
+ * When a band of rows in the new frame equals the front buffer shifted
+ * by n rows (log tail, list scrolling), move it on the terminal with
+ * DECSTBM + SU/SD and let the diff repaint only the exposed rows.
+ */
+
+/* Rows that must change in place before a scroll is worth ~20 bytes */
+#define SCROLL_MIN_GAIN 2
+
+typedef struct {
+    int top;       /* First row of the scroll region */
+    int bottom;    /* Last row of the scroll region (inclusive) */
+    int shift;     /* > 0: content moves up (SU), < 0: moves down (SD) */
+} scroll_op;
+
+typedef struct {
+    uint64_t hash;
+    int row;       /* Old row index, -1 if the hash occurs more than once */
+    int used;
+} row_hash_slot;
+
+static inline size_t row_slot(uint64_t hash, size_t mask)
+{
+    return (size_t)(hash ^ (hash >> 29)) & mask;
+}
+
+static int rows_equal(tui_buffer *a, int ya, tui_buffer *b, int yb)
+{
+    return memcmp(&a->cells[(size_t)ya * (size_t)a->width],
+                  &b->cells[(size_t)yb * (size_t)b->width],
+                  (size_t)a->width * sizeof(tui_cell)) == 0;
+}
+
+/* Row is what a scroll exposes: spaces in the default style, no link */
+static int row_is_blank(tui_buffer *buf, int y)
+{
+    const tui_cell *row = &buf->cells[(size_t)y * (size_t)buf->width];
+    for (int x = 0; x < buf->width; x++) {
+        if (row[x].codepoint != ' ' || row[x].style != 0 || row[x].link != 0) return 0;
     }
+    return 1;
+}
 
-    /* Apply text styles */
-    if (new_style->bold) {
-        size_t slen;
-        tui_ansi_bold(buf + len, &slen);
-        len += slen;
+/*
+ * Find the band [a, b] of new rows matching old rows [a+s, b+s] that saves
+ * the most in-place repaints. Requires both buffers to share a style table
+ * and have the same width.
+ * Returns 1 and fills op if a scroll is worthwhile.
+ */
+static int detect_scroll(tui_buffer *buf, tui_buffer *front, int rows, scroll_op *op)
+{
+    if (buf->width != front->width || rows < SCROLL_MIN_GAIN + 1) return 0;
+
+    /* Terminal contents unknown somewhere: nothing to shift */
+    int changed = 0;
+    for (int y = 0; y < rows; y++) {
+        if (tui_buffer_row_dirty(front, y)) return 0;
+        if (tui_buffer_row_dirty(buf, y) &&
+            tui_buffer_row_hash(buf, y) != tui_buffer_row_hash(front, y)) {
+            changed++;
+        }
     }
-    if (new_style->dim) {
-        size_t slen;
-        tui_ansi_dim(buf + len, &slen);
-        len += slen;
+    if (changed < SCROLL_MIN_GAIN) return 0;
+
+    size_t slot_count = 16;
+    while (slot_count < (size_t)rows * 2) slot_count <<= 1;
+    size_t mask = slot_count - 1;
+    row_hash_slot *slots = calloc(slot_count, sizeof(row_hash_slot));
+    if (!slots) return 0;
+
+    /* Index old rows by hash; repeated content (blank rows) is ambiguous */
+    for (int y = 0; y < rows; y++) {
+        uint64_t h = tui_buffer_row_hash(front, y);
+        size_t i = row_slot(h, mask);
+        while (slots[i].used && slots[i].hash != h) i = (i + 1) & mask;
+        if (slots[i].used) {
+            slots[i].row = -1;
+        } else {
+            slots[i].used = 1;
+            slots[i].hash = h;
+            slots[i].row = y;
+        }
     }
-    if (new_style->italic) {
-        size_t slen;
-        tui_ansi_italic(buf + len, &slen);
-        len += slen;
+
+    int best_gain = 0, best_a = 0, best_b = 0, best_shift = 0;
+    int covered_to = -1, covered_shift = 0;
+
+    for (int y = 0; y < rows; y++) {
+        uint64_t h = tui_buffer_row_hash(buf, y);
+        if (h == tui_buffer_row_hash(front, y)) continue;
+
+        size_t i = row_slot(h, mask);
+        while (slots[i].used && slots[i].hash != h) i = (i + 1) & mask;
+        if (!slots[i].used || slots[i].row < 0) continue;
+
+        int shift = slots[i].row - y;
+        if (y <= covered_to && shift == covered_shift) continue;
+
+        /* Grow the band both ways, blank/duplicate rows included */
+        int a = y, b = y;
+        while (a - 1 >= 0 && a - 1 + shift >= 0 &&
+               tui_buffer_row_hash(buf, a - 1) == tui_buffer_row_hash(front, a - 1 + shift)) {
+            a--;
+        }
+        while (b + 1 < rows && b + 1 + shift < rows &&
+               tui_buffer_row_hash(buf, b + 1) == tui_buffer_row_hash(front, b + 1 + shift)) {
+            b++;
+        }
+        covered_to = b;
+        covered_shift = shift;
+
+        /* Net repaints saved: rows the shift fixes, minus rows at the
+         * edge of the region that were already right and would be
+         * blanked by it (a fixed header/footer caught in the region) */
+        int gain = 0;
+        for (int r = a; r <= b; r++) {
+            if (tui_buffer_row_hash(buf, r) != tui_buffer_row_hash(front, r)) gain++;
+        }
+        int n = shift > 0 ? shift : -shift;
+        int exposed_top = shift > 0 ? b + 1 : a - n;
+        for (int r = exposed_top; r < exposed_top + n; r++) {
+            if (tui_buffer_row_hash(buf, r) == tui_buffer_row_hash(front, r) &&
+                !row_is_blank(buf, r)) {
+                gain--;
+            }
+        }
+        if (gain > best_gain) {
+            best_gain = gain;
+            best_a = a;
+            best_b = b;
+            best_shift = shift;
+        }
     }
-    if (new_style->underline) {
-        size_t slen;
-        tui_ansi_underline(buf + len, &slen);
-        len += slen;
+    free(slots);
+
+    if (best_gain < SCROLL_MIN_GAIN) return 0;
+
+    /* Hashes picked the band; confirm on the cells themselves */
+    for (int r = best_a; r <= best_b; r++) {
+        if (!rows_equal(buf, r, front, r + best_shift)) return 0;
     }
-    if (new_style->inverse) {
-        size_t slen;
-        tui_ansi_inverse(buf + len, &slen);
-        len += slen;
+
+    if (best_shift > 0) {
+        op->top = best_a;
+        op->bottom = best_b + best_shift;
+    } else {
+        op->top = best_a + best_shift;
+        op->bottom = best_b;
     }
-    if (new_style->strikethrough) {
-        size_t slen;
-        tui_ansi_strikethrough(buf + len, &slen);
-        len += slen;
+    op->shift = best_shift;
+    return 1;
+}
+
+/*
+ * Mirror a terminal scroll in the front buffer. Rows whose front content
+ * changed are marked dirty in buf so the row diff revisits them.
+ */
+static void scroll_front(tui_buffer *front, tui_buffer *buf, const scroll_op *op)
+{
+    int n = op->shift > 0 ? op->shift : -op->shift;
+    size_t row_bytes = (size_t)front->width * sizeof(tui_cell);
+
+    if (op->shift > 0) {
+        for (int y = op->top; y <= op->bottom - n; y++) {
+            memcpy(&front->cells[(size_t)y * (size_t)front->width],
+                   &front->cells[(size_t)(y + n) * (size_t)front->width], row_bytes);
+            front->rows[y].hash = front->rows[y + n].hash;
+            front->rows[y].hash_valid = front->rows[y + n].hash_valid;
+        }
+    } else {
+        for (int y = op->bottom; y >= op->top + n; y--) {
+            memcpy(&front->cells[(size_t)y * (size_t)front->width],
+                   &front->cells[(size_t)(y - n) * (size_t)front->width], row_bytes);
+            front->rows[y].hash = front->rows[y - n].hash;
+            front->rows[y].hash_valid = front->rows[y - n].hash_valid;
+        }
     }
 
-    /* Apply foreground color */
-    if (new_style->fg.is_set) {
-        size_t slen;
-        tui_ansi_fg_rgb(buf + len, &slen, new_style->fg.r, new_style->fg.g, new_style->fg.b);
-        len += slen;
+    /* Exposed rows are blank in the default style on the terminal */
+    int exposed_top = op->shift > 0 ? op->bottom - n + 1 : op->top;
+    for (int y = exposed_top; y < exposed_top + n; y++) {
+        tui_cell *row = &front->cells[(size_t)y * (size_t)front->width];
+        for (int x = 0; x < front->width; x++) {
+            row[x].codepoint = ' ';
+            row[x].style = 0;
+            row[x].link = 0;
+        }
+        front->rows[y].hash_valid = 0;
     }
 
-    /* Apply background color */
-    if (new_style->bg.is_set) {
-        size_t slen;
-        tui_ansi_bg_rgb(buf + len, &slen, new_style->bg.r, new_style->bg.g, new_style->bg.b);
-        len += slen;
+    for (int y = op->top; y <= op->bottom; y++) {
+        tui_buffer_mark_row_dirty(buf, y, 0, buf->width - 1);
     }
+}
 
-    return len;
+/* ----------------------------------------------------------------
+ * Cell encoder
+ * ----------------------------------------------------------------
+ * Every cursor jump, run of repeated glyphs and trailing blank run is
+ * encoded with whichever sequence is shortest. Costs are exact byte
+ * counts of what the tui_ansi_* helpers emit.
+ */
+
+typedef struct {
+    tui_output *out;
+    tui_output_queue *q;
+    tui_buffer *buf;
+    int use_rep;          /* Terminal understands REP */
+    int use_links;        /* Terminal understands OSC 8 */
+    int cur_x, cur_y;     /* Terminal cursor, -1 if unknown */
+    uint16_t style;       /* Style id currently active on the terminal */
+    uint16_t link;        /* Link id currently open on the terminal */
+    tui_color_lut *lut;   /* Quantization cache (a private copy per band) */
+    int band;             /* Encoding a band on a worker thread */
+    int failed;           /* Band queue ran out of memory */
+    tui_output_stats *stats;
+} cell_encoder;
+
+/* Upper bound on cells scanned when pricing a gap rewrite */
+#define GAP_REWRITE_MAX 8
+
+static void frame_append(tui_output_queue *q, const char *data, size_t len)
+{
+    if (tui_output_queue_write(q, data, len) < 0) {
+        /* Out of memory: give up on atomicity, not on the bytes */
+        tui_output_queue_flush(q, STDOUT_FILENO);
+        write_all(STDOUT_FILENO, data, len);
+    }
 }
 
-/* Maximum size for a single ANSI escape sequence (generous for RGB colors + attributes) */
-#define ANSI_BUFFER_SIZE 256
+/* Bands can't write through to stdout (they'd overtake earlier rows):
+ * a failed band is dropped and its rows are redrawn next frame */
+static void encode_append(cell_encoder *enc, const char *data, size_t len)
+{
+    if (!enc->band) {
+        frame_append(enc->q, data, len);
+    } else if (!enc->failed && tui_output_queue_write(enc->q, data, len) < 0) {
+        enc->failed = 1;
+    }
+}
 
-void tui_output_render_with_cursor(tui_output *out, tui_buffer *buf, int show_cursor)
+static inline int dec_digits(int n)
 {
-    if (!out || !buf) return;
+    int d = 1;
+    while (n >= 10) {
+        n /= 10;
+        d++;
+    }
+    return d;
+}
 
-    char output[OUTPUT_BUFFER_SIZE];
-    size_t output_len = 0;
-    char ansi[ANSI_BUFFER_SIZE];
-    size_t ansi_len;
+static inline int utf8_len(uint32_t cp)
+{
+    if (cp < 0x80) return 1;
+    if (cp < 0x800) return 2;
+    if (cp < 0x10000) return 3;
+    return 4;
+}
 
-    /* Begin synchronized output (DEC mode 2026) to prevent flicker */
-    tui_ansi_sync_start(ansi, &ansi_len);
-    memcpy(output + output_len, ansi, ansi_len);
-    output_len += ansi_len;
+/* CSI n C / CSI n D / CSI n b (count omitted when 1) */
+static inline int rel_move_cost(int n)
+{
+    return n == 1 ? 3 : 3 + dec_digits(n);
+}
+
+/*
+ * Bytes needed to reach column x by reprinting the unchanged cells the
+ * cursor would pass over, or -1 if that isn't possible (style or link
+ * switch, wide or continuation cells) or costs at least `limit`.
+ */
+static int gap_rewrite_cost(const cell_encoder *enc, const tui_cell *row, int x, int limit)
+{
+    int cost = 0;
 
-    tui_style current_style = {0};
-    int last_x = -1, last_y = -1;
+    if (x - enc->cur_x > GAP_REWRITE_MAX) return -1;
+    for (int i = enc->cur_x; i < x; i++) {
+        if (row[i].codepoint == 0 || row[i].style != enc->style ||
+            (enc->use_links && row[i].link != enc->link) ||
+            tui_cell_is_cluster(&row[i]) || tui_char_width(row[i].codepoint) != 1) {
+            return -1;
+        }
+        cost += utf8_len(row[i].codepoint);
+        if (cost >= limit) return -1;
+    }
+    return cost;
+}
 
-    for (int y = 0; y < buf->height && y < out->front->height; y++) {
-        for (int x = 0; x < buf->width && x < out->front->width; x++) {
-            tui_cell *new_cell = tui_buffer_get_cell(buf, x, y);
-            tui_cell *old_cell = tui_buffer_get_cell(out->front, x, y);
+static void encode_move(cell_encoder *enc, const tui_cell *row, int x, int y)
+{
+    char seq[ANSI_BUFFER_SIZE];
+    size_t len;
 
-            /* Skip continuation cells (part of wide characters) */
-            if (new_cell->codepoint == 0) {
-                continue;
-            }
+    if (enc->cur_y == y && enc->cur_x == x) return;
 
-            /* Skip if unchanged */
-            if (new_cell->codepoint == old_cell->codepoint &&
-                styles_equal(&new_cell->style, &old_cell->style)) {
-                continue;
-            }
+    /* Inline mode has no absolute rows: CNL/CPL (or CR) to column 0 of
+     * the target row, then move along it */
+    if (enc->out->inline_mode && (enc->cur_y != y || enc->cur_x < 0)) {
+        if (enc->cur_y < y) {
+            tui_ansi_cursor_next_line(seq, &len, y - enc->cur_y);
+        } else if (enc->cur_y > y) {
+            tui_ansi_cursor_prev_line(seq, &len, enc->cur_y - y);
+        } else {
+            seq[0] = '\r';
+            len = 1;
+        }
+        encode_append(enc, seq, len);
+        enc->stats->cursor_moves++;
+        enc->cur_x = 0;
+        enc->cur_y = y;
+        if (x == 0) return;
+    }
 
-            /* Move cursor if not sequential */
-            if (x != last_x + 1 || y != last_y) {
-                tui_ansi_cursor_move(ansi, &ansi_len, x, y);
-                /* Flush buffer if it would overflow */
-                if (output_len + ansi_len >= OUTPUT_BUFFER_SIZE) {
-                    write_all(STDOUT_FILENO, output, output_len);
-                    output_len = 0;
-                }
-                memcpy(output + output_len, ansi, ansi_len);
-                output_len += ansi_len;
-            }
+    /* CUP is always available: ESC [ row ; col H */
+    enum { MOVE_CUP, MOVE_CHA, MOVE_CUF, MOVE_CUB, MOVE_REWRITE } how = MOVE_CUP;
+    int best = 4 + dec_digits(y + 1) + dec_digits(x + 1);
 
-            /* Apply style if changed */
-            if (!styles_equal(&new_cell->style, &current_style)) {
-                ansi_len = apply_style_diff(ansi, &current_style, &new_cell->style);
-                /* Flush buffer if it would overflow */
-                if (output_len + ansi_len >= OUTPUT_BUFFER_SIZE) {
-                    write_all(STDOUT_FILENO, output, output_len);
-                    output_len = 0;
-                }
-                memcpy(output + output_len, ansi, ansi_len);
-                output_len += ansi_len;
-                current_style = new_cell->style;
-            }
+    if (enc->cur_y == y && enc->cur_x >= 0) {
+        int cost = 3 + dec_digits(x + 1);
+        if (cost < best) { best = cost; how = MOVE_CHA; }
+
+        if (x > enc->cur_x) {
+            cost = rel_move_cost(x - enc->cur_x);
+            if (cost < best) { best = cost; how = MOVE_CUF; }
 
-            /* Write character with proper UTF-8 encoding */
-            char utf8_buf[4];
-            int utf8_len = tui_utf8_encode(new_cell->codepoint, utf8_buf);
-            /* Flush buffer if it would overflow */
-            if (output_len + (size_t)utf8_len >= OUTPUT_BUFFER_SIZE) {
-                write_all(STDOUT_FILENO, output, output_len);
-                output_len = 0;
+            cost = gap_rewrite_cost(enc, row, x, best);
+            if (cost >= 0) { best = cost; how = MOVE_REWRITE; }
+        } else {
+            cost = rel_move_cost(enc->cur_x - x);
+            if (cost < best) { best = cost; how = MOVE_CUB; }
+        }
+    }
+
+    switch (how) {
+        case MOVE_CHA:
+            tui_ansi_cursor_column(seq, &len, x);
+            break;
+        case MOVE_CUF:
+            tui_ansi_cursor_forward(seq, &len, x - enc->cur_x);
+            break;
+        case MOVE_CUB:
+            tui_ansi_cursor_back(seq, &len, enc->cur_x - x);
+            break;
+        case MOVE_REWRITE:
+            len = 0;
+            for (int i = enc->cur_x; i < x; i++) {
+                len += (size_t)tui_utf8_encode(row[i].codepoint, seq + len);
             }
-            memcpy(output + output_len, utf8_buf, (size_t)utf8_len);
-            output_len += (size_t)utf8_len;
+            break;
+        default:
+            tui_ansi_cursor_move(seq, &len, x, y);
+            break;
+    }
+    encode_append(enc, seq, len);
+    enc->stats->cursor_moves++;
+
+    enc->cur_x = x;
+    enc->cur_y = y;
+}
+
+static void encode_style(cell_encoder *enc, uint16_t style)
+{
+    if (style == enc->style) return;
 
-            /* Update front buffer */
+    char seq[ANSI_BUFFER_SIZE];
+    size_t len = apply_style_diff(enc->out, enc->lut, seq, tui_buffer_style(enc->buf, enc->style),
+                                  tui_buffer_style(enc->buf, style));
+    if (len > 0) {
+        encode_append(enc, seq, len);
+        enc->stats->sgr_sequences++;
+    }
+    enc->style = style;
+}
+
+/*
+ * Open or close an OSC 8 hyperlink. The link stays open across cursor
+ * moves, so a run of linked cells costs one open and one close no
+ * matter how the diff splits it.
+ */
+static void encode_link(cell_encoder *enc, uint16_t link)
+{
+    if (link == enc->link || !enc->use_links) return;
+
+    char seq[ANSI_BUFFER_SIZE];
+    size_t len;
+    if (enc->link != 0) {
+        tui_ansi_hyperlink_end(seq, &len);
+        encode_append(enc, seq, len);
+        enc->stats->link_sequences++;
+    }
+    if (link != 0) {
+        /* URLs can be longer than any fixed sequence buffer */
+        const char *id;
+        const char *url = tui_buffer_link(enc->buf, link, &id);
+        encode_append(enc, "\x1b]8;", 4);
+        if (id) {
+            encode_append(enc, "id=", 3);
+            encode_append(enc, id, strlen(id));
+        }
+        encode_append(enc, ";", 1);
+        encode_append(enc, url, strlen(url));
+        encode_append(enc, "\x1b\\", 2);
+        enc->stats->link_sequences++;
+    }
+    enc->link = link;
+}
+
+/* Erased cells take the current background and no decoration */
+static int style_erasable(const tui_style *style)
+{
+    return !style->bg.is_set && !style->underline &&
+           !style->strikethrough && !style->inverse;
+}
+
+/*
+ * Try to clear the blank run starting at x with EL (run reaches the end
+ * of the line) or ECH (run covers the rest of the changed span).
+ * Returns the last column handled, or -1 if writing the blanks is cheaper.
+ */
+static int encode_blank_run(cell_encoder *enc, const tui_cell *row, int x, int y,
+                            int span_end, int line_end)
+{
+    const tui_cell *cell = &row[x];
+    if (cell->codepoint != ' ' || cell->link != 0 ||
+        !style_erasable(tui_buffer_style(enc->buf, cell->style))) {
+        return -1;
+    }
+
+    int end = x;
+    while (end < line_end && tui_cell_equal(&row[end + 1], cell)) end++;
+    if (end < span_end) return -1;
+
+    int n = end - x + 1;
+    int literal = (enc->use_rep && n > 1) ? 1 + rel_move_cost(n - 1) : n;
+    if (literal > n) literal = n;
+
+    char seq[ANSI_BUFFER_SIZE];
+    size_t len;
+    if (end == line_end) {
+        if (4 >= literal) return -1;    /* CSI 0 K */
+        encode_move(enc, row, x, y);
+        encode_style(enc, cell->style);
+        encode_link(enc, 0);
+        tui_ansi_erase_line_end(seq, &len);
+    } else {
+        if (3 + dec_digits(n) >= literal) return -1;    /* CSI n X */
+        encode_move(enc, row, x, y);
+        encode_style(enc, cell->style);
+        encode_link(enc, 0);
+        tui_ansi_erase_chars(seq, &len, n);
+    }
+    encode_append(enc, seq, len);
+
+    /* EL/ECH leave the cursor where it was */
+    return end;
+}
+
+/*
+ * Write the glyph at x, folding following identical cells into one REP
+ * when that is shorter. Returns the last cell consumed (wide-char
+ * continuations are left to the caller).
+ */
+static int encode_glyph(cell_encoder *enc, const tui_cell *row, int x, int y,
+                        int span_end, int line_width)
+{
+    const tui_cell *cell = &row[x];
+    char seq[ANSI_BUFFER_SIZE];
+    int last = x;
+
+    if (tui_cell_is_cluster(cell)) {
+        /* Clusters are rare enough that folding them into REP isn't worth it */
+        size_t len;
+        int width;
+        const char *bytes = tui_buffer_cluster(enc->buf, cell, &len, &width);
+        encode_append(enc, bytes, len);
+        enc->cur_x = last + width < line_width ? last + width : -1;
+        enc->cur_y = y;
+        return last;
+    }
+
+    int glyph_len = tui_utf8_encode(cell->codepoint, seq);
+    int width = tui_char_width(cell->codepoint);
+
+    encode_append(enc, seq, (size_t)glyph_len);
+
+    if (enc->use_rep && width == 1 && cell->codepoint >= 0x20) {
+        int run = 0;
+        while (x + run + 1 <= span_end && tui_cell_equal(&row[x + run + 1], cell)) run++;
+        if (run > 0 && rel_move_cost(run) < run * glyph_len) {
+            size_t len;
+            tui_ansi_repeat(seq, &len, run);
+            encode_append(enc, seq, len);
+            last = x + run;
+        }
+    }
+
+    /* Writing the last column leaves the cursor in the pending-wrap state;
+     * zero-width glyphs advance differently across terminals */
+    enc->cur_x = (width > 0 && last + width < line_width) ? last + width : -1;
+    enc->cur_y = y;
+    return last;
+}
+
+/*
+ * Diff row y of enc->buf against the front buffer, encode what changed
+ * and copy it into front. Returns 1 if the row was redrawn
+ * unconditionally.
+ */
+static int encode_row(cell_encoder *enc, tui_buffer *front, int y, int cols)
+{
+    tui_buffer *buf = enc->buf;
+
+    /* A dirty front row means the terminal contents are unknown there
+     * (first frame, tui_output_flush): redraw its span unconditionally. */
+    const tui_row_info *front_row = &front->rows[y];
+    int forced = tui_buffer_row_dirty(front, y);
+    tui_cell *new_row = &buf->cells[(size_t)y * (size_t)buf->width];
+    tui_cell *old_row = &front->cells[(size_t)y * (size_t)front->width];
+    int x_start, x_end;
+    int row_cells = 0;
+    int drawn_end = -1;  /* Last cell encoded so far */
+
+    if (forced) {
+        x_start = 0;
+        x_end = cols - 1;
+    } else {
+        /* Nothing written to this row since the last frame */
+        if (!tui_buffer_row_dirty(buf, y)) return 0;
+
+        /* Rewritten with identical content (the common case after a
+         * full clear + repaint); the hash only rules rows out, equal
+         * hashes are confirmed on the cells */
+        if (buf->width == front->width &&
+            tui_buffer_row_hash(buf, y) == tui_buffer_row_hash(front, y) &&
+            rows_equal(buf, y, front, y)) {
+            return 0;
+        }
+
+        /* Cells outside the dirty span still match the front buffer */
+        x_start = buf->rows[y].min_x;
+        x_end = buf->rows[y].max_x < cols - 1 ? buf->rows[y].max_x : cols - 1;
+
+        /* Narrow to the first/last cell that actually differs */
+        x_start = tui_row_diff_first(new_row, old_row, x_start, x_end + 1);
+        if (x_start <= x_end) {
+            x_end = tui_row_diff_last(new_row, old_row, x_start, x_end + 1);
+        }
+    }
+
+    for (int x = x_start; x <= x_end; x++) {
+        /* Jump over unchanged runs */
+        if (!forced && tui_cell_equal(&new_row[x], &old_row[x])) {
+            x = tui_row_diff_first(new_row, old_row, x, x_end + 1);
+            if (x > x_end) break;
+        }
+
+        tui_cell *new_cell = &new_row[x];
+        tui_cell *old_cell = &old_row[x];
+
+        /* Continuation cells (part of wide characters) are drawn by the
+         * lead cell; record them so the front buffer mirrors buf */
+        if (new_cell->codepoint == 0) {
+            /* Where the terminal shows something else, the glyph was
+             * drawn over: forget its lead and go back to draw it */
+            int drawn_over = x > drawn_end + 1 && new_row[x - 1].codepoint != 0 &&
+                             !tui_cell_equal(new_cell, old_cell) &&
+                             tui_cell_equal(&new_row[x - 1], &old_row[x - 1]);
             *old_cell = *new_cell;
+            if (drawn_over) {
+                old_row[x - 1].codepoint = 0;
+                x -= 2;
+            }
+            continue;
+        }
+
+        /* Skip if unchanged */
+        if (!(forced && x >= front_row->min_x && x <= front_row->max_x) &&
+            tui_cell_equal(new_cell, old_cell)) {
+            continue;
+        }
+
+        /* Trailing blanks: erase instead of printing spaces */
+        int last = -1;
+        if (cols == buf->width) {
+            last = encode_blank_run(enc, new_row, x, y, x_end, cols - 1);
+        }
+
+        if (last < 0) {
+            encode_move(enc, new_row, x, y);
+            encode_style(enc, new_cell->style);
+            encode_link(enc, new_cell->link);
+            last = encode_glyph(enc, new_row, x, y, x_end, buf->width);
+        }
+
+        /* Update front buffer for every cell covered */
+        if (last >= cols) last = cols - 1;
+        memcpy(old_cell, new_cell, (size_t)(last - x + 1) * sizeof(tui_cell));
+        row_cells += last - x + 1;
+        x = drawn_end = last;
+    }
+
+    if (row_cells > 0) {
+        enc->stats->cells_changed += row_cells;
+        enc->stats->rows_touched++;
+    }
+
+    /* Front row now mirrors buf row; reuse its hash when available */
+    if (buf->width == front->width && buf->rows[y].hash_valid) {
+        front->rows[y].hash = buf->rows[y].hash;
+        front->rows[y].hash_valid = 1;
+    } else {
+        front->rows[y].hash_valid = 0;
+    }
+
+    return forced;
+}
+
+/* ----------------------------------------------------------------
+ * Banded encoding
+ * ----------------------------------------------------------------
+ * On very large screens the diff itself dominates the frame. The rows
+ * are cut into bands that workers encode into private queues, each
+ * starting from an unknown cursor, default style and no open link, and
+ * ending back at default style with its link closed. Joined in row
+ * order the queues read like one serial pass, at the price of one CUP
+ * and possibly one SGR per band boundary. Bands only touch their own
+ * rows of buf and front, so they need no locking.
+ */
+
+/* Changed cells below which a frame isn't worth the handoff */
+#define BAND_MIN_CELLS 32768
+
+/* Smallest band, in rows */
+#define BAND_MIN_ROWS 8
+
+/* Bands per thread, so one band full of changes doesn't stall the rest */
+#define BANDS_PER_THREAD 2
+
+typedef struct tui_output_band {
+    tui_output *out;
+    tui_buffer *buf;
+    int y_start, y_end;     /* Rows [y_start, y_end) */
+    int cols;
+    tui_output_queue queue; /* Bytes of this band, joined after the batch */
+    tui_output_stats stats;
+    tui_color_lut lut;      /* Copy of out->color_lut, warm from earlier frames */
+    int forced_rows;
+    int failed;
+} tui_output_band;
+
+static void encode_band(void *arg)
+{
+    tui_output_band *band = arg;
+    tui_output *out = band->out;
+
+    memset(&band->stats, 0, sizeof(band->stats));
+    band->forced_rows = 0;
+
+    cell_encoder enc = {
+        .out = out,
+        .q = &band->queue,
+        .buf = band->buf,
+        .use_rep = (out->capabilities & TUI_CAP_REP) != 0,
+        .use_links = (out->capabilities & TUI_CAP_HYPERLINKS_OSC8) != 0,
+        .cur_x = -1,
+        .cur_y = -1,
+        .style = 0,
+        .lut = &band->lut,
+        .band = 1,
+        .stats = &band->stats
+    };
+
+    for (int y = band->y_start; y < band->y_end; y++) {
+        band->forced_rows += encode_row(&enc, out->front, y, band->cols);
+    }
 
-            /* Track cursor position accounting for wide chars */
-            int char_width = tui_char_width(new_cell->codepoint);
-            last_x = x + char_width - 1;
-            last_y = y;
+    /* The next band starts from the defaults */
+    encode_link(&enc, 0);
+    encode_style(&enc, 0);
+    band->failed = enc.failed;
+}
+
+void tui_output_set_encode_threads(tui_output *out, int threads)
+{
+    if (!out) return;
+    if (threads < 2) threads = 0;
+    if (threads > TUI_WORKERS_MAX) threads = TUI_WORKERS_MAX;
+    if (threads == out->encode_threads) return;
+
+    tui_worker_pool_destroy(out->workers);
+    out->workers = NULL;
+    for (int i = 0; i < out->band_count; i++) {
+        tui_output_queue_free(&out->bands[i].queue);
+    }
+    free(out->bands);
+    out->bands = NULL;
+    out->band_count = 0;
+    out->encode_threads = threads;
+}
+
+void tui_output_set_sink(tui_output *out, tui_output_sink sink, void *ctx)
+{
+    if (!out) return;
+
+    out->sink = sink;
+    out->sink_ctx = ctx;
+}
+
+/*
+ * Encode rows [0, rows) in bands on the worker pool. Returns the number
+ * of rows redrawn unconditionally, or -1 if the frame is too small to
+ * be worth it (nothing was written).
+ */
+static int render_bands(tui_output *out, tui_buffer *buf, int rows, int cols)
+{
+    tui_buffer *front = out->front;
+
+    /* Estimate the work from the dirty spans */
+    size_t cells = 0;
+    for (int y = 0; y < rows; y++) {
+        if (tui_buffer_row_dirty(front, y)) {
+            cells += (size_t)cols;
+        } else if (tui_buffer_row_dirty(buf, y) && buf->rows[y].max_x >= buf->rows[y].min_x) {
+            cells += (size_t)(buf->rows[y].max_x - buf->rows[y].min_x + 1);
+        }
+    }
+    if (cells < BAND_MIN_CELLS) return -1;
+
+    if (!out->workers) {
+        out->workers = tui_worker_pool_create(out->encode_threads);
+        if (!out->workers) {
+            /* No threads to be had: stay serial from now on */
+            out->encode_threads = 0;
+            return -1;
         }
     }
+    if (!out->bands) {
+        int count = tui_worker_pool_threads(out->workers) * BANDS_PER_THREAD;
+        out->bands = calloc((size_t)count, sizeof(tui_output_band));
+        if (!out->bands) return -1;
+        for (int i = 0; i < count; i++) {
+            tui_output_queue_init(&out->bands[i].queue);
+        }
+        out->band_count = count;
+    }
+
+    int count = out->band_count;
+    if (count > rows / BAND_MIN_ROWS) count = rows / BAND_MIN_ROWS;
+    if (count < 2) return -1;
+
+    void *args[TUI_WORKERS_MAX * BANDS_PER_THREAD];
+    for (int i = 0; i < count; i++) {
+        tui_output_band *band = &out->bands[i];
+        band->out = out;
+        band->buf = buf;
+        band->y_start = (int)((long)rows * i / count);
+        band->y_end = (int)((long)rows * (i + 1) / count);
+        band->cols = cols;
+        band->lut = out->color_lut;
+        args[i] = band;
+    }
+
+    tui_worker_pool_run(out->workers, encode_band, args, count);
+
+    int forced_rows = 0;
+    for (int i = 0; i < count; i++) {
+        tui_output_band *band = &out->bands[i];
+        if (band->failed || tui_output_queue_append(&out->queue, &band->queue) < 0) {
+            /* Drop the band (flushing to fd -1 just empties it); its
+             * rows are redrawn next frame */
+            tui_output_queue_flush(&band->queue, -1);
+            band->failed = 1;
+            continue;
+        }
+        out->stats.cells_changed += band->stats.cells_changed;
+        out->stats.rows_touched += band->stats.rows_touched;
+        out->stats.cursor_moves += band->stats.cursor_moves;
+        out->stats.sgr_sequences += band->stats.sgr_sequences;
+        out->stats.link_sequences += band->stats.link_sequences;
+        forced_rows += band->forced_rows;
+    }
+    return forced_rows;
+}
+
+/* After the buffers are marked clean: rows of dropped bands are unknown
+ * on the terminal */
+static void render_bands_finish(tui_output *out, int rows)
+{
+    int count = out->band_count;
+    if (count > rows / BAND_MIN_ROWS) count = rows / BAND_MIN_ROWS;
+
+    for (int i = 0; i < count; i++) {
+        tui_output_band *band = &out->bands[i];
+        if (!band->failed) continue;
+        for (int y = band->y_start; y < band->y_end; y++) {
+            tui_buffer_mark_row_dirty(out->front, y, 0, out->front->width - 1);
+        }
+        band->failed = 0;
+    }
+}
+
+/* Diff the first max_rows rows of buf against the front buffer and
+ * queue whatever brings the terminal up to date */
+static void render_rows(tui_output *out, tui_buffer *buf, int max_rows, int show_cursor)
+{
+    char ansi[ANSI_BUFFER_SIZE];
+    size_t ansi_len;
+
+    /* Standalone renders are a frame of their own */
+    int own_frame = !out->frame_open;
+    if (own_frame) tui_output_begin_frame(out);
+
+    tui_output_queue *output = &out->queue;
+
+    tui_buffer *front = out->front;
+
+    /* Front must use buf's style table so cells compare as plain ids */
+    tui_buffer_share_styles(front, buf);
+
+    cell_encoder enc = {
+        .out = out,
+        .q = output,
+        .buf = buf,
+        .use_rep = (out->capabilities & TUI_CAP_REP) != 0,
+        .use_links = (out->capabilities & TUI_CAP_HYPERLINKS_OSC8) != 0,
+        .cur_x = -1,
+        .cur_y = out->inline_mode ? out->inline_cursor_y : -1,
+        .style = 0,
+        .lut = &out->color_lut,
+        .stats = &out->stats
+    };
+    int forced_rows = -1;
+
+    int cols = buf->width < front->width ? buf->width : front->width;
+    int rows = buf->height < front->height ? buf->height : front->height;
+    if (rows > max_rows) rows = max_rows;
+
+    /* Shift scrolled bands on the terminal first; style is still default
+     * here, so exposed rows are cleared to the default background.
+     * DECSTBM takes absolute rows, which inline mode doesn't know. */
+    scroll_op scroll;
+    if (!out->inline_mode && detect_scroll(buf, front, rows, &scroll)) {
+        int n = scroll.shift > 0 ? scroll.shift : -scroll.shift;
+        size_t slen;
+
+        tui_ansi_set_scroll_region(ansi, &ansi_len, scroll.top, scroll.bottom);
+        if (scroll.shift > 0) {
+            tui_ansi_scroll_up(ansi + ansi_len, &slen, n);
+        } else {
+            tui_ansi_scroll_down(ansi + ansi_len, &slen, n);
+        }
+        ansi_len += slen;
+        tui_ansi_reset_scroll_region(ansi + ansi_len, &slen);
+        ansi_len += slen;
+        frame_append(output, ansi, ansi_len);
+
+        scroll_front(front, buf, &scroll);
+    }
+
+    /* Band workers start from an unknown cursor, which inline mode can't
+     * address */
+    int banded = 0;
+    if (out->encode_threads >= 2 && !out->inline_mode) {
+        forced_rows = render_bands(out, buf, rows, cols);
+        banded = forced_rows >= 0;
+    }
+
+    if (!banded) {
+        forced_rows = 0;
+        for (int y = 0; y < rows; y++) {
+            forced_rows += encode_row(&enc, front, y, cols);
+        }
+    }
+
+    if (rows > 0 && forced_rows == rows) {
+        out->stats.full_redraw = 1;
+    }
+
+    /* Both buffers are in sync with the terminal now */
+    tui_buffer_mark_clean(buf);
+    tui_buffer_mark_clean(front);
+    if (banded) render_bands_finish(out, rows);
+
+    /* Never leave a link open outside the frame */
+    encode_link(&enc, 0);
 
     /* Reset style at end */
     tui_ansi_reset(ansi, &ansi_len);
-    if (output_len + ansi_len >= OUTPUT_BUFFER_SIZE) {
-        write_all(STDOUT_FILENO, output, output_len);
-        output_len = 0;
-    }
-    memcpy(output + output_len, ansi, ansi_len);
-    output_len += ansi_len;
+    frame_append(output, ansi, ansi_len);
+    out->stats.sgr_sequences++;
 
     /* Show or hide cursor based on focused element's showCursor property.
      * This is inside the sync block so it happens atomically with the render. */
@@ -329,26 +1228,260 @@ void tui_output_render_with_cursor(tui_output *out, tui_buffer *buf, int show_cu
     } else {
         tui_ansi_cursor_hide(ansi, &ansi_len);
     }
-    if (output_len + ansi_len >= OUTPUT_BUFFER_SIZE) {
-        write_all(STDOUT_FILENO, output, output_len);
-        output_len = 0;
+    frame_append(output, ansi, ansi_len);
+
+    if (out->inline_mode && enc.cur_y >= 0) {
+        out->inline_cursor_y = enc.cur_y;
     }
-    memcpy(output + output_len, ansi, ansi_len);
-    output_len += ansi_len;
+
+    if (own_frame) tui_output_end_frame(out);
+}
+
+void tui_output_render_with_cursor(tui_output *out, tui_buffer *buf, int show_cursor)
+{
+    if (!out || !buf) return;
+    render_rows(out, buf, buf->height, show_cursor);
+}
+
+/* ----------------------------------------------------------------
+ * Inline mode
+ * ----------------------------------------------------------------
+ * The UI is a live region starting at the line the cursor was on when
+ * the app started. Where that is on screen is unknown (and changes as
+ * the terminal scrolls), so rows are addressed relative to the top of
+ * the region and the region grows by printing newlines at its bottom.
+ * Static output is printed above the region and scrolls away with the
+ * rest of the terminal; it is never redrawn.
+ */
+
+void tui_output_set_inline(tui_output *out, int enabled)
+{
+    if (!out) return;
+
+    out->inline_mode = enabled ? 1 : 0;
+    out->inline_rows = 0;
+    out->inline_cursor_y = 0;
+}
+
+/* Move to column 0 of a row of the live region */
+static void inline_move_to_row(tui_output *out, int row)
+{
+    char seq[ANSI_BUFFER_SIZE];
+    size_t len;
+
+    if (row > out->inline_cursor_y) {
+        tui_ansi_cursor_next_line(seq, &len, row - out->inline_cursor_y);
+    } else if (row < out->inline_cursor_y) {
+        tui_ansi_cursor_prev_line(seq, &len, out->inline_cursor_y - row);
+    } else {
+        seq[0] = '\r';
+        len = 1;
+    }
+    frame_append(&out->queue, seq, len);
+    out->stats.cursor_moves++;
+    out->inline_cursor_y = row;
+}
+
+/* Make the live region `rows` lines tall. The line the region started on
+ * always belongs to it, even while nothing is drawn there. */
+static void inline_set_rows(tui_output *out, int rows)
+{
+    char seq[ANSI_BUFFER_SIZE];
+    size_t len;
+    int have = out->inline_rows > 0 ? out->inline_rows : 1;
+
+    if (rows > have) {
+        /* Newlines at the bottom scroll the terminal when it is full */
+        if (out->inline_cursor_y != have - 1) inline_move_to_row(out, have - 1);
+        for (int y = have; y < rows; y++) {
+            frame_append(&out->queue, "\r\n", 2);
+        }
+        out->inline_cursor_y = rows - 1;
+    } else if (rows < out->inline_rows) {
+        inline_move_to_row(out, rows);
+        tui_ansi_erase_screen_end(seq, &len);
+        frame_append(&out->queue, seq, len);
+    }
+
+    /* Lines joining the region hold whatever the terminal had there */
+    for (int y = out->inline_rows; y < rows && y < out->front->height; y++) {
+        tui_buffer_mark_row_dirty(out->front, y, 0, out->front->width - 1);
+    }
+    out->inline_rows = rows;
+}
+
+void tui_output_render_inline(tui_output *out, tui_buffer *buf, int rows, int show_cursor)
+{
+    if (!out || !buf) return;
+
+    if (rows < 0) rows = 0;
+    if (rows > buf->height) rows = buf->height;
+    if (rows > out->front->height) rows = out->front->height;
+
+    int own_frame = !out->frame_open;
+    if (own_frame) tui_output_begin_frame(out);
+
+    inline_set_rows(out, rows);
+    render_rows(out, buf, rows, show_cursor);
+
+    if (own_frame) tui_output_end_frame(out);
+}
+
+void tui_output_inline_print(tui_output *out, tui_buffer *buf, int rows)
+{
+    if (!out || !buf || rows <= 0) return;
+
+    char seq[ANSI_BUFFER_SIZE];
+    size_t len;
+
+    int own_frame = !out->frame_open;
+    if (own_frame) tui_output_begin_frame(out);
+
+    /* The lines take the region's place; it is drawn again below them */
+    inline_move_to_row(out, 0);
+    if (out->inline_rows > 0) {
+        tui_ansi_erase_screen_end(seq, &len);
+        frame_append(&out->queue, seq, len);
+        out->inline_rows = 0;
+    }
+
+    cell_encoder enc = {
+        .out = out,
+        .q = &out->queue,
+        .buf = buf,
+        .use_rep = (out->capabilities & TUI_CAP_REP) != 0,
+        .use_links = (out->capabilities & TUI_CAP_HYPERLINKS_OSC8) != 0,
+        .cur_x = 0,
+        .cur_y = 0,
+        .style = 0,
+        .lut = &out->color_lut,
+        .stats = &out->stats
+    };
+
+    if (rows > buf->height) rows = buf->height;
+    for (int y = 0; y < rows; y++) {
+        const tui_cell *row = &buf->cells[(size_t)y * (size_t)buf->width];
+
+        /* Trailing default blanks are left to the newline */
+        int end = buf->width - 1;
+        while (end >= 0 && row[end].codepoint == ' ' && row[end].style == 0) end--;
+
+        for (int x = 0; x <= end; x++) {
+            if (row[x].codepoint == 0) continue;
+            encode_style(&enc, row[x].style);
+            encode_link(&enc, row[x].link);
+            int last = encode_glyph(&enc, row, x, 0, end, buf->width);
+            out->stats.cells_changed += last - x + 1;
+            x = last;
+        }
+
+        /* Back to the default style first: a scrolling newline fills the
+         * new line with the current background */
+        encode_style(&enc, 0);
+        encode_link(&enc, 0);
+        frame_append(&out->queue, "\r\n", 2);
+        if (end >= 0) out->stats.rows_touched++;
+    }
+
+    out->inline_cursor_y = 0;
+    if (own_frame) tui_output_end_frame(out);
+}
+
+void tui_output_inline_reset(tui_output *out)
+{
+    if (!out || !out->inline_mode) return;
+
+    char seq[ANSI_BUFFER_SIZE];
+    size_t len;
+
+    int own_frame = !out->frame_open;
+    if (own_frame) tui_output_begin_frame(out);
+
+    inline_move_to_row(out, 0);
+    tui_ansi_erase_screen_end(seq, &len);
+    frame_append(&out->queue, seq, len);
+    out->inline_rows = 0;
+
+    if (own_frame) tui_output_end_frame(out);
+}
+
+void tui_output_inline_finish(tui_output *out)
+{
+    if (!out || !out->inline_mode) return;
+
+    int own_frame = !out->frame_open;
+    if (own_frame) tui_output_begin_frame(out);
+
+    inline_move_to_row(out, out->inline_rows > 0 ? out->inline_rows - 1 : 0);
+
+    if (own_frame) tui_output_end_frame(out);
+}
+
+/* Add a finished frame's cost to the running totals and keep it as the
+ * most recent frame. Bytes and syscalls were counted as they were made. */
+static void output_publish_stats(const tui_output_stats *stats)
+{
+    if (!TUI_G(metrics_enabled)) return;
+
+    TUI_METRIC_ADD(cells_changed, stats->cells_changed);
+    TUI_METRIC_ADD(rows_touched, stats->rows_touched);
+    TUI_METRIC_ADD(cursor_moves, stats->cursor_moves);
+    TUI_METRIC_ADD(sgr_sequences, stats->sgr_sequences);
+    TUI_METRIC_ADD(link_sequences, stats->link_sequences);
+    TUI_METRIC_ADD(full_redraws, stats->full_redraw);
+
+    TUI_METRIC_SET(frame_bytes, TUI_G(metrics).output_bytes - stats->bytes_start);
+    TUI_METRIC_SET(frame_writes, TUI_G(metrics).output_writes - stats->writes_start);
+    TUI_METRIC_SET(frame_cells_changed, stats->cells_changed);
+    TUI_METRIC_SET(frame_rows_touched, stats->rows_touched);
+    TUI_METRIC_SET(frame_cursor_moves, stats->cursor_moves);
+    TUI_METRIC_SET(frame_sgr_sequences, stats->sgr_sequences);
+    TUI_METRIC_SET(frame_link_sequences, stats->link_sequences);
+    TUI_METRIC_SET(frame_full_redraw, stats->full_redraw);
+}
+
+void tui_output_begin_frame(tui_output *out)
+{
+    if (!out || out->frame_open) return;
+
+    out->frame_open = 1;
+    out->prev_queue = tui_output_queue_activate(&out->queue);
+
+    memset(&out->stats, 0, sizeof(out->stats));
+    out->stats.bytes_start = TUI_G(metrics).output_bytes;
+    out->stats.writes_start = TUI_G(metrics).output_writes;
+
+    /* Begin synchronized output (DEC mode 2026) to prevent flicker */
+    char ansi[ANSI_BUFFER_SIZE];
+    size_t ansi_len;
+    tui_ansi_sync_start(ansi, &ansi_len);
+    frame_append(&out->queue, ansi, ansi_len);
+}
+
+void tui_output_end_frame(tui_output *out)
+{
+    if (!out || !out->frame_open) return;
 
     /* End synchronized output (DEC mode 2026) - terminal renders atomically */
+    char ansi[ANSI_BUFFER_SIZE];
+    size_t ansi_len;
     tui_ansi_sync_end(ansi, &ansi_len);
-    if (output_len + ansi_len >= OUTPUT_BUFFER_SIZE) {
-        write_all(STDOUT_FILENO, output, output_len);
-        output_len = 0;
-    }
-    memcpy(output + output_len, ansi, ansi_len);
-    output_len += ansi_len;
+    frame_append(&out->queue, ansi, ansi_len);
 
-    /* Write all output at once */
-    if (output_len > 0) {
-        write_all(STDOUT_FILENO, output, output_len);
+    tui_output_queue_activate(out->prev_queue);
+    out->prev_queue = NULL;
+    out->frame_open = 0;
+
+    /* The whole frame in one syscall (batched by IOV_MAX) */
+    if (out->sink) {
+        if (tui_output_queue_drain(&out->queue, out->sink, out->sink_ctx) < 0) {
+            TUI_DEBUG_PRINT("output sink stopped\n");
+        }
+    } else if (tui_output_queue_flush(&out->queue, STDOUT_FILENO) < 0) {
+        TUI_DEBUG_PRINT("output queue flush failed: errno=%d\n", errno);
     }
+
+    output_publish_stats(&out->stats);
 }
 
 void tui_output_render(tui_output *out, tui_buffer *buf)
@@ -359,12 +1492,136 @@ void tui_output_render(tui_output *out, tui_buffer *buf)
 
 void tui_output_flush(tui_output *out)
 {
-    /* Force full redraw */
+    /* Force full redraw: dirty front rows are redrawn unconditionally */
     if (out && out->front) {
         tui_buffer_mark_all_dirty(out->front);
     }
 }
 
+/* ----------------------------------------------------------------
+ * Serialization
+ * ---------------------------------------------------------------- */
+
+/* Bytes staged before each sink call */
+#define SERIALIZE_CHUNK 4096
+
+typedef struct {
+    tui_output_sink sink;
+    void *ctx;
+    int failed;
+    size_t len;
+    char chunk[SERIALIZE_CHUNK];
+} serializer;
+
+static void serializer_flush(serializer *s)
+{
+    if (s->len > 0 && !s->failed && s->sink(s->ctx, s->chunk, s->len) != 0) {
+        s->failed = 1;
+    }
+    s->len = 0;
+}
+
+static void serializer_append(serializer *s, const char *data, size_t len)
+{
+    if (s->len + len > SERIALIZE_CHUNK) {
+        serializer_flush(s);
+        if (len > SERIALIZE_CHUNK) {
+            if (!s->failed && s->sink(s->ctx, data, len) != 0) s->failed = 1;
+            return;
+        }
+    }
+    memcpy(s->chunk + s->len, data, len);
+    s->len += len;
+}
+
+int tui_output_serialize(tui_output *out, const tui_buffer *buf, tui_output_sink sink, void *ctx)
+{
+    if (!buf || !buf->cells || !sink) return -1;
+
+    /* Offline: full color, nothing to quantize */
+    tui_output offline;
+    if (!out) {
+        memset(&offline, 0, sizeof(offline));
+        offline.color_depth = 16777216;
+        offline.capabilities = TUI_CAP_HYPERLINKS_OSC8;
+        out = &offline;
+    }
+    int use_links = (out->capabilities & TUI_CAP_HYPERLINKS_OSC8) != 0;
+
+    serializer stream = { .sink = sink, .ctx = ctx };
+    serializer *s = &stream;
+
+    char seq[ANSI_BUFFER_SIZE];
+    size_t len;
+    uint16_t style = 0;
+    uint16_t link = 0;
+
+    for (int y = 0; y < buf->height && !s->failed; y++) {
+        const tui_cell *row = &buf->cells[(size_t)y * (size_t)buf->width];
+
+        for (int x = 0; x < buf->width; x++) {
+            const tui_cell *cell = &row[x];
+
+            /* Continuation cells are covered by their wide character */
+            if (cell->codepoint == 0) continue;
+
+            if (cell->style != style) {
+                len = apply_style_diff(out, &out->color_lut, seq, tui_buffer_style(buf, style),
+                                       tui_buffer_style(buf, cell->style));
+                serializer_append(s, seq, len);
+                style = cell->style;
+            }
+
+            if (use_links && cell->link != link) {
+                if (link != 0) {
+                    tui_ansi_hyperlink_end(seq, &len);
+                    serializer_append(s, seq, len);
+                }
+                if (cell->link != 0) {
+                    const char *id;
+                    const char *url = tui_buffer_link(buf, cell->link, &id);
+                    serializer_append(s, "\x1b]8;", 4);
+                    if (id) {
+                        serializer_append(s, "id=", 3);
+                        serializer_append(s, id, strlen(id));
+                    }
+                    serializer_append(s, ";", 1);
+                    serializer_append(s, url, strlen(url));
+                    serializer_append(s, "\x1b\\", 2);
+                }
+                link = cell->link;
+            }
+
+            if (tui_cell_is_cluster(cell)) {
+                const char *bytes = tui_buffer_cluster(buf, cell, &len, NULL);
+                serializer_append(s, bytes, len);
+            } else if (cell->codepoint != TUI_CELL_TRANSPARENT) {
+                len = (size_t)tui_utf8_encode(cell->codepoint, seq);
+                serializer_append(s, seq, len);
+            } else {
+                serializer_append(s, " ", 1);
+            }
+        }
+
+        /* Nothing carries over the newline */
+        if (link != 0) {
+            tui_ansi_hyperlink_end(seq, &len);
+            serializer_append(s, seq, len);
+            link = 0;
+        }
+        if (style != 0) {
+            len = apply_style_diff(out, &out->color_lut, seq, tui_buffer_style(buf, style),
+                                   tui_buffer_style(buf, 0));
+            serializer_append(s, seq, len);
+            style = 0;
+        }
+        if (y < buf->height - 1) serializer_append(s, "\n", 1);
+    }
+
+    serializer_flush(s);
+    return s->failed ? -1 : 0;
+}
+
 void tui_output_show_cursor(tui_output *out)
 {
     if (!out) return;
@@ -372,7 +1629,7 @@ void tui_output_show_cursor(tui_output *out)
     char buf[32];
     size_t len;
     tui_ansi_cursor_show(buf, &len);
-    write_all(STDOUT_FILENO, buf, len);
+    tui_output_write(buf, len);
     out->cursor_visible = 1;
 }
 
@@ -383,7 +1640,7 @@ void tui_output_hide_cursor(tui_output *out)
     char buf[32];
     size_t len;
     tui_ansi_cursor_hide(buf, &len);
-    write_all(STDOUT_FILENO, buf, len);
+    tui_output_write(buf, len);
     out->cursor_visible = 0;
 }
 
@@ -394,7 +1651,7 @@ void tui_output_move_cursor(tui_output *out, int x, int y)
     char buf[32];
     size_t len;
     tui_ansi_cursor_move(buf, &len, x, y);
-    write_all(STDOUT_FILENO, buf, len);
+    tui_output_write(buf, len);
     out->cursor_x = x;
     out->cursor_y = y;
 }
@@ -7,7 +7,8 @@
   | and cursor visibility.                                              |
   |                                                                      |
   | Thread Safety: NOT thread-safe. All calls must be from the same     |
-  | thread that created the output instance.                            |
+  | thread that created the output instance. Band workers it starts     |
+  | itself only touch their own rows and queues.                        |
   +----------------------------------------------------------------------+
 */
 
@@ -15,6 +16,8 @@
 #define TUI_OUTPUT_H
 
 #include "buffer.h"
+#include "queue.h"
+#include "workers.h"
 
 /* Output modes */
 typedef enum {
@@ -22,6 +25,28 @@ typedef enum {
     TUI_OUTPUT_ALTERNATE    /* Alternate screen buffer */
 } tui_output_mode;
 
+/* Direct-mapped cache of RGB -> palette index for 256/16-color output */
+#define TUI_COLOR_LUT_SIZE 256
+#define TUI_COLOR_LUT_VALID 0x1000000u
+
+typedef struct {
+    uint32_t rgb[TUI_COLOR_LUT_SIZE];   /* Cached color | TUI_COLOR_LUT_VALID */
+    uint8_t index[TUI_COLOR_LUT_SIZE];  /* Palette index for that color */
+} tui_color_lut;
+
+/* Output cost of the frame in progress, published to the metrics when
+ * the frame ends */
+typedef struct {
+    int cells_changed;      /* Cells emitted (glyphs, repeats, erases) */
+    int rows_touched;       /* Rows with at least one emitted cell */
+    int cursor_moves;       /* Cursor movement sequences */
+    int sgr_sequences;      /* SGR (style) sequences */
+    int link_sequences;     /* OSC 8 hyperlink opens and closes */
+    int full_redraw;        /* Every row was repainted unconditionally */
+    int64_t bytes_start;    /* output_bytes total when the frame opened */
+    int64_t writes_start;   /* output_writes total when the frame opened */
+} tui_output_stats;
+
 /* Renderer state (double-buffered) */
 typedef struct {
     tui_buffer *front;      /* Current display (what user sees) */
@@ -30,6 +55,22 @@ typedef struct {
     int cursor_x;           /* Cursor X position */
     int cursor_y;           /* Cursor Y position */
     int cursor_visible;     /* Whether cursor is visible */
+    unsigned int capabilities; /* TUI_CAP_* flags the encoder may rely on */
+    int color_depth;        /* Colors emitted: 16777216, 256, 16, 8 or 0 (none) */
+    tui_color_lut color_lut;/* Quantization cache when color_depth < 16777216 */
+    tui_output_queue queue; /* Bytes of the frame in progress */
+    int frame_open;         /* 1 between begin_frame and end_frame */
+    tui_output_queue *prev_queue; /* Active queue before this frame opened */
+    tui_output_stats stats; /* Cost of the frame in progress */
+    int inline_mode;        /* Live region below the prompt, no alternate screen */
+    int inline_rows;        /* Rows the live region occupies on the terminal */
+    int inline_cursor_y;    /* Cursor row relative to the top of the live region */
+    int encode_threads;     /* Threads encoding row bands, 0 = serial */
+    tui_worker_pool *workers; /* Started on the first banded frame */
+    struct tui_output_band *bands; /* Per-band queue, stats and color cache */
+    int band_count;
+    tui_output_sink sink;   /* Receives finished frames instead of stdout */
+    void *sink_ctx;
 } tui_output;
 
 /* ----------------------------------------------------------------
@@ -67,13 +108,43 @@ void tui_output_enter_alternate(tui_output *out);
  */
 void tui_output_exit_alternate(tui_output *out);
 
+/**
+ * Switch to inline mode: instead of owning the screen, the output draws a
+ * live region starting at the cursor's line and addresses its rows
+ * relative to that line. Use instead of tui_output_enter_alternate().
+ * @param out     Output instance
+ * @param enabled 1 for inline mode, 0 for absolute positioning
+ */
+void tui_output_set_inline(tui_output *out, int enabled);
+
+/**
+ * Encode large frames in parallel: the rows are split into bands, each
+ * band is diffed and encoded into its own queue on a worker thread, and
+ * the queues are joined in row order. Only frames with enough changed
+ * cells take this path; inline mode is always serial.
+ * @param out     Output instance
+ * @param threads Threads per frame including the caller (0 or 1 = serial,
+ *                at most TUI_WORKERS_MAX)
+ */
+void tui_output_set_encode_threads(tui_output *out, int threads);
+
+/**
+ * Send finished frames to sink instead of writing them to stdout, e.g.
+ * to capture exactly what a terminal would receive.
+ * @param out  Output instance
+ * @param sink Receives each frame's bytes when it ends (NULL = stdout)
+ * @param ctx  Passed to sink
+ */
+void tui_output_set_sink(tui_output *out, tui_output_sink sink, void *ctx);
+
 /* ----------------------------------------------------------------
  * Rendering
  * ---------------------------------------------------------------- */
 
 /**
  * Render buffer to terminal with differential updates.
- * Only changed cells are written for efficiency.
+ * Only changed cells are written for efficiency. Inside an open frame the
+ * bytes are queued; otherwise the render is its own frame.
  * @param out Output instance
  * @param buf Buffer to render
  */
@@ -87,12 +158,81 @@ void tui_output_render(tui_output *out, tui_buffer *buf);
  */
 void tui_output_render_with_cursor(tui_output *out, tui_buffer *buf, int show_cursor);
 
+/**
+ * Inline mode: resize the live region to the first `rows` rows of buf and
+ * redraw the lines that changed. Growing the region scrolls the terminal
+ * as needed; shrinking it erases the rows given up.
+ * @param out Output instance
+ * @param buf Buffer to render (rows beyond `rows` are ignored)
+ * @param rows Height of the live region, at most the terminal height
+ * @param show_cursor Whether to show cursor after render
+ */
+void tui_output_render_inline(tui_output *out, tui_buffer *buf, int rows, int show_cursor);
+
+/**
+ * Inline mode: print rows of buf once, above the live region. They scroll
+ * into the terminal's scrollback and are never redrawn; the live region
+ * is repainted below them by the next render.
+ * @param out Output instance
+ * @param buf Lines to print
+ * @param rows Number of rows of buf to print
+ */
+void tui_output_inline_print(tui_output *out, tui_buffer *buf, int rows);
+
+/**
+ * Inline mode: forget what the live region showed (e.g. after the terminal
+ * reflowed it on resize). Erases it; the next render draws it afresh.
+ * @param out Output instance
+ */
+void tui_output_inline_reset(tui_output *out);
+
+/**
+ * Inline mode: leave the last frame on screen and put the cursor on the
+ * region's bottom line so whatever follows is printed below it.
+ * @param out Output instance
+ */
+void tui_output_inline_finish(tui_output *out);
+
+/**
+ * Open a frame: until tui_output_end_frame(), everything written through
+ * the output queue (cell diff, images, OSC sequences) is collected and
+ * then written with one writev() inside a synchronized-output block.
+ * No-op if a frame is already open.
+ * @param out Output instance
+ */
+void tui_output_begin_frame(tui_output *out);
+
+/**
+ * Close the frame opened by tui_output_begin_frame() and write it out.
+ * No-op if no frame is open.
+ * @param out Output instance
+ */
+void tui_output_end_frame(tui_output *out);
+
 /**
  * Flush any pending output to terminal.
  * @param out Output instance
  */
 void tui_output_flush(tui_output *out);
 
+/* ----------------------------------------------------------------
+ * Serialization
+ * ---------------------------------------------------------------- */
+
+/**
+ * Serialize a whole buffer as ANSI text, rows separated by newlines, for
+ * snapshots and offline rendering. Uses the same minimal SGR transitions
+ * as the live output and streams through a small staging chunk, so memory
+ * use doesn't depend on the buffer size.
+ * @param out  Output whose color depth and capabilities to honor
+ *             (NULL = truecolor with hyperlinks)
+ * @param buf  Buffer to serialize
+ * @param sink Receives the bytes in order
+ * @param ctx  Passed to sink
+ * @return 0 on success, -1 if the sink stopped or arguments are invalid
+ */
+int tui_output_serialize(tui_output *out, const tui_buffer *buf, tui_output_sink sink, void *ctx);
+
 /* ----------------------------------------------------------------
  * Cursor control
  * ---------------------------------------------------------------- */
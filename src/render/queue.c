@@ -0,0 +1,319 @@
+/*
+  +----------------------------------------------------------------------+
+  | ext-tui: Terminal output queue                                      |
+  +----------------------------------------------------------------------+
+*/
+
+#include "queue.h"
+#include "output.h"
+#include "php.h"
+#include "php_tui.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <limits.h>
+#include <sys/uio.h>
+
+#define QUEUE_INITIAL_SEGMENTS 64
+#define QUEUE_INITIAL_ARENA 16384
+
+/* Arenas grown past this by one huge frame are released after the flush */
+#define QUEUE_ARENA_KEEP (1024 * 1024)
+
+/* iovecs handed to one writev() call (kept on the stack) */
+#if defined(IOV_MAX) && IOV_MAX < 128
+# define QUEUE_IOV_BATCH IOV_MAX
+#else
+# define QUEUE_IOV_BATCH 128
+#endif
+
+void tui_output_queue_init(tui_output_queue *q)
+{
+    memset(q, 0, sizeof(*q));
+}
+
+static void release_owned(tui_output_queue *q)
+{
+    for (int i = 0; i < q->owned_count; i++) {
+        free(q->owned[i]);
+    }
+    q->owned_count = 0;
+}
+
+void tui_output_queue_free(tui_output_queue *q)
+{
+    if (!q) return;
+    release_owned(q);
+    free(q->owned);
+    free(q->segments);
+    free(q->arena);
+    tui_output_queue_init(q);
+}
+
+static int reserve_segments(tui_output_queue *q, int n)
+{
+    if (n <= q->capacity - q->count) return 0;
+
+    int new_capacity = q->capacity ? q->capacity : QUEUE_INITIAL_SEGMENTS;
+    while (new_capacity - q->count < n) {
+        if (new_capacity > INT_MAX / 2) return -1;
+        new_capacity *= 2;
+    }
+    tui_queue_segment *segments = realloc(q->segments, (size_t)new_capacity * sizeof(tui_queue_segment));
+    if (!segments) return -1;
+
+    q->segments = segments;
+    q->capacity = new_capacity;
+    return 0;
+}
+
+static int reserve_arena(tui_output_queue *q, size_t len)
+{
+    if (q->arena_len + len <= q->arena_capacity) return 0;
+
+    size_t new_capacity = q->arena_capacity ? q->arena_capacity : QUEUE_INITIAL_ARENA;
+    while (new_capacity < q->arena_len + len) {
+        if (new_capacity > SIZE_MAX / 2) return -1;
+        new_capacity *= 2;
+    }
+
+    /* Segments store offsets, so moving the arena is safe */
+    char *arena = realloc(q->arena, new_capacity);
+    if (!arena) return -1;
+
+    q->arena = arena;
+    q->arena_capacity = new_capacity;
+    return 0;
+}
+
+int tui_output_queue_write(tui_output_queue *q, const void *data, size_t len)
+{
+    if (len == 0) return 0;
+    if (reserve_arena(q, len) < 0) return -1;
+
+    /* Extend the previous segment when it ends where this copy starts */
+    tui_queue_segment *last = q->count ? &q->segments[q->count - 1] : NULL;
+    if (last && !last->data && last->offset + last->len == q->arena_len) {
+        last->len += len;
+    } else {
+        if (reserve_segments(q, 1) < 0) return -1;
+        q->segments[q->count].data = NULL;
+        q->segments[q->count].offset = q->arena_len;
+        q->segments[q->count].len = len;
+        q->count++;
+    }
+
+    memcpy(q->arena + q->arena_len, data, len);
+    q->arena_len += len;
+    q->pending += len;
+    return 0;
+}
+
+int tui_output_queue_write_ref(tui_output_queue *q, const void *data, size_t len)
+{
+    if (len == 0) return 0;
+    if (reserve_segments(q, 1) < 0) return -1;
+
+    q->segments[q->count].data = data;
+    q->segments[q->count].offset = 0;
+    q->segments[q->count].len = len;
+    q->count++;
+    q->pending += len;
+    return 0;
+}
+
+void tui_output_queue_adopt(tui_output_queue *q, void *ptr)
+{
+    if (!ptr) return;
+
+    if (q->owned_count >= q->owned_capacity) {
+        int new_capacity = q->owned_capacity ? q->owned_capacity * 2 : 8;
+        void **owned = realloc(q->owned, (size_t)new_capacity * sizeof(void *));
+        if (!owned) {
+            /* Can't defer the free: write out whatever references it now */
+            tui_output_queue_flush(q, STDOUT_FILENO);
+            free(ptr);
+            return;
+        }
+        q->owned = owned;
+        q->owned_capacity = new_capacity;
+    }
+
+    q->owned[q->owned_count++] = ptr;
+}
+
+/* writev() until every iovec is out, resuming after partial writes */
+static int writev_all(int fd, struct iovec *iov, int count)
+{
+    while (count > 0) {
+        ssize_t written = writev(fd, iov, count);
+        TUI_METRIC_INC(output_writes);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        TUI_METRIC_ADD(output_bytes, written);
+
+        size_t left = (size_t)written;
+        while (count > 0 && left >= iov->iov_len) {
+            left -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char *)iov->iov_base + left;
+            iov->iov_len -= left;
+        }
+    }
+    return 0;
+}
+
+/* Empty the queue after its bytes went out */
+static void queue_reset(tui_output_queue *q)
+{
+    q->count = 0;
+    q->arena_len = 0;
+    q->pending = 0;
+    release_owned(q);
+
+    if (q->arena_capacity > QUEUE_ARENA_KEEP) {
+        free(q->arena);
+        q->arena = NULL;
+        q->arena_capacity = 0;
+    }
+}
+
+int tui_output_queue_flush(tui_output_queue *q, int fd)
+{
+    struct iovec iov[QUEUE_IOV_BATCH];
+    int result = 0;
+
+    if (fd < 0) result = -1;
+
+    for (int i = 0; i < q->count && result == 0; ) {
+        int n = 0;
+        while (i < q->count && n < QUEUE_IOV_BATCH) {
+            const tui_queue_segment *seg = &q->segments[i++];
+            iov[n].iov_base = (void *)(seg->data ? seg->data : q->arena + seg->offset);
+            iov[n].iov_len = seg->len;
+            n++;
+        }
+        result = writev_all(fd, iov, n);
+    }
+
+    queue_reset(q);
+    return result;
+}
+
+int tui_output_queue_drain(tui_output_queue *q, tui_output_sink sink, void *ctx)
+{
+    int result = 0;
+
+    /* The sink takes the frame in one go, like the writev() of a flush */
+    if (q->count > 0) {
+        TUI_METRIC_INC(output_writes);
+        TUI_METRIC_ADD(output_bytes, q->pending);
+    }
+
+    for (int i = 0; i < q->count && result == 0; i++) {
+        const tui_queue_segment *seg = &q->segments[i];
+        result = sink(ctx, seg->data ? seg->data : q->arena + seg->offset, seg->len);
+    }
+
+    queue_reset(q);
+    return result != 0 ? -1 : 0;
+}
+
+int tui_output_queue_append(tui_output_queue *dst, tui_output_queue *src)
+{
+    if (src->count == 0) return 0;
+
+    /* Reserve everything up front so a failure leaves both queues intact */
+    if (reserve_arena(dst, src->arena_len) < 0) return -1;
+    if (reserve_segments(dst, src->count) < 0) return -1;
+    if (dst->owned_capacity - dst->owned_count < src->owned_count) {
+        int new_capacity = dst->owned_count + src->owned_count;
+        void **owned = realloc(dst->owned, (size_t)new_capacity * sizeof(void *));
+        if (!owned) return -1;
+        dst->owned = owned;
+        dst->owned_capacity = new_capacity;
+    }
+
+    size_t base = dst->arena_len;
+    if (src->arena_len) {
+        memcpy(dst->arena + base, src->arena, src->arena_len);
+        dst->arena_len += src->arena_len;
+    }
+
+    for (int i = 0; i < src->count; i++) {
+        tui_queue_segment seg = src->segments[i];
+        if (!seg.data) seg.offset += base;
+
+        /* Same coalescing as tui_output_queue_write() */
+        tui_queue_segment *last = dst->count ? &dst->segments[dst->count - 1] : NULL;
+        if (!seg.data && last && !last->data && last->offset + last->len == seg.offset) {
+            last->len += seg.len;
+        } else {
+            dst->segments[dst->count++] = seg;
+        }
+    }
+    dst->pending += src->pending;
+
+    for (int i = 0; i < src->owned_count; i++) {
+        dst->owned[dst->owned_count++] = src->owned[i];
+    }
+
+    src->count = 0;
+    src->arena_len = 0;
+    src->pending = 0;
+    src->owned_count = 0;
+    return 0;
+}
+
+/* ----------------------------------------------------------------
+ * Active frame queue
+ * ---------------------------------------------------------------- */
+
+static tui_output_queue *active_queue = NULL;
+
+tui_output_queue* tui_output_queue_activate(tui_output_queue *q)
+{
+    tui_output_queue *prev = active_queue;
+    active_queue = q;
+    return prev;
+}
+
+tui_output_queue* tui_output_queue_active(void)
+{
+    return active_queue;
+}
+
+int tui_output_write(const void *data, size_t len)
+{
+    if (len == 0) return 0;
+
+    if (active_queue && tui_output_queue_write(active_queue, data, len) == 0) {
+        return 0;
+    }
+
+    /* No frame open (or out of memory): keep ordering and write through */
+    if (active_queue) tui_output_queue_flush(active_queue, STDOUT_FILENO);
+    return tui_write_all(STDOUT_FILENO, data, len);
+}
+
+int tui_output_write_owned(void *data, size_t len)
+{
+    if (!data) return -1;
+
+    if (active_queue && tui_output_queue_write_ref(active_queue, data, len) == 0) {
+        tui_output_queue_adopt(active_queue, data);
+        return 0;
+    }
+
+    if (active_queue) tui_output_queue_flush(active_queue, STDOUT_FILENO);
+    int result = tui_write_all(STDOUT_FILENO, data, len);
+    free(data);
+    return result;
+}
@@ -0,0 +1,130 @@
+/*
+  +----------------------------------------------------------------------+
+  | ext-tui: Terminal output queue                                      |
+  +----------------------------------------------------------------------+
+  | Collects everything written to the terminal during a frame (cell    |
+  | diff, image payloads, OSC sequences) as a list of segments and      |
+  | writes them with a single writev() when the frame ends.             |
+  |                                                                      |
+  | Small writes are copied into an arena and coalesced; large payloads |
+  | can be queued by reference or handed over (freed after the flush).  |
+  |                                                                      |
+  | Subsystems without access to a tui_output use tui_output_write():   |
+  | bytes join the active frame's queue, or go out immediately when no  |
+  | frame is open.                                                      |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef TUI_RENDER_QUEUE_H
+#define TUI_RENDER_QUEUE_H
+
+#include <stddef.h>
+
+/**
+ * Receives output bytes in order (queued frames, serialized buffers).
+ * @return 0 to continue, -1 to stop
+ */
+typedef int (*tui_output_sink)(void *ctx, const char *data, size_t len);
+
+/* One queued run of bytes: either borrowed memory or a slice of the arena */
+typedef struct {
+    const char *data;       /* Borrowed/owned memory, NULL for arena slices */
+    size_t offset;          /* Arena offset (arena slices only) */
+    size_t len;
+} tui_queue_segment;
+
+typedef struct {
+    tui_queue_segment *segments;
+    int count;
+    int capacity;
+    char *arena;            /* Copied bytes for small writes */
+    size_t arena_len;
+    size_t arena_capacity;
+    void **owned;           /* Payloads freed once written */
+    int owned_count;
+    int owned_capacity;
+    size_t pending;         /* Total bytes queued */
+} tui_output_queue;
+
+/**
+ * Initialize an empty queue (no allocation until first write).
+ */
+void tui_output_queue_init(tui_output_queue *q);
+
+/**
+ * Release all memory. Queued bytes are discarded; owned payloads freed.
+ */
+void tui_output_queue_free(tui_output_queue *q);
+
+/**
+ * Queue a copy of data.
+ * @return 0 on success, -1 on allocation failure (nothing queued)
+ */
+int tui_output_queue_write(tui_output_queue *q, const void *data, size_t len);
+
+/**
+ * Queue data by reference. The caller keeps it alive until the next flush.
+ * @return 0 on success, -1 on allocation failure (nothing queued)
+ */
+int tui_output_queue_write_ref(tui_output_queue *q, const void *data, size_t len);
+
+/**
+ * Hand a malloc'd block to the queue; it is free()d after the next flush.
+ * Pair with tui_output_queue_write_ref() on (parts of) the block.
+ * On allocation failure the queue is flushed to stdout first so the
+ * block can be released immediately.
+ */
+void tui_output_queue_adopt(tui_output_queue *q, void *ptr);
+
+/**
+ * Write all queued segments to fd with writev() and empty the queue.
+ * Handles partial writes and EINTR.
+ * @return 0 on success, -1 on write error (queue is emptied either way)
+ */
+int tui_output_queue_flush(tui_output_queue *q, int fd);
+
+/**
+ * Like tui_output_queue_flush(), but hands the segments to sink instead
+ * of writing them to a file descriptor (captured frames in tests).
+ * @return 0 on success, -1 if the sink stopped (queue is emptied either way)
+ */
+int tui_output_queue_drain(tui_output_queue *q, tui_output_sink sink, void *ctx);
+
+/**
+ * Move everything queued in src to the end of dst. Copied bytes are
+ * copied again, borrowed and owned payloads change hands. src is left
+ * empty but keeps its memory for the next frame.
+ * @return 0 on success, -1 on allocation failure (both queues unchanged)
+ */
+int tui_output_queue_append(tui_output_queue *dst, tui_output_queue *src);
+
+/* ----------------------------------------------------------------
+ * Active frame queue
+ * ---------------------------------------------------------------- */
+
+/**
+ * Make q the queue that tui_output_write() and friends append to.
+ * @return Previously active queue (restore it with another call), or NULL
+ */
+tui_output_queue* tui_output_queue_activate(tui_output_queue *q);
+
+/**
+ * Currently active queue, or NULL outside a frame.
+ */
+tui_output_queue* tui_output_queue_active(void);
+
+/**
+ * Write bytes to the terminal: appended to the active queue if a frame
+ * is open, otherwise written to stdout immediately.
+ * @return 0 on success, -1 on error
+ */
+int tui_output_write(const void *data, size_t len);
+
+/**
+ * Like tui_output_write(), but takes ownership of a malloc'd block: it is
+ * queued without copying and free()d after it has been written.
+ * @return 0 on success, -1 on error (the block is freed either way)
+ */
+int tui_output_write_owned(void *data, size_t len);
+
+#endif /* TUI_RENDER_QUEUE_H */
@@ -0,0 +1,162 @@
+/*
+  +----------------------------------------------------------------------+
+  | ext-tui: Encoder worker threads                                     |
+  +----------------------------------------------------------------------+
+*/
+
+#include "workers.h"
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+struct tui_worker_pool {
+    pthread_t threads[TUI_WORKERS_MAX];
+    int helpers;            /* Helper threads running */
+    pid_t pid;              /* Process that owns the helpers */
+    pthread_mutex_t lock;
+    pthread_cond_t work;    /* New batch posted, or shutdown */
+    pthread_cond_t done;    /* Last job of the batch finished */
+    unsigned long batch;    /* Batch number, bumped per run */
+    tui_worker_job job;
+    void **args;
+    int count;              /* Jobs in the batch */
+    int next;               /* Next job to hand out */
+    int running;            /* Jobs handed out and not finished */
+    int shutdown;
+};
+
+/* Run jobs of the current batch until none are left. Called locked. */
+static void drain_batch(tui_worker_pool *pool)
+{
+    while (pool->next < pool->count) {
+        int i = pool->next++;
+        pool->running++;
+        pthread_mutex_unlock(&pool->lock);
+
+        pool->job(pool->args[i]);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->running--;
+    }
+    if (pool->running == 0) {
+        pthread_cond_signal(&pool->done);
+    }
+}
+
+static void* worker_main(void *arg)
+{
+    tui_worker_pool *pool = arg;
+    unsigned long seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->shutdown && pool->batch == seen) {
+            pthread_cond_wait(&pool->work, &pool->lock);
+        }
+        if (pool->shutdown) break;
+
+        seen = pool->batch;
+        drain_batch(pool);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+tui_worker_pool* tui_worker_pool_create(int threads)
+{
+    if (threads < 2) return NULL;
+    if (threads > TUI_WORKERS_MAX) threads = TUI_WORKERS_MAX;
+
+    tui_worker_pool *pool = calloc(1, sizeof(tui_worker_pool));
+    if (!pool) return NULL;
+
+    if (pthread_mutex_init(&pool->lock, NULL) != 0) {
+        free(pool);
+        return NULL;
+    }
+    if (pthread_cond_init(&pool->work, NULL) != 0) {
+        pthread_mutex_destroy(&pool->lock);
+        free(pool);
+        return NULL;
+    }
+    if (pthread_cond_init(&pool->done, NULL) != 0) {
+        pthread_cond_destroy(&pool->work);
+        pthread_mutex_destroy(&pool->lock);
+        free(pool);
+        return NULL;
+    }
+    pool->pid = getpid();
+
+    /* Helpers inherit this mask: signals stay with the main thread */
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    for (int i = 0; i < threads - 1; i++) {
+        if (pthread_create(&pool->threads[i], NULL, worker_main, pool) != 0) break;
+        pool->helpers++;
+    }
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    if (pool->helpers == 0) {
+        tui_worker_pool_destroy(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void tui_worker_pool_destroy(tui_worker_pool *pool)
+{
+    if (!pool) return;
+
+    if (pool->pid == getpid()) {
+        pthread_mutex_lock(&pool->lock);
+        pool->shutdown = 1;
+        pthread_cond_broadcast(&pool->work);
+        pthread_mutex_unlock(&pool->lock);
+
+        for (int i = 0; i < pool->helpers; i++) {
+            pthread_join(pool->threads[i], NULL);
+        }
+    }
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->work);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+int tui_worker_pool_threads(const tui_worker_pool *pool)
+{
+    return pool ? pool->helpers + 1 : 1;
+}
+
+void tui_worker_pool_run(tui_worker_pool *pool, tui_worker_job job, void **args, int count)
+{
+    if (!job || count <= 0) return;
+
+    if (!pool || pool->pid != getpid()) {
+        for (int i = 0; i < count; i++) job(args[i]);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->job = job;
+    pool->args = args;
+    pool->count = count;
+    pool->next = 0;
+    pool->running = 0;
+    pool->batch++;
+    pthread_cond_broadcast(&pool->work);
+
+    /* The caller works too, then waits for jobs still on the helpers */
+    drain_batch(pool);
+    while (pool->running > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+
+    pool->job = NULL;
+    pool->args = NULL;
+    pool->count = 0;
+    pthread_mutex_unlock(&pool->lock);
+}
@@ -0,0 +1,55 @@
+/*
+  +----------------------------------------------------------------------+
+  | ext-tui: Encoder worker threads                                     |
+  +----------------------------------------------------------------------+
+  | A small fixed pool of pthreads that runs a batch of jobs and waits  |
+  | for all of them. Used by the output to encode bands of rows in      |
+  | parallel on very large screens (tui.encode_threads).                |
+  |                                                                      |
+  | Jobs must only touch memory handed to them: never PHP state, the    |
+  | module globals or the output queue. Workers block all signals, so   |
+  | SIGWINCH and friends keep going to the main thread.                 |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef TUI_RENDER_WORKERS_H
+#define TUI_RENDER_WORKERS_H
+
+/* Upper bound on tui.encode_threads */
+#define TUI_WORKERS_MAX 16
+
+typedef struct tui_worker_pool tui_worker_pool;
+
+typedef void (*tui_worker_job)(void *arg);
+
+/**
+ * Start a pool. The calling thread takes part in every batch, so
+ * `threads` total means threads - 1 helper threads.
+ * @param threads Threads per batch including the caller (2 to TUI_WORKERS_MAX)
+ * @return New pool, or NULL on failure
+ */
+tui_worker_pool* tui_worker_pool_create(int threads);
+
+/**
+ * Stop and join the helper threads.
+ * @param pool Pool (NULL-safe)
+ */
+void tui_worker_pool_destroy(tui_worker_pool *pool);
+
+/**
+ * Threads that take part in a batch, including the caller.
+ */
+int tui_worker_pool_threads(const tui_worker_pool *pool);
+
+/**
+ * Run job(args[i]) for every i < count and return once all are done.
+ * Jobs are handed out in index order. In a forked child (the helpers
+ * didn't survive the fork) every job runs on the caller.
+ * @param pool  Pool
+ * @param job   Function to run
+ * @param args  One argument per job
+ * @param count Number of jobs
+ */
+void tui_worker_pool_run(tui_worker_pool *pool, tui_worker_job job, void **args, int count);
+
+#endif /* TUI_RENDER_WORKERS_H */
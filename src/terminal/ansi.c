@@ -206,6 +206,43 @@ void tui_ansi_cursor_column(char *buf, size_t *len, int col)
     safe_snprintf_len(buf, ANSI_BUF_SIZE, len, snprintf(buf, ANSI_BUF_SIZE, ESC "%dG", col + 1));
 }
 
+void tui_ansi_cursor_forward(char *buf, size_t *len, int cols)
+{
+    /* Move cursor right n columns (CUF); the count is implied when 1 */
+    if (cols <= 1) {
+        safe_snprintf_len(buf, ANSI_BUF_SIZE, len, snprintf(buf, ANSI_BUF_SIZE, ESC "C"));
+    } else {
+        safe_snprintf_len(buf, ANSI_BUF_SIZE, len, snprintf(buf, ANSI_BUF_SIZE, ESC "%dC", cols));
+    }
+}
+
+void tui_ansi_cursor_back(char *buf, size_t *len, int cols)
+{
+    /* Move cursor left n columns (CUB); the count is implied when 1 */
+    if (cols <= 1) {
+        safe_snprintf_len(buf, ANSI_BUF_SIZE, len, snprintf(buf, ANSI_BUF_SIZE, ESC "D"));
+    } else {
+        safe_snprintf_len(buf, ANSI_BUF_SIZE, len, snprintf(buf, ANSI_BUF_SIZE, ESC "%dD", cols));
+    }
+}
+
+void tui_ansi_repeat(char *buf, size_t *len, int count)
+{
+    /* Repeat the preceding graphic character n times (REP); the count is implied when 1 */
+    if (count <= 1) {
+        safe_snprintf_len(buf, ANSI_BUF_SIZE, len, snprintf(buf, ANSI_BUF_SIZE, ESC "b"));
+    } else {
+        safe_snprintf_len(buf, ANSI_BUF_SIZE, len, snprintf(buf, ANSI_BUF_SIZE, ESC "%db", count));
+    }
+}
+
+void tui_ansi_erase_chars(char *buf, size_t *len, int count)
+{
+    /* Erase n characters from the cursor without moving it (ECH) */
+    if (count <= 0) count = 1;
+    safe_snprintf_len(buf, ANSI_BUF_SIZE, len, snprintf(buf, ANSI_BUF_SIZE, ESC "%dX", count));
+}
+
 void tui_ansi_erase_screen_end(char *buf, size_t *len)
 {
     /* Erase from cursor to end of screen */
@@ -218,6 +255,20 @@ void tui_ansi_erase_screen_start(char *buf, size_t *len)
     safe_snprintf_len(buf, ANSI_BUF_SIZE, len, snprintf(buf, ANSI_BUF_SIZE, ESC "1J"));
 }
 
+void tui_ansi_set_scroll_region(char *buf, size_t *len, int top, int bottom)
+{
+    /* DECSTBM - limit SU/SD to rows top..bottom (also homes the cursor) */
+    if (top < 0) top = 0;
+    if (bottom < top) bottom = top;
+    safe_snprintf_len(buf, ANSI_BUF_SIZE, len, snprintf(buf, ANSI_BUF_SIZE, ESC "%d;%dr", top + 1, bottom + 1));
+}
+
+void tui_ansi_reset_scroll_region(char *buf, size_t *len)
+{
+    /* DECSTBM with no parameters - whole screen */
+    safe_snprintf_len(buf, ANSI_BUF_SIZE, len, snprintf(buf, ANSI_BUF_SIZE, ESC "r"));
+}
+
 /* Color conversion utilities */
 
 /**
@@ -245,7 +296,8 @@ int tui_rgb_to_ansi256(uint8_t r, uint8_t g, uint8_t b)
         }
         /* Use grayscale ramp (232-255): 24 shades from dark to light */
         /* Each shade covers about 10 units (256/24 ≈ 10.67) */
-        return 232 + ((r - 8) / 10);
+        int shade = (r - 8) / 10;
+        return 232 + (shade > 23 ? 23 : shade);
     }
 
     /* Map to 6x6x6 color cube (indices 16-231) */
@@ -262,6 +314,45 @@ int tui_rgb_to_ansi256(uint8_t r, uint8_t g, uint8_t b)
     return 16 + (36 * ri) + (6 * gi) + bi;
 }
 
+/* xterm's default values for the 16 standard colors */
+static const uint8_t ansi16_palette[16][3] = {
+    {0, 0, 0}, {205, 0, 0}, {0, 205, 0}, {205, 205, 0},
+    {0, 0, 238}, {205, 0, 205}, {0, 205, 205}, {229, 229, 229},
+    {127, 127, 127}, {255, 0, 0}, {0, 255, 0}, {255, 255, 0},
+    {92, 92, 255}, {255, 0, 255}, {0, 255, 255}, {255, 255, 255}
+};
+
+/**
+ * Convert RGB color to the nearest of the 16 standard ANSI colors.
+ *
+ * Distance is weighted per channel (2/4/3) as a cheap approximation of
+ * perceived difference. The palette is xterm's default; terminals with
+ * customized themes will differ.
+ *
+ * @param r Red component (0-255)
+ * @param g Green component (0-255)
+ * @param b Blue component (0-255)
+ * @return ANSI color index (0-7 normal, 8-15 bright)
+ */
+int tui_rgb_to_ansi16(uint8_t r, uint8_t g, uint8_t b)
+{
+    int best = 0;
+    int best_dist = -1;
+
+    for (int i = 0; i < 16; i++) {
+        int dr = r - ansi16_palette[i][0];
+        int dg = g - ansi16_palette[i][1];
+        int db = b - ansi16_palette[i][2];
+        int dist = 2 * dr * dr + 4 * dg * dg + 3 * db * db;
+        if (best_dist < 0 || dist < best_dist) {
+            best = i;
+            best_dist = dist;
+        }
+    }
+
+    return best;
+}
+
 /* Synchronized output (DEC mode 2026) */
 
 void tui_ansi_sync_start(char *buf, size_t *len)
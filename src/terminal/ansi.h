@@ -63,11 +63,20 @@ void tui_ansi_scroll_down(char *buf, size_t *len, int lines);
 void tui_ansi_cursor_next_line(char *buf, size_t *len, int lines);
 void tui_ansi_cursor_prev_line(char *buf, size_t *len, int lines);
 void tui_ansi_cursor_column(char *buf, size_t *len, int col);
+void tui_ansi_cursor_forward(char *buf, size_t *len, int cols);
+void tui_ansi_cursor_back(char *buf, size_t *len, int cols);
+void tui_ansi_repeat(char *buf, size_t *len, int count);
+void tui_ansi_erase_chars(char *buf, size_t *len, int count);
 void tui_ansi_erase_screen_end(char *buf, size_t *len);
 void tui_ansi_erase_screen_start(char *buf, size_t *len);
 
+/* Scroll region (DECSTBM), rows 0-indexed and inclusive */
+void tui_ansi_set_scroll_region(char *buf, size_t *len, int top, int bottom);
+void tui_ansi_reset_scroll_region(char *buf, size_t *len);
+
 /* Color conversion */
 int tui_rgb_to_ansi256(uint8_t r, uint8_t g, uint8_t b);
+int tui_rgb_to_ansi16(uint8_t r, uint8_t g, uint8_t b);
 
 /* Synchronized output (DEC mode 2026) - eliminates flicker */
 void tui_ansi_sync_start(char *buf, size_t *len);
@@ -157,6 +157,7 @@ static unsigned int detect_capabilities(tui_terminal_type type, int color_depth,
             caps |= TUI_CAP_KITTY_GRAPHICS;
             caps |= TUI_CAP_FOCUS_EVENTS;
             caps |= TUI_CAP_UNICODE;
+            caps |= TUI_CAP_REP;
             break;
 
         case TUI_TERM_ITERM2:
@@ -181,6 +182,7 @@ static unsigned int detect_capabilities(tui_terminal_type type, int color_depth,
             caps |= TUI_CAP_KITTY_GRAPHICS;
             caps |= TUI_CAP_SIXEL;
             caps |= TUI_CAP_FOCUS_EVENTS;
+            caps |= TUI_CAP_REP;
             break;
 
         case TUI_TERM_ALACRITTY:
@@ -198,6 +200,7 @@ static unsigned int detect_capabilities(tui_terminal_type type, int color_depth,
             caps |= TUI_CAP_BRACKETED_PASTE;
             caps |= TUI_CAP_HYPERLINKS_OSC8;
             caps |= TUI_CAP_SYNC_OUTPUT;
+            caps |= TUI_CAP_REP;
             break;
 
         case TUI_TERM_WINDOWS_TERMINAL:
@@ -206,6 +209,7 @@ static unsigned int detect_capabilities(tui_terminal_type type, int color_depth,
             caps |= TUI_CAP_BRACKETED_PASTE;
             caps |= TUI_CAP_HYPERLINKS_OSC8;
             caps |= TUI_CAP_FOCUS_EVENTS;
+            caps |= TUI_CAP_REP;
             break;
 
         case TUI_TERM_KONSOLE:
@@ -225,6 +229,7 @@ static unsigned int detect_capabilities(tui_terminal_type type, int color_depth,
             caps |= TUI_CAP_SYNC_OUTPUT;
             caps |= TUI_CAP_KITTY_KEYBOARD;
             caps |= TUI_CAP_SIXEL;
+            caps |= TUI_CAP_REP;
             break;
 
         case TUI_TERM_XTERM:
@@ -232,6 +237,7 @@ static unsigned int detect_capabilities(tui_terminal_type type, int color_depth,
             caps |= TUI_CAP_BRACKETED_PASTE;
             caps |= TUI_CAP_CLIPBOARD_OSC52;
             caps |= TUI_CAP_FOCUS_EVENTS;
+            caps |= TUI_CAP_REP;
             break;
 
         case TUI_TERM_SCREEN:
@@ -31,6 +31,7 @@
 #define TUI_CAP_TITLE            (1 << 13) /* Window title (OSC 2) */
 #define TUI_CAP_FOCUS_EVENTS     (1 << 14) /* Focus in/out events */
 #define TUI_CAP_ALTERNATE_SCREEN (1 << 15) /* Alternate screen buffer */
+#define TUI_CAP_REP              (1 << 16) /* Repeat preceding character (REP) */
 
 /* Terminal identification */
 typedef enum {
@@ -11,6 +11,7 @@
 
 #include "notify.h"
 #include "capabilities.h"
+#include "../render/queue.h"
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
@@ -21,8 +22,8 @@
 #define NOTIFY_MSG_SIZE 1024
 
 /**
- * Write all bytes to stdout.
- * Handles partial writes.
+ * Write all bytes to stdout immediately, bypassing the frame queue.
+ * Handles partial writes. Only for timed effects (tui_flash).
  */
 static void write_stdout(const char *buf, size_t len)
 {
@@ -126,7 +127,7 @@ void tui_bell(void)
     size_t len;
 
     tui_ansi_bell(buf, &len);
-    write_stdout(buf, len);
+    tui_output_write(buf, len);
 }
 
 void tui_flash(void)
@@ -206,7 +207,7 @@ int tui_notify(const char *title, const char *body, tui_notify_priority priority
     }
 
     if (len > 0) {
-        write_stdout(buf, len);
+        tui_output_write(buf, len);
         return 0;
     }
 
@@ -131,6 +131,19 @@ int tui_terminal_is_tty(void)
     return isatty(STDIN_FILENO) && isatty(STDOUT_FILENO);
 }
 
+int tui_terminal_output_queued(void)
+{
+#ifdef TIOCOUTQ
+    int queued = 0;
+    if (ioctl(STDOUT_FILENO, TIOCOUTQ, &queued) == -1) {
+        return -1;
+    }
+    return queued;
+#else
+    return -1;
+#endif
+}
+
 /* Bracketed paste mode
  *
  * Process-global: bracketed paste affects the terminal, not individual threads.
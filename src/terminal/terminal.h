@@ -63,6 +63,14 @@ int tui_terminal_get_size(int *width, int *height);
  */
 int tui_terminal_is_tty(void);
 
+/**
+ * Get the number of bytes written to the terminal that the tty has not
+ * yet sent (TIOCOUTQ). A growing value means the terminal is not keeping
+ * up with our output.
+ * @return Queued byte count, or -1 if unsupported or stdout is not a tty
+ */
+int tui_terminal_output_queued(void);
+
 /* ================================================================
  * Bracketed paste mode
  * ================================================================ */
@@ -5,10 +5,13 @@
 */
 
 #include "renderer.h"
+#include "query.h"
+#include "../node/reconciler.h"
 #include "../text/measure.h"
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
+#include <stdint.h>
 
 #define INITIAL_INPUT_CAPACITY 256
 
@@ -23,16 +26,19 @@ tui_test_renderer* tui_test_renderer_create(int width, int height)
     renderer->width = width;
     renderer->height = height;
 
-    renderer->buffer = tui_buffer_create(width, height);
-    if (!renderer->buffer) {
+    renderer->app = tui_app_create_headless(width, height);
+    if (!renderer->app) {
         free(renderer);
         return NULL;
     }
+    /* Requests between frames are only flagged, as inside the app's
+     * event loop; tui_test_renderer_advance_frame() draws them */
+    renderer->app->in_event_loop = 1;
 
     renderer->input_queue_capacity = INITIAL_INPUT_CAPACITY;
     renderer->input_queue = calloc(renderer->input_queue_capacity, 1);
     if (!renderer->input_queue) {
-        tui_buffer_destroy(renderer->buffer);
+        tui_app_destroy(renderer->app);
         free(renderer);
         return NULL;
     }
@@ -44,52 +50,114 @@ void tui_test_renderer_destroy(tui_test_renderer *renderer)
 {
     if (!renderer) return;
 
-    tui_buffer_destroy(renderer->buffer);
     free(renderer->input_queue);
 
-    if (renderer->root) {
-        tui_node_destroy(renderer->root);
-    }
-
-    /* Note: app is owned externally, don't destroy here */
+    /* Also frees the tree, layers and terminal */
+    tui_app_destroy(renderer->app);
+    tui_arena_shutdown(&renderer->arena);
+    free(renderer->frame);
 
     free(renderer);
 }
 
-/* Forward declaration from app.c for rendering */
-extern void tui_app_render_node_to_buffer(tui_buffer *buffer, tui_node *node,
-                                           int offset_x, int offset_y,
-                                           int clip_x, int clip_y,
-                                           int clip_w, int clip_h);
-
 void tui_test_renderer_render(tui_test_renderer *renderer, tui_node *root)
 {
     if (!renderer || !root) return;
 
-    /* Free previous root if any (prevents memory leak on re-render) */
-    if (renderer->root) {
-        tui_node_destroy(renderer->root);
+    tui_app *app = renderer->app;
+
+    /* Patch the current tree the way the app does on re-render. What is
+     * left of root is destroyed, so its arena can be dropped right away. */
+    tui_arena *arena = root->arena;
+    app->root_node = tui_reconciler_reconcile(app->root_node, root, &app->focused_node);
+    if (arena) tui_arena_reset(arena);
+    app->base.tree_dirty = 1;
+    if (!app->root_node) return;
+
+    if (!app->focused_node) {
+        app->focused_node = tui_test_find_focused(app->root_node);
     }
 
-    /* Store root reference */
-    renderer->root = root;
+    /* The app's frame: layout, redraw of the damaged areas, output */
+    renderer->frame_len = 0;
+    tui_output_begin_frame(app->output);
+    tui_app_render_tree(app);
+    tui_output_end_frame(app->output);
 
-    /* Calculate layout */
-    tui_node_calculate_layout(root, (float)renderer->width, (float)renderer->height);
+    renderer->frame_count++;
+}
 
-    /* Clear buffer */
-    tui_buffer_clear(renderer->buffer);
+/* tui_output_sink collecting the emulated terminal's frames */
+static int frame_sink(void *ctx, const char *data, size_t len)
+{
+    tui_test_renderer *renderer = ctx;
 
-    /* Render tree to buffer */
-    tui_app_render_node_to_buffer(renderer->buffer, root, 0, 0,
-                                   0, 0, renderer->width, renderer->height);
+    if (len > renderer->frame_capacity - renderer->frame_len) {
+        size_t capacity = renderer->frame_capacity ? renderer->frame_capacity : 4096;
+        while (capacity - renderer->frame_len < len) {
+            if (capacity > SIZE_MAX / 2) return -1;
+            capacity *= 2;
+        }
+        char *frame = realloc(renderer->frame, capacity);
+        if (!frame) return -1;
+        renderer->frame = frame;
+        renderer->frame_capacity = capacity;
+    }
 
-    renderer->frame_count++;
+    memcpy(renderer->frame + renderer->frame_len, data, len);
+    renderer->frame_len += len;
+    return 0;
+}
+
+int tui_test_renderer_set_terminal(tui_test_renderer *renderer, unsigned int capabilities,
+                                   int color_depth, int threads, int inline_mode)
+{
+    if (!renderer) return -1;
+
+    tui_app *app = renderer->app;
+    tui_output *terminal = tui_output_create(app->width, app->height);
+    if (!terminal) return -1;
+
+    terminal->capabilities = capabilities;
+    terminal->color_depth = color_depth;
+    tui_output_set_encode_threads(terminal, threads);
+    tui_output_set_sink(terminal, frame_sink, renderer);
+    tui_output_set_inline(terminal, inline_mode);
+
+    tui_output_destroy(app->output);
+    app->output = terminal;
+    app->fullscreen = !inline_mode;
+    renderer->frame_len = 0;
+
+    /* The new terminal is blank: whatever is drawn already must be sent,
+     * laid out for the mode it is drawn in */
+    tui_buffer_mark_all_dirty(app->buffer);
+    app->repaint_all = 1;
+    return 0;
+}
+
+const char* tui_test_renderer_get_frame(tui_test_renderer *renderer, size_t *len)
+{
+    if (!renderer || !renderer->app->output) return NULL;
+
+    *len = renderer->frame_len;
+    return renderer->frame ? renderer->frame : "";
+}
+
+tui_arena* tui_test_renderer_frame_arena(tui_test_renderer *renderer)
+{
+    if (!renderer) return NULL;
+
+    /* Leftovers of a tree that failed to build */
+    tui_arena_reset(&renderer->arena);
+    return &renderer->arena;
 }
 
 char** tui_test_renderer_get_output(tui_test_renderer *renderer, int *line_count)
 {
-    if (!renderer || !renderer->buffer || !line_count) return NULL;
+    if (!renderer || !line_count) return NULL;
+
+    tui_buffer *buffer = renderer->app->buffer;
 
     *line_count = renderer->height;
 
@@ -97,8 +165,18 @@ char** tui_test_renderer_get_output(tui_test_renderer *renderer, int *line_count
     if (!lines) return NULL;
 
     for (int y = 0; y < renderer->height; y++) {
-        /* Allocate worst case: 4 bytes per char (UTF-8) + null */
-        lines[y] = calloc(renderer->width * 4 + 1, 1);
+        /* Allocate worst case: 4 bytes per char (UTF-8), or the
+         * cluster's own bytes, + null */
+        size_t size = 1;
+        for (int x = 0; x < renderer->width; x++) {
+            tui_cell *cell = tui_buffer_get_cell(buffer, x, y);
+            size_t len = 4;
+            if (cell && tui_cell_is_cluster(cell)) {
+                tui_buffer_cluster(buffer, cell, &len, NULL);
+            }
+            size += len;
+        }
+        lines[y] = calloc(size, 1);
         if (!lines[y]) {
             tui_test_renderer_free_output(lines, y);
             *line_count = 0;
@@ -107,14 +185,19 @@ char** tui_test_renderer_get_output(tui_test_renderer *renderer, int *line_count
 
         int pos = 0;
         for (int x = 0; x < renderer->width; x++) {
-            tui_cell *cell = tui_buffer_get_cell(renderer->buffer, x, y);
-            if (cell && cell->codepoint != 0) {
-                /* Skip continuation cells (wide chars) */
-                if (cell->codepoint == (uint32_t)-1) continue;
+            tui_cell *cell = tui_buffer_get_cell(buffer, x, y);
+            /* Skip continuation cells (wide chars) */
+            if (cell && cell->codepoint == 0) continue;
 
+            if (cell) {
                 /* Encode codepoint to UTF-8 */
                 uint32_t cp = cell->codepoint;
-                if (cp < 0x80) {
+                if (tui_cell_is_cluster(cell)) {
+                    size_t len;
+                    const char *bytes = tui_buffer_cluster(buffer, cell, &len, NULL);
+                    memcpy(lines[y] + pos, bytes, len);
+                    pos += (int)len;
+                } else if (cp < 0x80) {
                     lines[y][pos++] = (char)cp;
                 } else if (cp < 0x800) {
                     lines[y][pos++] = (char)(0xC0 | (cp >> 6));
@@ -265,9 +348,33 @@ void tui_test_renderer_send_key(tui_test_renderer *renderer, int key_code)
     }
 }
 
+int tui_test_renderer_add_layer(tui_test_renderer *renderer, tui_node *root, int z_index)
+{
+    if (!renderer) {
+        tui_node_destroy(root);
+        return -1;
+    }
+    return tui_app_add_layer(renderer->app, root, z_index);
+}
+
+int tui_test_renderer_update_layer(tui_test_renderer *renderer, int id, tui_node *root)
+{
+    if (!renderer) {
+        tui_node_destroy(root);
+        return -1;
+    }
+    return tui_app_update_layer(renderer->app, id, root);
+}
+
+int tui_test_renderer_remove_layer(tui_test_renderer *renderer, int id)
+{
+    if (!renderer) return -1;
+    return tui_app_remove_layer(renderer->app, id);
+}
+
 void tui_test_renderer_advance_frame(tui_test_renderer *renderer)
 {
-    if (!renderer || !renderer->app) return;
+    if (!renderer) return;
 
     /* Process queued input */
     if (renderer->input_queue_len > 0) {
@@ -279,21 +386,20 @@ void tui_test_renderer_advance_frame(tui_test_renderer *renderer)
         renderer->input_queue_len = 0;
     }
 
-    /* Trigger re-render if app has a component */
-    if (renderer->app && renderer->app->root_node) {
-        /* Re-calculate layout and render */
-        tui_node_calculate_layout(renderer->app->root_node,
-                                   (float)renderer->width, (float)renderer->height);
-        tui_buffer_clear(renderer->buffer);
-        tui_app_render_node_to_buffer(renderer->buffer, renderer->app->root_node,
-                                       0, 0, 0, 0, renderer->width, renderer->height);
+    /* Everything requested since the last frame, drawn once. Without a
+     * pending frame the terminal got nothing and keeps the last one. */
+    size_t last_len = renderer->frame_len;
+    renderer->frame_len = 0;
+    if (tui_app_render_pending(renderer->app)) {
         renderer->frame_count++;
+    } else {
+        renderer->frame_len = last_len;
     }
 }
 
 void tui_test_renderer_run_timers(tui_test_renderer *renderer, int ms)
 {
-    if (!renderer || !renderer->app || ms <= 0) return;
+    if (!renderer || ms <= 0) return;
 
     renderer->elapsed_ms += ms;
 
@@ -305,10 +411,3 @@ void tui_test_renderer_run_timers(tui_test_renderer *renderer, int ms)
     /* Advance frame to process any timer callbacks */
     tui_test_renderer_advance_frame(renderer);
 }
-
-void tui_test_renderer_set_app(tui_test_renderer *renderer, tui_app *app)
-{
-    if (renderer) {
-        renderer->app = app;
-    }
-}
@@ -3,7 +3,8 @@
   | ext-tui: Headless test renderer                                      |
   +----------------------------------------------------------------------+
   | Provides headless rendering for automated testing of TUI components. |
-  | No terminal I/O - pure in-memory buffer rendering.                   |
+  | No terminal I/O - frames go through a headless app's render path     |
+  | into its buffer, and into an emulated terminal when one is attached. |
   +----------------------------------------------------------------------+
 */
 
@@ -11,6 +12,7 @@
 #define TUI_TESTING_RENDERER_H
 
 #include "../render/buffer.h"
+#include "../render/output.h"
 #include "../node/node.h"
 #include "../app/app.h"
 
@@ -47,9 +49,7 @@
 typedef struct {
     int width;
     int height;
-    tui_buffer *buffer;
-    tui_node *root;
-    tui_app *app;           /* App instance for state/hooks */
+    tui_app *app;           /* Headless app: tree, focus, buffer, layers, output */
     int frame_count;        /* Number of frames rendered */
 
     /* Input queue for simulated input */
@@ -59,6 +59,16 @@ typedef struct {
 
     /* Timer simulation */
     int elapsed_ms;         /* Simulated elapsed time */
+
+    /* tui.node_arena: arena the next frame's tree is built in */
+    tui_arena arena;
+
+    /* Emulated terminal (app->output, NULL until
+     * tui_test_renderer_set_terminal()): the bytes of each frame are
+     * kept for inspection */
+    char *frame;            /* Bytes the last frame sent to the terminal */
+    size_t frame_len;
+    size_t frame_capacity;
 } tui_test_renderer;
 
 /**
@@ -80,11 +90,55 @@ void tui_test_renderer_destroy(tui_test_renderer *renderer);
 /**
  * Render a node tree to the test buffer.
  *
+ * Like the app on re-render, root is reconciled into the current tree:
+ * matched nodes are patched and keep their Yoga nodes and focus, and
+ * root itself is consumed. The first render focuses the node built with
+ * focused set; focus is dropped when the patch destroys that node.
+ * The frame is drawn by tui_app_render_tree(): only damaged areas are
+ * redrawn, layers are composited, and the output diff runs when a
+ * terminal is attached.
+ *
  * @param renderer The test renderer
  * @param root Root node of the tree to render
  */
 void tui_test_renderer_render(tui_test_renderer *renderer, tui_node *root);
 
+/**
+ * Arena to build the next frame's tree in (tui.node_arena), emptied.
+ * The current tree never lives in it: the reconciler moves the nodes it
+ * keeps to the heap.
+ *
+ * @param renderer The test renderer
+ * @return Arena for the next tree
+ */
+tui_arena* tui_test_renderer_frame_arena(tui_test_renderer *renderer);
+
+/**
+ * Attach an emulated terminal. From the next frame on, the app's output
+ * stage diffs and encodes each frame, starting from a blank screen.
+ * Replaces any earlier terminal. Inline, the app draws a live region
+ * below the cursor as it does without fullscreen, and prints the items
+ * of Static nodes above it.
+ *
+ * @param renderer The test renderer
+ * @param capabilities TUI_CAP_* flags the encoder may use (REP, OSC 8)
+ * @param color_depth Colors the terminal shows: 16777216, 256, 16, 8 or 0
+ * @param threads Band encoding threads (0 = serial)
+ * @param inline_mode 1 for an inline app, 0 for fullscreen
+ * @return 0 on success, -1 on allocation failure
+ */
+int tui_test_renderer_set_terminal(tui_test_renderer *renderer, unsigned int capabilities,
+                                   int color_depth, int threads, int inline_mode);
+
+/**
+ * Bytes the last frame sent to the emulated terminal.
+ *
+ * @param renderer The test renderer
+ * @param len Output: number of bytes
+ * @return Frame bytes (owned by the renderer), or NULL without a terminal
+ */
+const char* tui_test_renderer_get_frame(tui_test_renderer *renderer, size_t *len);
+
 /**
  * Get the rendered output as a 2D array of strings.
  * Each string is one row of the buffer.
@@ -129,26 +183,53 @@ void tui_test_renderer_send_input(tui_test_renderer *renderer, const char *input
 void tui_test_renderer_send_key(tui_test_renderer *renderer, int key_code);
 
 /**
- * Advance one frame - process input and re-render.
+ * Show a tree as an overlay layer (tui_app_add_layer()). As inside the
+ * app's event loop, the change is only scheduled: the next
+ * tui_test_renderer_advance_frame() draws it.
  *
  * @param renderer The test renderer
+ * @param root Layer tree (consumed, also on failure)
+ * @param z_index Stacking order
+ * @return Layer ID, or -1 on allocation failure
  */
-void tui_test_renderer_advance_frame(tui_test_renderer *renderer);
+int tui_test_renderer_add_layer(tui_test_renderer *renderer, tui_node *root, int z_index);
 
 /**
- * Advance simulated time and run due timers.
+ * Reconcile a new tree into a layer (tui_app_update_layer()); drawn by
+ * the next tui_test_renderer_advance_frame().
  *
  * @param renderer The test renderer
- * @param ms Milliseconds to advance
+ * @param id Layer ID
+ * @param root New tree (consumed, also on failure)
+ * @return 0 on success, -1 if there is no such layer
  */
-void tui_test_renderer_run_timers(tui_test_renderer *renderer, int ms);
+int tui_test_renderer_update_layer(tui_test_renderer *renderer, int id, tui_node *root);
+
+/**
+ * Remove a layer (tui_app_remove_layer()); the next
+ * tui_test_renderer_advance_frame() uncovers what was below it.
+ *
+ * @param renderer The test renderer
+ * @param id Layer ID
+ * @return 0 on success, -1 if there is no such layer
+ */
+int tui_test_renderer_remove_layer(tui_test_renderer *renderer, int id);
 
 /**
- * Set the app instance for the test renderer (for hooks/state).
+ * Advance one frame: process queued input, then draw whatever was
+ * requested since the last frame (input, focus changes) as one
+ * frame, the way the app's frame scheduler does.
  *
  * @param renderer The test renderer
- * @param app The app instance
  */
-void tui_test_renderer_set_app(tui_test_renderer *renderer, tui_app *app);
+void tui_test_renderer_advance_frame(tui_test_renderer *renderer);
+
+/**
+ * Advance simulated time and run due timers.
+ *
+ * @param renderer The test renderer
+ * @param ms Milliseconds to advance
+ */
+void tui_test_renderer_run_timers(tui_test_renderer *renderer, int ms);
 
 #endif /* TUI_TESTING_RENDERER_H */
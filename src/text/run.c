@@ -0,0 +1,178 @@
+/*
+  +----------------------------------------------------------------------+
+  | ext-tui: Glyph runs                                                 |
+  +----------------------------------------------------------------------+
+*/
+
+#include "run.h"
+#include "measure.h"
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+
+tui_text_run* tui_text_run_create(const char *text)
+{
+    if (!text) return NULL;
+
+    size_t len = strlen(text);
+    if (len > INT_MAX) return NULL;
+
+    tui_text_run *run = calloc(1, sizeof(tui_text_run));
+    if (!run) return NULL;
+
+    /* One glyph per byte at most; shrunk below once the count is known */
+    run->glyphs = malloc((len ? len : 1) * sizeof(tui_glyph));
+    if (!run->glyphs) {
+        free(run);
+        return NULL;
+    }
+
+    run->bytes = (int)len;
+    run->lines = 1;
+
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (unsigned char)text[i];
+        hash *= 1099511628211ULL;
+    }
+    run->hash = hash;
+
+    const char *p = text;
+    while (*p) {
+        tui_glyph *g = &run->glyphs[run->count++];
+        unsigned char c = (unsigned char)*p;
+        uint32_t codepoint;
+        int bytes = tui_utf8_decode(p, &codepoint);
+        if (bytes <= 0) bytes = 1;
+
+        int width = tui_char_width(codepoint);
+
+        g->offset = (uint32_t)(p - text);
+        g->width = (uint8_t)(width > 0 ? width : 0);
+        g->flags = 0;
+        g->reserved = 0;
+
+        /* Same classes as the byte checks in tui_wrap_text() */
+        if (isspace(c)) g->flags |= TUI_GLYPH_SPACE | TUI_GLYPH_BREAK;
+        if (c == '-') g->flags |= TUI_GLYPH_BREAK;
+        if (c == '\n') {
+            g->flags |= TUI_GLYPH_NEWLINE;
+            run->lines++;
+        }
+
+        p += bytes;
+    }
+
+    if (run->count > 0 && (size_t)run->count < len) {
+        tui_glyph *glyphs = realloc(run->glyphs, (size_t)run->count * sizeof(tui_glyph));
+        if (glyphs) run->glyphs = glyphs;
+    }
+
+    /* Measured separately: ANSI sequences, ZWJ and flags don't add up
+     * glyph by glyph */
+    run->width = tui_string_width(text);
+
+    return run;
+}
+
+void tui_text_run_free(tui_text_run *run)
+{
+    if (run) {
+        free(run->glyphs);
+        free(run);
+    }
+}
+
+int tui_text_run_fit(const tui_text_run *run, int max_width, int *width)
+{
+    int used = 0;
+    int i = 0;
+
+    for (; i < run->count; i++) {
+        if (used + run->glyphs[i].width > max_width) break;
+        used += run->glyphs[i].width;
+    }
+
+    if (width) *width = used;
+    return i;
+}
+
+/* ----------------------------------------------------------------
+ * Wrapping
+ * ---------------------------------------------------------------- */
+
+void tui_wrap_iter_init(tui_wrap_iter *it, const tui_text_run *run, int width, tui_wrap_mode mode)
+{
+    it->run = run;
+    it->width = width;
+    it->mode = mode;
+    it->pos = 0;
+    it->line_start = 0;
+}
+
+static inline int glyph_offset(const tui_text_run *run, int i)
+{
+    return i < run->count ? (int)run->glyphs[i].offset : run->bytes;
+}
+
+/* Emit glyphs [line_start, end) */
+static int wrap_emit(tui_wrap_iter *it, int end, int *offset, int *len)
+{
+    *offset = glyph_offset(it->run, it->line_start);
+    *len = glyph_offset(it->run, end) - *offset;
+    return 1;
+}
+
+int tui_wrap_iter_next(tui_wrap_iter *it, int *offset, int *len)
+{
+    const tui_text_run *run = it->run;
+    const tui_glyph *glyphs = run->glyphs;
+    int last_break = -1;
+    int current_width = 0;
+
+    while (it->pos < run->count) {
+        const tui_glyph *g = &glyphs[it->pos];
+
+        if (g->flags & TUI_GLYPH_NEWLINE) {
+            wrap_emit(it, it->pos, offset, len);
+            it->pos++;
+            it->line_start = it->pos;
+            return 1;
+        }
+
+        if (g->flags & TUI_GLYPH_BREAK) last_break = it->pos;
+
+        if (current_width + g->width > it->width) {
+            if ((it->mode == TUI_WRAP_WORD || it->mode == TUI_WRAP_WORD_CHAR) &&
+                last_break > it->line_start) {
+                /* Wrap at the word boundary, dropping the spaces there */
+                wrap_emit(it, last_break, offset, len);
+                it->pos = last_break;
+                while (it->pos < run->count && (glyphs[it->pos].flags & TUI_GLYPH_SPACE)) {
+                    it->pos++;
+                }
+                it->line_start = it->pos;
+                return 1;
+            }
+
+            if ((it->mode == TUI_WRAP_CHAR || it->mode == TUI_WRAP_WORD_CHAR) &&
+                it->pos > it->line_start) {
+                wrap_emit(it, it->pos, offset, len);
+                it->line_start = it->pos;
+                return 1;
+            }
+        }
+
+        current_width += g->width;
+        it->pos++;
+    }
+
+    /* Remaining text */
+    if (it->pos > it->line_start) {
+        wrap_emit(it, it->pos, offset, len);
+        it->line_start = it->pos;
+        return 1;
+    }
+    return 0;
+}
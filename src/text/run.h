@@ -0,0 +1,98 @@
+/*
+  +----------------------------------------------------------------------+
+  | ext-tui: Glyph runs                                                 |
+  +----------------------------------------------------------------------+
+  | A text decoded once into glyphs (byte offset, width, break class)   |
+  | plus its display width and hard line count. Text nodes keep one so  |
+  | Yoga's repeated measure calls, wrapping and truncation don't decode |
+  | the same UTF-8 again each time.                                     |
+  |                                                                      |
+  | The run doesn't own the text: offsets refer to the string it was    |
+  | built from, which must outlive it unchanged.                        |
+  +----------------------------------------------------------------------+
+*/
+
+#ifndef TUI_TEXT_RUN_H
+#define TUI_TEXT_RUN_H
+
+#include "wrap.h"
+#include <stdint.h>
+
+/* Glyph flags */
+#define TUI_GLYPH_BREAK   0x01  /* Word wrap may break before it (space, '-') */
+#define TUI_GLYPH_SPACE   0x02  /* Whitespace, dropped at a word wrap */
+#define TUI_GLYPH_NEWLINE 0x04  /* Hard line break */
+
+typedef struct {
+    uint32_t offset;    /* Byte offset into the text */
+    uint8_t width;      /* tui_char_width() of the codepoint */
+    uint8_t flags;      /* TUI_GLYPH_* */
+    uint16_t reserved;
+} tui_glyph;            /* 8 bytes */
+
+typedef struct {
+    tui_glyph *glyphs;
+    int count;
+    int bytes;          /* Length of the text */
+    int width;          /* tui_string_width() of the whole text */
+    int lines;          /* Hard lines ('\n' count + 1) */
+    uint64_t hash;      /* FNV-1a of the text bytes (wrap cache key) */
+} tui_text_run;
+
+/**
+ * Decode text into a run.
+ * @param text UTF-8 text
+ * @return New run, or NULL on allocation failure or NULL text
+ */
+tui_text_run* tui_text_run_create(const char *text);
+
+/**
+ * Free a run.
+ * @param run Run (NULL-safe)
+ */
+void tui_text_run_free(tui_text_run *run);
+
+/**
+ * Leading glyphs that fit in max_width columns, stopping at the first
+ * one that doesn't (as tui_truncate_text() cuts).
+ * @param run       Run
+ * @param max_width Columns available
+ * @param width     Receives the columns those glyphs take (may be NULL)
+ * @return Number of glyphs
+ */
+int tui_text_run_fit(const tui_text_run *run, int max_width, int *width);
+
+/* ----------------------------------------------------------------
+ * Wrapping
+ * ----------------------------------------------------------------
+ * Produces the same lines as tui_wrap_text(), one at a time and as byte
+ * ranges of the original text, so nothing is copied or allocated.
+ */
+
+typedef struct {
+    const tui_text_run *run;
+    int width;
+    tui_wrap_mode mode;
+    int pos;            /* Next glyph to look at */
+    int line_start;     /* First glyph of the line being built */
+} tui_wrap_iter;
+
+/**
+ * Start wrapping a run.
+ * @param it    Iterator
+ * @param run   Run to wrap
+ * @param width Maximum display width per line (>= 1)
+ * @param mode  TUI_WRAP_CHAR, TUI_WRAP_WORD or TUI_WRAP_WORD_CHAR
+ */
+void tui_wrap_iter_init(tui_wrap_iter *it, const tui_text_run *run, int width, tui_wrap_mode mode);
+
+/**
+ * Next wrapped line.
+ * @param it     Iterator
+ * @param offset Receives the line's byte offset into the text
+ * @param len    Receives the line's length in bytes
+ * @return 1 if a line was produced, 0 when done
+ */
+int tui_wrap_iter_next(tui_wrap_iter *it, int *offset, int *len);
+
+#endif /* TUI_TEXT_RUN_H */
@@ -0,0 +1,42 @@
+--TEST--
+Telemetry: output cost metrics
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+tui_metrics_enable();
+tui_metrics_reset();
+
+$m = tui_get_render_metrics();
+foreach (['output_bytes', 'output_writes', 'cells_changed', 'rows_touched',
+          'cursor_moves', 'sgr_sequences', 'full_redraws'] as $key) {
+    var_dump($m[$key] === 0);
+}
+
+var_dump(is_array($m['last_frame']));
+var_dump($m['last_frame']['bytes'] === 0);
+var_dump($m['last_frame']['writes'] === 0);
+var_dump($m['last_frame']['full_redraw'] === false);
+
+$m = tui_get_metrics();
+var_dump(array_key_exists('output_bytes', $m));
+var_dump(array_key_exists('full_redraws', $m));
+
+tui_metrics_disable();
+echo "Done\n";
+?>
+--EXPECT--
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+Done
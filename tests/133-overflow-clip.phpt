@@ -0,0 +1,44 @@
+--TEST--
+Overflow hidden clips children to the box
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+use Xocdr\Tui\Ext\ContainerNode;
+use Xocdr\Tui\Ext\ContentNode;
+
+function render_rows($box) {
+    $renderer = tui_test_create(20, 4);
+    tui_test_render($renderer, $box);
+    $rows = array_map('rtrim', tui_test_get_output($renderer));
+    tui_test_destroy($renderer);
+    return $rows;
+}
+
+// Visible: the long child spills past the 5-cell box
+$box = new ContainerNode(['width' => 5, 'height' => 1]);
+$box->children = [new ContainerNode(['width' => 12, 'height' => 1, 'flexShrink' => 0])];
+$box->children[0]->children = [new ContentNode("Hello World!")];
+var_dump(render_rows($box)[0]);
+
+// Hidden: cut at the box edge
+$box = new ContainerNode(['width' => 5, 'height' => 1, 'overflow' => 'hidden']);
+$box->children = [new ContainerNode(['width' => 12, 'height' => 1, 'flexShrink' => 0])];
+$box->children[0]->children = [new ContentNode("Hello World!")];
+var_dump(render_rows($box)[0]);
+
+// overflowY only: rows below the box are cut, columns are not
+$box = new ContainerNode(['width' => 5, 'height' => 1, 'overflowY' => 'hidden']);
+$box->children = [new ContainerNode(['width' => 12, 'height' => 2, 'flexShrink' => 0])];
+$box->children[0]->children = [new ContentNode("Hello World!"), new ContentNode("second")];
+$rows = render_rows($box);
+var_dump($rows[0], $rows[1]);
+
+echo "Done\n";
+?>
+--EXPECT--
+string(12) "Hello World!"
+string(5) "Hello"
+string(12) "Hello World!"
+string(0) ""
+Done
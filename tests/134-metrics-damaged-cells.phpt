@@ -0,0 +1,24 @@
+--TEST--
+Telemetry: damaged cell metrics
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+tui_metrics_enable();
+tui_metrics_reset();
+
+$m = tui_get_render_metrics();
+var_dump($m['damaged_cells'] === 0);
+var_dump($m['last_frame']['damaged_cells'] === 0);
+
+$m = tui_get_metrics();
+var_dump(array_key_exists('damaged_cells', $m));
+
+tui_metrics_disable();
+echo "Done\n";
+?>
+--EXPECT--
+bool(true)
+bool(true)
+bool(true)
+Done
@@ -0,0 +1,28 @@
+--TEST--
+Instance layer methods
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+use Xocdr\Tui\Ext\Instance;
+
+foreach (['addLayer', 'updateLayer', 'removeLayer'] as $method) {
+    echo "$method: " . (method_exists(Instance::class, $method) ? 'yes' : 'no') . "\n";
+}
+
+$m = new ReflectionMethod(Instance::class, 'addLayer');
+echo $m->getNumberOfParameters(), " ", $m->getNumberOfRequiredParameters(), " ", $m->getReturnType(), "\n";
+
+$m = new ReflectionMethod(Instance::class, 'updateLayer');
+echo $m->getNumberOfParameters(), " ", $m->getNumberOfRequiredParameters(), " ", $m->getReturnType(), "\n";
+
+$m = new ReflectionMethod(Instance::class, 'removeLayer');
+echo $m->getNumberOfParameters(), " ", $m->getNumberOfRequiredParameters(), " ", $m->getReturnType(), "\n";
+?>
+--EXPECT--
+addLayer: yes
+updateLayer: yes
+removeLayer: yes
+2 1 int
+2 2 void
+1 1 void
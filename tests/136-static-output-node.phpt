@@ -0,0 +1,39 @@
+--TEST--
+StaticOutput builds a static node that renders its children like a box
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+use Xocdr\Tui\Ext\ContainerNode;
+use Xocdr\Tui\Ext\ContentNode;
+use Xocdr\Tui\Ext\StaticOutput;
+
+tui_metrics_enable();
+tui_metrics_reset();
+
+$renderer = tui_test_create(40, 6);
+
+$log = new StaticOutput();
+$log->id = "log";
+$log->children = [new ContentNode("built a"), new ContentNode("built b")];
+
+$root = new ContainerNode(['width' => 40, 'height' => 6]);
+$root->children = [$log, new ContentNode("working...")];
+
+tui_test_render($renderer, $root);
+
+$node = tui_test_get_by_id($renderer, "log");
+var_dump($node['type']);
+var_dump(tui_get_node_metrics()['static_count']);
+
+$output = tui_test_get_output($renderer);
+echo rtrim($output[0]), "\n", rtrim($output[1]), "\n", rtrim($output[2]), "\n";
+
+tui_test_destroy($renderer);
+?>
+--EXPECT--
+string(6) "static"
+int(1)
+built a
+built b
+working...
@@ -0,0 +1,36 @@
+--TEST--
+Multi-codepoint grapheme clusters are kept whole in one cell
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+use Xocdr\Tui\Ext\ContainerNode;
+use Xocdr\Tui\Ext\ContentNode;
+
+$family = "\u{1F468}\u{200D}\u{1F469}\u{200D}\u{1F467}";
+$flag = "\u{1F1EF}\u{1F1F5}";
+$accent = "e\u{0301}";
+
+$renderer = tui_test_create(20, 3);
+
+$root = new ContainerNode(['width' => 20, 'height' => 3, 'flexDirection' => 'column']);
+$root->children = [
+    new ContentNode("a{$family}b"),
+    new ContentNode("{$flag}{$accent}x"),
+    new ContentNode("{$family}{$family}"),
+];
+
+tui_test_render($renderer, $root);
+$output = tui_test_get_output($renderer);
+
+// Wide clusters take two cells, the second one prints as a blank
+var_dump($output[0] === "a{$family} b");
+var_dump($output[1] === "{$flag} {$accent}x");
+var_dump($output[2] === "{$family} {$family}");
+
+tui_test_destroy($renderer);
+?>
+--EXPECT--
+bool(true)
+bool(true)
+bool(true)
@@ -0,0 +1,40 @@
+--TEST--
+Hyperlinked text renders like plain text and link output is counted
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+use Xocdr\Tui\Ext\ContainerNode;
+use Xocdr\Tui\Ext\ContentNode;
+
+tui_metrics_enable();
+tui_metrics_reset();
+
+$renderer = tui_test_create(30, 3);
+
+$plain = new ContentNode("src/app.php");
+$linked = new ContentNode("src/app.php");
+$linked->hyperlink = "file:///src/app.php";
+$grouped = new ContentNode("src/tui.c");
+$grouped->hyperlink = ['url' => 'file:///src/tui.c', 'id' => 'tui'];
+
+$root = new ContainerNode(['width' => 30, 'height' => 3, 'flexDirection' => 'column']);
+$root->children = [$plain, $linked, $grouped];
+
+tui_test_render($renderer, $root);
+$output = tui_test_get_output($renderer);
+var_dump($output[0] === $output[1]);
+var_dump($output[2]);
+
+$m = tui_get_render_metrics();
+var_dump($m['link_sequences']);
+var_dump($m['last_frame']['link_sequences']);
+
+tui_test_destroy($renderer);
+tui_metrics_disable();
+?>
+--EXPECT--
+bool(true)
+string(9) "src/tui.c"
+int(0)
+int(0)
@@ -0,0 +1,24 @@
+--TEST--
+tui_buffer_render() streams rows with minimal SGR transitions
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+$buffer = tui_buffer_create(6, 2);
+tui_fill_rect($buffer, 0, 0, 6, 2, '.');
+tui_fill_rect($buffer, 1, 0, 2, 1, '#', ['bold' => true]);
+tui_fill_rect($buffer, 3, 0, 1, 1, '#', ['bold' => true]);
+
+// One SGR for the whole bold run, one reset where it ends
+$output = tui_buffer_render($buffer);
+echo str_replace("\e", '\e', $output), "\n";
+
+// Large buffers render without a worst-case allocation
+$large = tui_buffer_create(500, 500);
+tui_fill_rect($large, 0, 0, 500, 500, 'x');
+var_dump(strlen(tui_buffer_render($large)));
+?>
+--EXPECT--
+.\e[1m###\e[m..
+......
+int(250499)
@@ -0,0 +1,19 @@
+--TEST--
+Output: tui.encode_threads INI setting
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+// Banded encoding is off unless asked for
+var_dump(ini_get('tui.encode_threads'));
+
+// Read when an app starts, so it can be changed at runtime
+var_dump(ini_set('tui.encode_threads', '4'));
+var_dump(ini_get('tui.encode_threads'));
+echo "Done\n";
+?>
+--EXPECT--
+string(1) "0"
+string(1) "0"
+string(1) "4"
+Done
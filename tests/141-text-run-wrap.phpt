@@ -0,0 +1,45 @@
+--TEST--
+Text nodes wrap and truncate from their glyph run across re-renders
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+use Xocdr\Tui\Ext\ContainerNode;
+use Xocdr\Tui\Ext\ContentNode;
+
+$renderer = tui_test_create(10, 5);
+
+$tree = function (string $wrapped, string $line) {
+    $root = new ContainerNode(['width' => 10, 'height' => 5, 'flexDirection' => 'column']);
+    $root->children = [
+        new ContentNode("$wrapped\nx", ['wrap' => 'word']),
+        new ContentNode($line),
+        new ContentNode("ab\ncd"),
+    ];
+    return $root;
+};
+
+tui_test_render($renderer, $tree('hello big world', 'truncate this line'));
+foreach (tui_test_get_output($renderer) as $line) {
+    echo $line, "|\n";
+}
+
+// New text replaces the old glyph run
+tui_test_render($renderer, $tree('one-two three', 'shorter'));
+foreach (tui_test_get_output($renderer) as $line) {
+    echo $line, "|\n";
+}
+
+tui_test_destroy($renderer);
+?>
+--EXPECT--
+hello big|
+world|
+truncate …|
+ab|
+cd|
+one-two|
+three|
+shorter|
+ab|
+cd|
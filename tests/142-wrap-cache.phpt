@@ -0,0 +1,57 @@
+--TEST--
+Wrapped text lines are reused across frames from the wrap cache
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+use Xocdr\Tui\Ext\ContainerNode;
+use Xocdr\Tui\Ext\ContentNode;
+
+function screen(int $width, ?string $color = null) {
+    return new ContainerNode(['width' => 12, 'height' => 4, 'children' => [
+        new ContainerNode(['flexDirection' => 'row', 'width' => $width, 'height' => 4, 'children' => [
+            new ContentNode('the quick brown fox', ['wrap' => 'word', 'color' => $color]),
+        ]]),
+    ]]);
+}
+
+function step($renderer, string $label, array $before) {
+    $after = tui_get_pool_metrics();
+    $rows = array_map('rtrim', tui_test_get_output($renderer));
+    echo $label, ": ", implode('|', $rows),
+        " hits=", $after['wrap_cache_hits'] - $before['wrap_cache_hits'],
+        " misses=", $after['wrap_cache_misses'] - $before['wrap_cache_misses'], "\n";
+}
+
+$renderer = tui_test_create(12, 4);
+
+$before = tui_get_pool_metrics();
+tui_test_render($renderer, screen(10));
+step($renderer, 'first', $before);
+
+// Nothing changed, nothing is drawn
+$before = tui_get_pool_metrics();
+tui_test_render($renderer, screen(10));
+step($renderer, 'same', $before);
+
+// Redrawn in a new color: same text at the same width
+$before = tui_get_pool_metrics();
+tui_test_render($renderer, screen(10, 'red'));
+step($renderer, 'recolor', $before);
+
+// A new width is a new entry; the old one is still there
+$before = tui_get_pool_metrics();
+tui_test_render($renderer, screen(6, 'red'));
+step($renderer, 'narrow', $before);
+$before = tui_get_pool_metrics();
+tui_test_render($renderer, screen(10));
+step($renderer, 'wide', $before);
+
+tui_test_destroy($renderer);
+?>
+--EXPECT--
+first: the quick|brown fox|| hits=0 misses=1
+same: the quick|brown fox|| hits=0 misses=0
+recolor: the quick|brown fox|| hits=1 misses=0
+narrow: the|quick|brown|fox hits=0 misses=1
+wide: the quick|brown fox|| hits=1 misses=0
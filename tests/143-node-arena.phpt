@@ -0,0 +1,63 @@
+--TEST--
+Node arena: per-frame trees built in a bump arena render the same, and only new nodes move to the heap
+--EXTENSIONS--
+tui
+--INI--
+tui.node_arena=1
+--FILE--
+<?php
+use Xocdr\Tui\Ext\ContainerNode;
+use Xocdr\Tui\Ext\ContentNode;
+
+var_dump(ini_get('tui.node_arena'));
+
+function screen(int $i, bool $extra = false) {
+    $children = [new ContentNode("frame $i"), new ContentNode(str_repeat('ab', $i))];
+    if ($extra) {
+        $children[] = new ContentNode('new');
+    }
+    return new ContainerNode(['width' => 12, 'height' => 3, 'children' => $children]);
+}
+
+function step($renderer, string $label, int $before) {
+    $rows = array_map('rtrim', tui_test_get_output($renderer));
+    echo $label, ": ", implode('|', $rows), " promoted=",
+        tui_get_pool_metrics()['arena_promotions'] - $before, "\n";
+}
+
+$renderer = tui_test_create(12, 3);
+
+// The first tree becomes the live one
+$before = tui_get_pool_metrics()['arena_promotions'];
+tui_test_render($renderer, screen(1));
+step($renderer, 'first', $before);
+
+// Later trees are patched into it; their nodes stay in the arena
+$before = tui_get_pool_metrics()['arena_promotions'];
+tui_test_render($renderer, screen(2));
+step($renderer, 'text', $before);
+
+// A node the live tree doesn't have is moved to the heap
+$before = tui_get_pool_metrics()['arena_promotions'];
+tui_test_render($renderer, screen(3, true));
+step($renderer, 'added', $before);
+
+$before = tui_get_pool_metrics()['arena_promotions'];
+for ($i = 4; $i <= 5; $i++) {
+    tui_test_render($renderer, screen($i, true));
+}
+step($renderer, 'frames', $before);
+
+$before = tui_get_pool_metrics()['arena_promotions'];
+tui_test_render($renderer, screen(6));
+step($renderer, 'removed', $before);
+
+tui_test_destroy($renderer);
+?>
+--EXPECT--
+string(1) "1"
+first: frame 1|ab| promoted=3
+text: frame 2|abab| promoted=0
+added: frame 3|ababab|new promoted=1
+frames: frame 5|ababababab|new promoted=0
+removed: frame 6|abababababab| promoted=0
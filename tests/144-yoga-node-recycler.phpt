@@ -0,0 +1,54 @@
+--TEST--
+Object pool: Yoga nodes of destroyed trees are recycled
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+use Xocdr\Tui\Ext\ContainerNode;
+use Xocdr\Tui\Ext\ContentNode;
+
+function screen(string $label) {
+    return new ContainerNode(['width' => 20, 'height' => 4, 'padding' => 1, 'children' => [
+        new ContainerNode(['flexDirection' => 'row', 'children' => [
+            new ContentNode($label), new ContentNode('!'),
+        ]]),
+    ]]);
+}
+
+function step($renderer, string $label, array $before) {
+    $after = tui_get_pool_metrics();
+    $rows = array_map('rtrim', tui_test_get_output($renderer));
+    echo $label, ": ", implode('|', $rows),
+        " allocs=", $after['yoga_allocs'] - $before['yoga_allocs'],
+        " fallbacks=", $after['yoga_fallbacks'] - $before['yoga_fallbacks'],
+        " reuses=", $after['yoga_reuses'] - $before['yoga_reuses'], "\n";
+}
+
+$renderer = tui_test_create(20, 4);
+
+// Nothing to recycle yet
+$before = tui_get_pool_metrics();
+tui_test_render($renderer, screen('first'));
+step($renderer, 'first', $before);
+
+// The new tree is patched into the live one and destroyed: its nodes go
+// back to the pool, and the next tree is built from them
+$before = tui_get_pool_metrics();
+tui_test_render($renderer, screen('second'));
+step($renderer, 'second', $before);
+$before = tui_get_pool_metrics();
+tui_test_render($renderer, screen('third'));
+step($renderer, 'third', $before);
+
+// Recycled nodes start from a clean style: no padding left over
+$before = tui_get_pool_metrics();
+tui_test_render($renderer, new ContainerNode(['children' => [new ContentNode('gone')]]));
+step($renderer, 'replaced', $before);
+
+tui_test_destroy($renderer);
+?>
+--EXPECT--
+first: | first!|| allocs=0 fallbacks=4 reuses=0
+second: | second!|| allocs=0 fallbacks=4 reuses=4
+third: | third!|| allocs=4 fallbacks=0 reuses=4
+replaced: gone||| allocs=2 fallbacks=0 reuses=4
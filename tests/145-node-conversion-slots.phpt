@@ -0,0 +1,56 @@
+--TEST--
+Node conversion: slot reads, keyword lookup and cached color parsing
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+use Xocdr\Tui\Ext\ContainerNode;
+use Xocdr\Tui\Ext\ContentNode;
+
+function step($renderer, string $label) {
+    echo $label, ": ", implode('|', array_map('rtrim', tui_test_get_output($renderer))), "\n";
+}
+
+$renderer = tui_test_create(10, 3);
+
+// Keywords from the perfect hash table
+tui_test_render($renderer, new ContainerNode(['width' => 10, 'flexDirection' => 'row',
+    'justifyContent' => 'flex-end', 'children' => [new ContentNode('ab'), new ContentNode('cd')]]));
+step($renderer, 'flex-end');
+tui_test_render($renderer, new ContainerNode(['width' => 4, 'height' => 3, 'borderStyle' => 'round',
+    'children' => [new ContentNode('x')]]));
+step($renderer, 'round');
+
+// Unknown keywords keep the defaults
+tui_test_render($renderer, new ContainerNode(['flexDirection' => 'sideways', 'borderStyle' => 'Round',
+    'children' => [new ContentNode('ab'), new ContentNode('cd')]]));
+step($renderer, 'unknown');
+
+// An unset property has no slot value and goes through __get()
+class RowBox extends ContainerNode {
+    public function __get($name) {
+        return $name === 'flexDirection' ? 'row' : null;
+    }
+}
+$magic = new RowBox(['width' => 10, 'children' => [new ContentNode('ab'), new ContentNode('cd')]]);
+unset($magic->flexDirection);
+tui_test_render($renderer, $magic);
+step($renderer, '__get');
+
+// The same color literal is parsed once
+$before = tui_get_pool_metrics();
+for ($i = 0; $i < 3; $i++) {
+    tui_test_render($renderer, new ContentNode('hi', ['color' => 'coral']));
+}
+$after = tui_get_pool_metrics();
+echo "color: hits=", $after['color_cache_hits'] - $before['color_cache_hits'],
+    " misses=", $after['color_cache_misses'] - $before['color_cache_misses'], "\n";
+
+tui_test_destroy($renderer);
+?>
+--EXPECT--
+flex-end:       abcd||
+round: ╭──╮|│x │|╰──╯
+unknown: ab|cd|
+__get: abcd||
+color: hits=2 misses=1
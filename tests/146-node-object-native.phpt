@@ -0,0 +1,126 @@
+--TEST--
+Node objects: unchanged objects are copied, property writes rebuild them
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+use Xocdr\Tui\Ext\ContainerNode;
+use Xocdr\Tui\Ext\ContentNode;
+
+tui_metrics_enable();
+
+$m = tui_get_node_metrics();
+var_dump(array_key_exists('nodes_converted', $m));
+var_dump(array_key_exists('nodes_copied', $m));
+
+function show($renderer) {
+    foreach (tui_test_get_output($renderer) as $line) {
+        echo $line, "|\n";
+    }
+}
+
+function counts() {
+    $m = tui_get_node_metrics();
+    echo "converted={$m['nodes_converted']} copied={$m['nodes_copied']}\n";
+}
+
+$renderer = tui_test_create(10, 1);
+
+$a = new ContentNode('ab');
+$b = new ContentNode('cd');
+$row = new ContainerNode(['width' => 10, 'flexDirection' => 'row', 'children' => [$a, $b]]);
+
+tui_metrics_reset();
+
+// First render converts, the second one only copies
+tui_test_render($renderer, $row);
+counts();
+tui_test_render($renderer, $row);
+counts();
+show($renderer);
+
+// A plain write rebuilds that object only
+$a->content = 'xy';
+tui_test_render($renderer, $row);
+counts();
+show($renderer);
+
+// Writes through a reference
+$ref = &$row->justifyContent;
+$ref = 'flex-end';
+tui_test_render($renderer, $row);
+show($renderer);
+$ref = 'flex-start';
+tui_test_render($renderer, $row);
+show($renderer);
+unset($ref);
+
+// Compound assignment
+$row->paddingLeft++;
+tui_test_render($renderer, $row);
+show($renderer);
+
+// A clone starts out with its own node
+$c = clone $b;
+$c->content = 'ef';
+$row->children = [$a, $b, $c];
+tui_test_render($renderer, $row);
+show($renderer);
+
+// foreach by reference
+foreach ($b as $name => &$value) {
+    if ($name === 'content') {
+        $value = 'CD';
+    }
+}
+unset($value);
+tui_test_render($renderer, $row);
+show($renderer);
+
+tui_test_destroy($renderer);
+
+// Arrays holding references change without a write to the object
+function frame($renderer) {
+    echo str_replace("\e", '\e', tui_test_get_frame($renderer)), "\n";
+}
+
+$term = tui_test_create(4, 1);
+tui_test_set_terminal($term);
+
+$c = [255, 0, 0];
+$r = &$c[0];
+$colored = new ContentNode('ab');
+$colored->color = $c;
+tui_test_render($term, $colored);
+frame($term);
+$r = 9;
+tui_test_render($term, $colored);
+frame($term);
+
+$u = 'https://a.test/1';
+$linked = new ContentNode('ab', ['hyperlink' => ['url' => &$u]]);
+tui_test_render($term, $linked);
+frame($term);
+$u = 'https://a.test/2';
+tui_test_render($term, $linked);
+frame($term);
+
+tui_test_destroy($term);
+?>
+--EXPECT--
+bool(true)
+bool(true)
+converted=3 copied=0
+converted=3 copied=3
+abcd|
+converted=4 copied=5
+xycd|
+      xycd|
+xycd|
+ xycd|
+ xycdef|
+ xyCDef|
+\e[?2026h\e[1;1H\e[38;2;255;0;0mab\e[0m\e[?25l\e[?2026l
+\e[?2026h\e[1;1H\e[38;2;9;0;0mab\e[0m\e[?25l\e[?2026l
+\e[?2026h\e[1;1H\e]8;;https://a.test/1\e\ab\e]8;;\e\\e[0m\e[?25l\e[?2026l
+\e[?2026h\e[1;1H\e]8;;https://a.test/2\e\ab\e]8;;\e\\e[0m\e[?25l\e[?2026l
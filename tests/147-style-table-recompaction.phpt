@@ -0,0 +1,24 @@
+--TEST--
+Buffer style table: compaction runs again once the table refills
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+// More distinct styles than one table holds (65535), twice over
+$buffer = tui_buffer_create(1, 1);
+$lost = 0;
+for ($i = 1; $i <= 140000; $i++) {
+    $rgb = [($i >> 16) & 255, ($i >> 8) & 255, $i & 255];
+    tui_fill_rect($buffer, 0, 0, 1, 1, '#', ['fg' => $rgb]);
+    if ($i % 10000 === 0 && !str_contains(tui_buffer_render($buffer), '38;2;' . implode(';', $rgb) . 'm#')) {
+        $lost++;
+    }
+}
+var_dump($lost);
+
+$output = tui_buffer_render($buffer);
+echo str_replace("\e", '\e', $output), "\n";
+?>
+--EXPECT--
+int(0)
+\e[38;2;2;34;96m#\e[m
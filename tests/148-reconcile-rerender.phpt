@@ -0,0 +1,80 @@
+--TEST--
+Re-rendering patches the previous tree: keyed reorder, insert/delete, root type change, focus
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+use Xocdr\Tui\Ext\ContainerNode;
+use Xocdr\Tui\Ext\ContentNode;
+
+tui_metrics_enable();
+
+function item(string $key, bool $focused = false) {
+    $box = new ContainerNode(['key' => $key, 'id' => $key, 'height' => 1,
+                              'focusable' => true, 'focused' => $focused]);
+    $box->children = [new ContentNode($key)];
+    return $box;
+}
+
+function root(array $items) {
+    $root = new ContainerNode(['width' => 6, 'height' => 3, 'flexDirection' => 'column']);
+    $root->children = $items;
+    return $root;
+}
+
+function show($renderer, string $label) {
+    $focused = tui_test_get_focused($renderer);
+    echo $label, ": ", implode('|', tui_test_get_output($renderer)),
+         " focused=", $focused ? $focused['id'] : 'none', "\n";
+}
+
+function ops() {
+    $m = tui_get_reconciler_metrics();
+    echo "  creates={$m['creates']} deletes={$m['deletes']} reorders={$m['reorders']}\n";
+    tui_metrics_reset();
+}
+
+$renderer = tui_test_create(6, 3);
+
+tui_test_render($renderer, root([item('a'), item('b', true), item('c')]));
+show($renderer, 'initial');
+tui_metrics_reset();
+
+// Keyed reorder: b is moved, not rebuilt, so it keeps its focus
+tui_test_render($renderer, root([item('c'), item('a'), item('b')]));
+show($renderer, 'reorder');
+var_dump(tui_test_get_by_id($renderer, 'b')['focused']);
+ops();
+
+// Delete a, insert x in the middle
+tui_test_render($renderer, root([item('c'), item('x'), item('b')]));
+show($renderer, 'insert');
+ops();
+
+// Deleting the focused node drops focus
+tui_test_render($renderer, root([item('c'), item('x')]));
+show($renderer, 'delete');
+ops();
+
+// Root type change swaps the whole tree
+tui_test_render($renderer, new ContentNode('plain'));
+show($renderer, 'text root');
+tui_test_render($renderer, root([item('a', true)]));
+show($renderer, 'box root');
+tui_test_render($renderer, new ContentNode('plain'));
+show($renderer, 'text root');
+
+tui_test_destroy($renderer);
+?>
+--EXPECT--
+initial: a|b|c focused=b
+reorder: c|a|b focused=b
+bool(true)
+  creates=0 deletes=0 reorders=2
+insert: c|x|b focused=b
+  creates=1 deletes=1 reorders=0
+delete: c|x| focused=none
+  creates=0 deletes=1 reorders=0
+text root: plain|| focused=none
+box root: a|| focused=a
+text root: plain|| focused=none
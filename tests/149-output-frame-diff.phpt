@@ -0,0 +1,81 @@
+--TEST--
+Output stage: frames carry only changed cells, with REP, ECH, EL and minimal SGR transitions
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+use Xocdr\Tui\Ext\ContainerNode;
+use Xocdr\Tui\Ext\ContentNode;
+
+tui_metrics_enable();
+
+function screen(array $rows) {
+    $root = new ContainerNode(['width' => 12, 'height' => count($rows), 'flexDirection' => 'column']);
+    $root->children = array_map(fn($row) => is_array($row)
+        ? new ContainerNode(['flexDirection' => 'row', 'height' => 1, 'children' => $row])
+        : new ContentNode($row), $rows);
+    return $root;
+}
+
+function frame($renderer, string $label) {
+    echo $label, ": ", str_replace("\e", '\e', tui_test_get_frame($renderer)), "\n";
+}
+
+$renderer = tui_test_create(12, 3);
+var_dump(tui_test_get_frame($renderer));
+tui_test_set_terminal($renderer);
+
+// Blank screen: trailing blanks are left alone, the rule is one REP
+tui_test_render($renderer, screen(['hello', '============', 'abc']));
+frame($renderer, 'first');
+
+// Only the changed cells; the rest of the row is erased with EL
+tui_test_render($renderer, screen(['help', '============', 'abc']));
+frame($renderer, 'edit');
+
+// Identical rows are skipped
+tui_test_render($renderer, screen(['help', '============', 'abc']));
+frame($renderer, 'same');
+
+// A run of blanks is repeated
+tui_test_render($renderer, screen(['help', '=          =', 'abc']));
+frame($renderer, 'gap');
+
+tui_test_render($renderer, screen(['help', '=          =', 'a']));
+frame($renderer, 'cut');
+
+// Each style change emits only the attributes that differ
+tui_test_render($renderer, screen([[
+    new ContentNode('help', ['color' => '#ff0000', 'bold' => true]),
+    new ContentNode('me', ['color' => '#ff0000']),
+    new ContentNode('!', ['color' => '#ff0000', 'underline' => true]),
+], '=          =', 'a']));
+frame($renderer, 'style');
+
+// The whole frame is queued and written at once
+$m = tui_get_render_metrics()['last_frame'];
+var_dump($m['writes'], $m['bytes'] === strlen(tui_test_get_frame($renderer)));
+
+// Without REP, blanks are erased with ECH
+$plain = tui_test_create(12, 1);
+tui_test_set_terminal($plain, ['rep' => false]);
+tui_test_render($plain, new ContentNode('============'));
+frame($plain, 'no rep');
+tui_test_render($plain, new ContentNode('=          ='));
+frame($plain, 'no rep gap');
+
+tui_test_destroy($plain);
+tui_test_destroy($renderer);
+?>
+--EXPECT--
+NULL
+first: \e[?2026h\e[1;1Hhello\e[2;1H=\e[11b\e[3;1Habc\e[0m\e[?25l\e[?2026l
+edit: \e[?2026h\e[1;4Hp\e[0K\e[0m\e[?25l\e[?2026l
+same: \e[?2026h\e[0m\e[?25l\e[?2026l
+gap: \e[?2026h\e[2;2H \e[9b\e[0m\e[?25l\e[?2026l
+cut: \e[?2026h\e[3;2H\e[0K\e[0m\e[?25l\e[?2026l
+style: \e[?2026h\e[1;1H\e[1;38;2;255;0;0mhelp\e[22mme\e[4m!\e[0m\e[?25l\e[?2026l
+int(1)
+bool(true)
+no rep: \e[?2026h\e[1;1H============\e[0m\e[?25l\e[?2026l
+no rep gap: \e[?2026h\e[1;2H\e[10X\e[0m\e[?25l\e[?2026l
@@ -0,0 +1,33 @@
+--TEST--
+Output stage: colors are quantized to what the terminal shows
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+use Xocdr\Tui\Ext\ContainerNode;
+use Xocdr\Tui\Ext\ContentNode;
+
+foreach ([16777216, 256, 16, 8, 0] as $colors) {
+    $renderer = tui_test_create(6, 1);
+    tui_test_set_terminal($renderer, ['colors' => $colors]);
+    tui_test_render($renderer, new ContainerNode(['flexDirection' => 'row', 'children' => [
+        new ContentNode('ab', ['color' => '#ff8000']),
+        new ContentNode('cd', ['color' => '#1e1ec8', 'backgroundColor' => '#f0f0f0']),
+    ]]));
+    echo $colors, ": ", str_replace("\e", '\e', tui_test_get_frame($renderer)), "\n";
+    tui_test_destroy($renderer);
+}
+
+try {
+    tui_test_set_terminal(tui_test_create(6, 1), ['colors' => 88]);
+} catch (ValueError $e) {
+    echo $e->getMessage(), "\n";
+}
+?>
+--EXPECT--
+16777216: \e[?2026h\e[1;1H\e[38;2;255;128;0mab\e[38;2;30;30;200;48;2;240;240;240mcd\e[0m\e[?25l\e[?2026l
+256: \e[?2026h\e[1;1H\e[38;5;208mab\e[38;5;20;48;5;255mcd\e[0m\e[?25l\e[?2026l
+16: \e[?2026h\e[1;1H\e[33mab\e[34;47mcd\e[0m\e[?25l\e[?2026l
+8: \e[?2026h\e[1;1H\e[33mab\e[34;47mcd\e[0m\e[?25l\e[?2026l
+0: \e[?2026h\e[1;1Habcd\e[0m\e[?25l\e[?2026l
+tui_test_set_terminal(): Argument #2 ($options) "colors" must be 16777216, 256, 16, 8 or 0
@@ -0,0 +1,53 @@
+--TEST--
+Output stage: shifted rows are scrolled in a region, fixed rows around them are kept
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+use Xocdr\Tui\Ext\ContainerNode;
+use Xocdr\Tui\Ext\ContentNode;
+
+function screen(int $width, array $rows) {
+    $root = new ContainerNode(['width' => $width, 'height' => count($rows), 'flexDirection' => 'column']);
+    $root->children = array_map(fn($row) => new ContentNode($row), $rows);
+    return $root;
+}
+
+function log_view(int $first) {
+    return screen(16, ['== log ==', ...array_map(fn($i) => "entry $i", range($first, $first + 4)), 'status: ok']);
+}
+
+function frame($renderer, string $label) {
+    echo $label, ": ", str_replace("\e", '\e', tui_test_get_frame($renderer)), "\n";
+}
+
+$renderer = tui_test_create(16, 7);
+tui_test_set_terminal($renderer);
+
+tui_test_render($renderer, log_view(1));
+frame($renderer, 'first');
+
+// Header and status bar stay out of the scroll region
+tui_test_render($renderer, log_view(2));
+frame($renderer, 'up 1');
+tui_test_render($renderer, log_view(4));
+frame($renderer, 'up 2');
+tui_test_render($renderer, log_view(3));
+frame($renderer, 'down 1');
+
+// Rows that already match below the band: scrolling would blank them
+$fixed = tui_test_create(12, 6);
+tui_test_set_terminal($fixed);
+tui_test_render($fixed, screen(12, ['alpha', 'bravo', 'charlie', 'delta', 'echo', 'foxtrot']));
+tui_test_render($fixed, screen(12, ['delta', 'echo', 'charlie', 'delta', 'echo', 'foxtrot']));
+frame($fixed, 'fixed rows');
+
+tui_test_destroy($fixed);
+tui_test_destroy($renderer);
+?>
+--EXPECT--
+first: \e[?2026h\e[1;1H== log ==\e[2;1Hentry 1\e[3;1Hentry 2\e[4;1Hentry 3\e[5;1Hentry 4\e[6;1Hentry 5\e[7;1Hstatus: ok\e[0m\e[?25l\e[?2026l
+up 1: \e[?2026h\e[2;6r\e[1S\e[r\e[6;1Hentry 6\e[0m\e[?25l\e[?2026l
+up 2: \e[?2026h\e[2;6r\e[2S\e[r\e[5;1Hentry 7\e[6;1Hentry 8\e[0m\e[?25l\e[?2026l
+down 1: \e[?2026h\e[2;6r\e[1T\e[r\e[2;1Hentry 3\e[0m\e[?25l\e[?2026l
+fixed rows: \e[?2026h\e[1;1Hdelt\e[2;1Hecho\e[0K\e[0m\e[?25l\e[?2026l
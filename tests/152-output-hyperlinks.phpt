@@ -0,0 +1,37 @@
+--TEST--
+Output stage: OSC 8 hyperlinks open and close around linked cells
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+use Xocdr\Tui\Ext\ContainerNode;
+use Xocdr\Tui\Ext\ContentNode;
+
+function links(string $docs) {
+    $root = new ContainerNode(['width' => 10, 'height' => 2, 'flexDirection' => 'column']);
+    $root->children = [
+        new ContentNode('docs', ['hyperlink' => $docs]),
+        new ContentNode('src', ['hyperlink' => ['url' => 'https://a.test/src', 'id' => 's1']]),
+    ];
+    return $root;
+}
+
+foreach ([true, false] as $supported) {
+    $renderer = tui_test_create(10, 2);
+    tui_test_set_terminal($renderer, ['links' => $supported]);
+
+    tui_test_render($renderer, links('https://a.test/docs'));
+    echo $supported ? 'links' : 'no links', ": ", str_replace("\e", '\e', tui_test_get_frame($renderer)), "\n";
+
+    // Same text, new target: the cells are rewritten
+    tui_test_render($renderer, links('https://a.test/v2'));
+    echo "  relink: ", str_replace("\e", '\e', tui_test_get_frame($renderer)), "\n";
+
+    tui_test_destroy($renderer);
+}
+?>
+--EXPECT--
+links: \e[?2026h\e[1;1H\e]8;;https://a.test/docs\e\docs\e[2;1H\e]8;;\e\\e]8;id=s1;https://a.test/src\e\src\e]8;;\e\\e[0m\e[?25l\e[?2026l
+  relink: \e[?2026h\e[1;1H\e]8;;https://a.test/v2\e\docs\e]8;;\e\\e[0m\e[?25l\e[?2026l
+no links: \e[?2026h\e[1;1Hdocs\e[2;1Hsrc\e[0m\e[?25l\e[?2026l
+  relink: \e[?2026h\e[1;1Hdocs\e[0m\e[?25l\e[?2026l
@@ -0,0 +1,42 @@
+--TEST--
+Output stage: frames encoded in parallel bands match the serial encoding
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+use Xocdr\Tui\Ext\ContainerNode;
+use Xocdr\Tui\Ext\ContentNode;
+
+// Large enough (40000 changed cells) for the banded path
+function screen(int $k) {
+    $rows = [];
+    for ($y = 0; $y < 200; $y++) {
+        $line = '';
+        for ($x = 0; $x < 200; $x++) {
+            $line .= chr(ord('a') + ($x * 7 + $y * 3 + $k) % 26);
+        }
+        $rows[] = new ContentNode($line);
+    }
+    return new ContainerNode(['width' => 200, 'height' => 200, 'flexDirection' => 'column', 'children' => $rows]);
+}
+
+$frames = [];
+foreach ([0, 4] as $threads) {
+    $renderer = tui_test_create(200, 200);
+    tui_test_set_terminal($renderer, ['threads' => $threads]);
+    foreach ([0, 1] as $k) {
+        tui_test_render($renderer, screen($k));
+        $frames[$threads][$k] = tui_test_get_frame($renderer);
+    }
+    tui_test_destroy($renderer);
+}
+
+var_dump(strlen($frames[0][0]), strlen($frames[0][1]));
+var_dump($frames[4][0] === $frames[0][0]);
+var_dump($frames[4][1] === $frames[0][1]);
+?>
+--EXPECT--
+int(41518)
+int(41518)
+bool(true)
+bool(true)
@@ -0,0 +1,74 @@
+--TEST--
+Render damage: a re-render redraws and sends only what changed
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+use Xocdr\Tui\Ext\ContainerNode;
+use Xocdr\Tui\Ext\ContentNode;
+
+tui_metrics_enable();
+
+function step($renderer, string $label) {
+    $rows = array_map('rtrim', tui_test_get_output($renderer));
+    echo $label, ": ", implode('|', $rows), " damaged=",
+        tui_get_render_metrics()['last_frame']['damaged_cells'], "\n";
+    echo "  ", str_replace("\e", '\e', tui_test_get_frame($renderer)), "\n";
+}
+
+$renderer = tui_test_create(10, 3);
+tui_test_set_terminal($renderer);
+
+// Text changed in place: only its row
+tui_test_render($renderer, new ContainerNode(['children' => [new ContentNode('hello'), new ContentNode('world')]]));
+step($renderer, 'first');
+tui_test_render($renderer, new ContainerNode(['children' => [new ContentNode('help'), new ContentNode('world')]]));
+step($renderer, 'text');
+tui_test_render($renderer, new ContainerNode(['children' => [new ContentNode('help'), new ContentNode('world')]]));
+step($renderer, 'same');
+
+// Node moved: its old and new place
+tui_test_render($renderer, new ContainerNode(['children' => [
+    new ContainerNode(['paddingLeft' => 3, 'children' => [new ContentNode('xy')]]),
+    new ContentNode('world'),
+]]));
+step($renderer, 'moved');
+
+// Child removed: its row and the sibling that moved up into it
+tui_test_render($renderer, new ContainerNode(['children' => [
+    new ContentNode('one'), new ContentNode('two'), new ContentNode('three'),
+]]));
+tui_test_render($renderer, new ContainerNode(['children' => [
+    new ContentNode('one'), new ContentNode('three'),
+]]));
+step($renderer, 'removed');
+
+// Overflow toggled: the box and what it drew outside itself
+$spill = fn(string $overflow) => new ContainerNode(['children' => [
+    new ContainerNode(['height' => 1, 'overflow' => $overflow, 'children' => [
+        new ContentNode('top'), new ContentNode('spill'),
+    ]]),
+]]);
+tui_test_render($renderer, $spill('visible'));
+tui_test_render($renderer, $spill('hidden'));
+step($renderer, 'hidden');
+tui_test_render($renderer, $spill('visible'));
+step($renderer, 'visible');
+
+tui_test_destroy($renderer);
+?>
+--EXPECT--
+first: hello|world| damaged=30
+  \e[?2026h\e[1;1Hhello\e[2;1Hworld\e[0m\e[?25l\e[?2026l
+text: help|world| damaged=10
+  \e[?2026h\e[1;4Hp\e[0K\e[0m\e[?25l\e[?2026l
+same: help|world| damaged=0
+  \e[?2026h\e[0m\e[?25l\e[?2026l
+moved:    xy|world| damaged=10
+  \e[?2026h\e[1;1H   xy\e[0m\e[?25l\e[?2026l
+removed: one|three| damaged=20
+  \e[?2026h\e[2;2Hhree\e[3;1H\e[0K\e[0m\e[?25l\e[?2026l
+hidden: top|| damaged=20
+  \e[?2026h\e[2;1H\e[0K\e[0m\e[?25l\e[?2026l
+visible: top|spill| damaged=20
+  \e[?2026h\e[2;1Hspill\e[0m\e[?25l\e[?2026l
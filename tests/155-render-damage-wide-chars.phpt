@@ -0,0 +1,47 @@
+--TEST--
+Render damage: a wide character split by the edge of a redrawn area is drawn whole
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+use Xocdr\Tui\Ext\ContainerNode;
+use Xocdr\Tui\Ext\ContentNode;
+
+tui_metrics_enable();
+
+// "!" laid over the wide characters at column $at
+function screen(?int $at) {
+    $root = new ContainerNode(['children' => [new ContentNode('中中中')]]);
+    if ($at !== null) {
+        $root->addChild(new ContainerNode(['position' => 'absolute', 'marginLeft' => $at,
+            'children' => [new ContentNode('!')]]));
+    }
+    return $root;
+}
+
+function step($renderer, string $label) {
+    echo $label, ": ", rtrim(tui_test_get_output($renderer)[0]), " damaged=",
+        tui_get_render_metrics()['last_frame']['damaged_cells'], "\n";
+    echo "  ", str_replace("\e", '\e', tui_test_get_frame($renderer)), "\n";
+}
+
+$renderer = tui_test_create(8, 1);
+tui_test_set_terminal($renderer);
+
+// The damaged cell is the right half of a character drawn from the left of it
+tui_test_render($renderer, screen(3));
+tui_test_render($renderer, screen(null));
+step($renderer, 'left edge');
+
+// The damaged cell is the left half of a character
+tui_test_render($renderer, screen(2));
+tui_test_render($renderer, screen(null));
+step($renderer, 'right edge');
+
+tui_test_destroy($renderer);
+?>
+--EXPECT--
+left edge: 中中中 damaged=1
+  \e[?2026h\e[1;3H中\e[0m\e[?25l\e[?2026l
+right edge: 中中中 damaged=1
+  \e[?2026h\e[1;3H中\e[0m\e[?25l\e[?2026l
@@ -0,0 +1,95 @@
+--TEST--
+Render layers: z-order, occlusion by an opaque layer and what removing a layer uncovers
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+use Xocdr\Tui\Ext\ContainerNode;
+use Xocdr\Tui\Ext\ContentNode;
+
+tui_metrics_enable();
+
+function base(string $row) {
+    return new ContainerNode(['children' => [
+        new ContentNode($row), new ContentNode($row), new ContentNode($row),
+    ]]);
+}
+
+function layer(string $text, int $left, int $top, int $width, int $height, ?string $bg = null) {
+    return new ContainerNode(['marginLeft' => $left, 'marginTop' => $top,
+        'width' => $width, 'height' => $height, 'backgroundColor' => $bg,
+        'children' => [new ContentNode($text)]]);
+}
+
+function step($renderer, string $label) {
+    $rows = array_map('rtrim', tui_test_get_output($renderer));
+    echo $label, ": ", implode('|', $rows), " damaged=",
+        tui_get_render_metrics()['last_frame']['damaged_cells'], "\n";
+    echo "  ", str_replace("\e", '\e', tui_test_get_frame($renderer)), "\n";
+}
+
+$renderer = tui_test_create(10, 3);
+tui_test_set_terminal($renderer);
+tui_test_render($renderer, base('aaaaaaaaaa'));
+
+// An opaque palette: only its box is drawn
+$palette = tui_test_add_layer($renderer, layer('PP', 2, 0, 4, 2, '#0000c8'));
+tui_test_advance_frame($renderer);
+step($renderer, 'palette');
+
+// Layers stack by zIndex, above and below the palette
+$above = tui_test_add_layer($renderer, layer('QQQ', 4, 0, 3, 1), 2);
+tui_test_advance_frame($renderer);
+step($renderer, 'above');
+$below = tui_test_add_layer($renderer, layer('LLLLLLLLLL', 0, 1, 10, 1), 0);
+tui_test_advance_frame($renderer);
+step($renderer, 'below');
+
+// Updating a layer redraws inside its own box
+tui_test_update_layer($renderer, $palette, layer('XY', 2, 0, 4, 2, '#0000c8'));
+tui_test_advance_frame($renderer);
+step($renderer, 'update');
+
+// Removing a layer copies back what it covered without redrawing it
+tui_test_remove_layer($renderer, $above);
+tui_test_advance_frame($renderer);
+step($renderer, 'remove above');
+
+// Changes under the opaque palette are left stale...
+tui_test_render($renderer, base('bbbbbbbbbb'));
+step($renderer, 'main tree');
+
+// ...and drawn when it goes away
+tui_test_remove_layer($renderer, $palette);
+tui_test_advance_frame($renderer);
+step($renderer, 'remove palette');
+tui_test_remove_layer($renderer, $below);
+tui_test_advance_frame($renderer);
+step($renderer, 'remove below');
+
+try {
+    tui_test_remove_layer($renderer, $palette);
+} catch (ValueError $e) {
+    echo $e->getMessage(), "\n";
+}
+
+tui_test_destroy($renderer);
+?>
+--EXPECT--
+palette: aaPP  aaaa|aa    aaaa|aaaaaaaaaa damaged=8
+  \e[?2026h\e[1;3HPP\e[48;2;0;0;200m  \e[2;3H    \e[0m\e[?25l\e[?2026l
+above: aaPPQQQaaa|aa    aaaa|aaaaaaaaaa damaged=3
+  \e[?2026h\e[1;5HQQQ\e[0m\e[?25l\e[?2026l
+below: aaPPQQQaaa|LL    LLLL|aaaaaaaaaa damaged=6
+  \e[?2026h\e[2;1HLL\e[7GLLLL\e[0m\e[?25l\e[?2026l
+update: aaXYQQQaaa|LL    LLLL|aaaaaaaaaa damaged=4
+  \e[?2026h\e[1;3HXY\e[0m\e[?25l\e[?2026l
+remove above: aaXY  aaaa|LL    LLLL|aaaaaaaaaa damaged=0
+  \e[?2026h\e[1;5H\e[48;2;0;0;200m  \e[ma\e[0m\e[?25l\e[?2026l
+main tree: bbXY  bbbb|LL    LLLL|bbbbbbbbbb damaged=22
+  \e[?2026h\e[1;1Hbb\e[7Gbbbb\e[3;1Hb\e[9b\e[0m\e[?25l\e[?2026l
+remove palette: bbbbbbbbbb|LLLLLLLLLL|bbbbbbbbbb damaged=12
+  \e[?2026h\e[1;3Hbbbb\e[2;3HLLLL\e[0m\e[?25l\e[?2026l
+remove below: bbbbbbbbbb|bbbbbbbbbb|bbbbbbbbbb damaged=0
+  \e[?2026h\e[2;1Hb\e[9b\e[0m\e[?25l\e[?2026l
+tui_test_remove_layer(): Argument #2 ($layerId) is not a layer of this renderer
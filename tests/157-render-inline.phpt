@@ -0,0 +1,61 @@
+--TEST--
+Render inline: the live region is addressed by lines, grows and shrinks, and Static items are printed once above it
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+use Xocdr\Tui\Ext\ContainerNode;
+use Xocdr\Tui\Ext\ContentNode;
+use Xocdr\Tui\Ext\StaticOutput;
+
+tui_metrics_enable();
+
+function screen(int $items, array $lines) {
+    $log = new StaticOutput(['children' => array_map(
+        fn($i) => new ContentNode("built $i"), array_slice(['a', 'b', 'c'], 0, $items))]);
+    return new ContainerNode(['children' => [$log, ...array_map(fn($l) => new ContentNode($l), $lines)]]);
+}
+
+function step($renderer, string $label) {
+    $rows = array_map('rtrim', tui_test_get_output($renderer));
+    echo $label, ": ", implode('|', $rows), "\n";
+    echo "  ", str_replace(["\e", "\r", "\n"], ['\e', '\r', '\n'], tui_test_get_frame($renderer)), "\n";
+}
+
+$renderer = tui_test_create(12, 4);
+tui_test_set_terminal($renderer, ['inline' => true]);
+
+// The first item is printed, then the region starts on the line below it
+tui_test_render($renderer, screen(1, ['working 1']));
+step($renderer, 'first');
+
+// Only the new item is printed; the region grows by a newline
+tui_test_render($renderer, screen(2, ['working 2', 'step 2']));
+step($renderer, 'grow');
+tui_test_render($renderer, screen(2, ['working 3', 'step 3', 'step 4']));
+step($renderer, 'grow again');
+
+// Lines given up are erased
+tui_test_render($renderer, screen(2, ['done']));
+step($renderer, 'shrink');
+tui_test_render($renderer, screen(2, ['done']));
+step($renderer, 'same');
+
+tui_test_render($renderer, screen(3, ['done']));
+step($renderer, 'new item');
+
+tui_test_destroy($renderer);
+?>
+--EXPECT--
+first: working 1|||
+  \e[?2026h\rbuilt a\r\n\rworking 1   \e[0m\e[?25l\e[?2026l
+grow: working 2|step 2||
+  \e[?2026h\r\e[0Jbuilt b\r\n\r\n\e[1Fworking 2   \e[1Estep 2\e[0K\e[0m\e[?25l\e[?2026l
+grow again: working 3|step 3|step 4|
+  \e[?2026h\r\n\e[2F\e[9G3\e[1E\e[6G3\e[1Estep 4\e[0K\e[0m\e[?25l\e[?2026l
+shrink: done|||
+  \e[?2026h\e[1F\e[0J\e[1Fdone\e[0K\e[0m\e[?25l\e[?2026l
+same: done|||
+  \e[?2026h\e[0m\e[?25l\e[?2026l
+new item: done|||
+  \e[?2026h\r\e[0Jbuilt c\r\n\rdone\e[0K\e[0m\e[?25l\e[?2026l
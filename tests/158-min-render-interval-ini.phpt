@@ -0,0 +1,52 @@
+--TEST--
+Frame scheduling: tui.min_render_interval is range checked and a burst of requests draws one frame
+--EXTENSIONS--
+tui
+--FILE--
+<?php
+use Xocdr\Tui\Ext\ContainerNode;
+use Xocdr\Tui\Ext\ContentNode;
+
+var_dump(ini_get('tui.min_render_interval'));
+
+// 0 (no throttling) to 250 ms; anything else is rejected
+var_dump(ini_set('tui.min_render_interval', '0'));
+var_dump(ini_set('tui.min_render_interval', '250'));
+var_dump(ini_set('tui.min_render_interval', '251'));
+var_dump(ini_set('tui.min_render_interval', '-1'));
+var_dump(ini_get('tui.min_render_interval'));
+
+tui_metrics_enable();
+
+function popup(string $text) {
+    return new ContainerNode(['width' => 5, 'height' => 1, 'children' => [new ContentNode($text)]]);
+}
+
+$renderer = tui_test_create(10, 2);
+tui_test_render($renderer, new ContainerNode(['children' => [new ContentNode('main')]]));
+
+// As in the event loop, requests made before the next frame are drawn once
+$before = tui_get_render_metrics()['render_count'];
+$id = tui_test_add_layer($renderer, popup('one'));
+tui_test_update_layer($renderer, $id, popup('two'));
+tui_test_update_layer($renderer, $id, popup('three'));
+tui_test_advance_frame($renderer);
+echo "burst: ", rtrim(tui_test_get_output($renderer)[0]), " frames=",
+    tui_get_render_metrics()['render_count'] - $before, "\n";
+
+// Nothing requested, nothing drawn
+$before = tui_get_render_metrics()['render_count'];
+tui_test_advance_frame($renderer);
+echo "idle: frames=", tui_get_render_metrics()['render_count'] - $before, "\n";
+
+tui_test_destroy($renderer);
+?>
+--EXPECT--
+string(2) "16"
+string(2) "16"
+string(1) "0"
+bool(false)
+bool(false)
+string(3) "250"
+burst: three frames=1
+idle: frames=0
@@ -157,6 +157,7 @@ zend_class_entry *tui_timer_limit_exception_ce;        /* Xocdr\Tui\TimerLimitEx
 zend_object_handlers tui_instance_handlers;
 zend_object_handlers tui_focus_handlers;
 zend_object_handlers tui_focus_manager_handlers;
+zend_object_handlers tui_node_object_handlers;
 
 /* Note: Object structures (tui_instance_object, tui_focus_object, etc.)
  * and their helper macros are defined in tui_internal.h */
@@ -258,6 +259,82 @@ static void tui_focus_manager_free_object(zend_object *obj)
     zend_object_std_dtor(&intern->std);
 }
 
+/* ------------------------------------------------------------------
+ * ContainerNode/ContentNode object creation/free (structure in
+ * tui_internal.h). The write handlers only mark the object dirty and
+ * pass NULL as cache slot: with a cached offset the VM writes declared
+ * properties directly and these handlers would not run again.
+ * ------------------------------------------------------------------ */
+zend_object *tui_node_object_create(zend_class_entry *ce)
+{
+    tui_node_object *intern = zend_object_alloc(sizeof(tui_node_object), ce);
+
+    intern->native = NULL;
+    intern->dirty = 1;
+    intern->indirect = 0;
+    intern->array_refs = 0;
+
+    zend_object_std_init(&intern->std, ce);
+    object_properties_init(&intern->std, ce);
+
+    intern->std.handlers = &tui_node_object_handlers;
+
+    return &intern->std;
+}
+
+static void tui_node_object_free(zend_object *obj)
+{
+    tui_node_object *intern = tui_node_object_from_obj(obj);
+
+    if (intern->native) {
+        tui_node_destroy(intern->native);
+        intern->native = NULL;
+    }
+    zend_object_std_dtor(&intern->std);
+}
+
+static zend_object *tui_node_object_clone(zend_object *old_obj)
+{
+    zend_object *new_obj = tui_node_object_create(old_obj->ce);
+
+    zend_objects_clone_members(new_obj, old_obj);
+    return new_obj;
+}
+
+/* Children are walked on every render and never cached */
+static inline void tui_node_object_touch(zend_object *obj, zend_string *name)
+{
+    if (!zend_string_equals_literal(name, "children")) {
+        tui_node_object_from_obj(obj)->dirty = 1;
+    }
+}
+
+static zval *tui_node_object_write_property(zend_object *obj, zend_string *name,
+                                            zval *value, void **cache_slot)
+{
+    (void)cache_slot;
+    tui_node_object_touch(obj, name);
+    return zend_std_write_property(obj, name, value, NULL);
+}
+
+static void tui_node_object_unset_property(zend_object *obj, zend_string *name, void **cache_slot)
+{
+    (void)cache_slot;
+    tui_node_object_touch(obj, name);
+    zend_std_unset_property(obj, name, NULL);
+}
+
+static zval *tui_node_object_get_property_ptr_ptr(zend_object *obj, zend_string *name,
+                                                  int type, void **cache_slot)
+{
+    (void)cache_slot;
+    if (type != BP_VAR_R && type != BP_VAR_IS) {
+        tui_node_object_touch(obj, name);
+        tui_node_object_from_obj(obj)->indirect = 1;
+    }
+    return zend_std_get_property_ptr_ptr(obj, name, type, NULL);
+}
+
 /* ------------------------------------------------------------------
  * Named Colors lookup table (594 vibrancy palette colors)
  * Generated from vibrancy palette: 18 families × 11 shades × 3 vibrancies
@@ -957,43 +1034,66 @@ done:
 
 /* Color methods extracted to tui_classes.c */
 
+/* ------------------------------------------------------------------
+ * Helper: Parse RGB color from a string (#RRGGBB or named)
+ * ------------------------------------------------------------------ */
+static int parse_color_string(const char *str, size_t len, tui_color *color)
+{
+    /* Try hex format first: #RRGGBB */
+    if (str[0] == '#' && len == 7) {
+        /* Validate all characters are hex digits before parsing */
+        int valid = 1;
+        for (int i = 1; i < 7; i++) {
+            if (!((str[i] >= '0' && str[i] <= '9') ||
+                  (str[i] >= 'a' && str[i] <= 'f') ||
+                  (str[i] >= 'A' && str[i] <= 'F'))) {
+                valid = 0;
+                break;
+            }
+        }
+        if (valid) {
+            unsigned int r, g, b;
+            if (sscanf(str, "#%02x%02x%02x", &r, &g, &b) == 3) {
+                color->r = (uint8_t)r;
+                color->g = (uint8_t)g;
+                color->b = (uint8_t)b;
+                color->is_set = 1;
+                return 1;
+            }
+        }
+    }
+
+    /* Try named color lookup */
+    return lookup_named_color(str, color);
+}
+
 /* ------------------------------------------------------------------
  * Helper: Parse RGB color from string (#RRGGBB, named) or array [r, g, b]
+ *
+ * Color strings are nearly always literals, which PHP interns, so the
+ * result is cached by string address: a named color is looked up once
+ * per request rather than once per node per frame.
  * ------------------------------------------------------------------ */
 static int parse_color(zval *value, tui_color *color)
 {
     if (Z_TYPE_P(value) == IS_STRING) {
-        const char *str = Z_STRVAL_P(value);
-        size_t len = Z_STRLEN_P(value);
-
-        /* Try hex format first: #RRGGBB */
-        if (str[0] == '#' && len == 7) {
-            /* Validate all characters are hex digits before parsing */
-            int valid = 1;
-            for (int i = 1; i < 7; i++) {
-                if (!((str[i] >= '0' && str[i] <= '9') ||
-                      (str[i] >= 'a' && str[i] <= 'f') ||
-                      (str[i] >= 'A' && str[i] <= 'F'))) {
-                    valid = 0;
-                    break;
-                }
-            }
-            if (valid) {
-                unsigned int r, g, b;
-                if (sscanf(str, "#%02x%02x%02x", &r, &g, &b) == 3) {
-                    color->r = (uint8_t)r;
-                    color->g = (uint8_t)g;
-                    color->b = (uint8_t)b;
-                    color->is_set = 1;
-                    return 1;
-                }
-            }
+        zend_string *str = Z_STR_P(value);
+        tui_pools *pools = TUI_G(pools);
+        tui_color parsed_color = {0};
+        int parsed;
+
+        if (!pools || !ZSTR_IS_INTERNED(str)) {
+            return parse_color_string(ZSTR_VAL(str), ZSTR_LEN(str), color);
         }
 
-        /* Try named color lookup */
-        if (lookup_named_color(str, color)) {
-            return 1;
+        if (!tui_color_cache_get(&pools->color_cache, str, &parsed_color, &parsed)) {
+            parsed = parse_color_string(ZSTR_VAL(str), ZSTR_LEN(str), &parsed_color);
+            tui_color_cache_put(&pools->color_cache, str, &parsed_color, parsed);
         }
+        if (parsed) {
+            *color = parsed_color;
+        }
+        return parsed;
     } else if (Z_TYPE_P(value) == IS_ARRAY) {
         HashTable *ht = Z_ARRVAL_P(value);
         zval *r = zend_hash_index_find(ht, 0);
@@ -1014,6 +1114,199 @@ static int parse_color(zval *value, tui_color *color)
     return 0;
 }
 
+/* ------------------------------------------------------------------
+ * Node property slots
+ *
+ * php_to_tui_node() reads every declared ContainerNode/ContentNode
+ * property of every node on every render. Instead of a by-name lookup
+ * (zend_read_property), it reads the property's slot in the object
+ * directly, at an offset resolved once in MINIT. Subclasses keep the
+ * offsets of the properties they inherit, so one table serves them all.
+ * ------------------------------------------------------------------ */
+typedef struct {
+    const char *name;
+    uint32_t offset;        /* Byte offset for OBJ_PROP(), 0 if unresolved */
+} node_prop_slot;
+
+typedef enum {
+    BOX_FLEX_DIRECTION,
+    BOX_ALIGN_ITEMS,
+    BOX_JUSTIFY_CONTENT,
+    BOX_ALIGN_SELF,
+    BOX_FLEX_GROW,
+    BOX_FLEX_SHRINK,
+    BOX_FLEX_BASIS,
+    BOX_WIDTH,
+    BOX_HEIGHT,
+    BOX_PADDING,
+    BOX_PADDING_TOP,
+    BOX_PADDING_BOTTOM,
+    BOX_PADDING_LEFT,
+    BOX_PADDING_RIGHT,
+    BOX_PADDING_X,
+    BOX_PADDING_Y,
+    BOX_MARGIN,
+    BOX_MARGIN_TOP,
+    BOX_MARGIN_BOTTOM,
+    BOX_MARGIN_LEFT,
+    BOX_MARGIN_RIGHT,
+    BOX_MARGIN_X,
+    BOX_MARGIN_Y,
+    BOX_GAP,
+    BOX_COLUMN_GAP,
+    BOX_ROW_GAP,
+    BOX_FLEX_WRAP,
+    BOX_MIN_WIDTH,
+    BOX_MIN_HEIGHT,
+    BOX_MAX_WIDTH,
+    BOX_MAX_HEIGHT,
+    BOX_OVERFLOW,
+    BOX_OVERFLOW_X,
+    BOX_OVERFLOW_Y,
+    BOX_DISPLAY,
+    BOX_POSITION,
+    BOX_ASPECT_RATIO,
+    BOX_DIRECTION,
+    BOX_BORDER_STYLE,
+    BOX_BORDER_COLOR,
+    BOX_BACKGROUND_COLOR,
+    BOX_FOCUSABLE,
+    BOX_FOCUSED,
+    BOX_TAB_INDEX,
+    BOX_FOCUS_GROUP,
+    BOX_AUTO_FOCUS,
+    BOX_FOCUS_TRAP,
+    BOX_SHOW_CURSOR,
+    BOX_KEY,
+    BOX_ID,
+    BOX_BORDER_TOP_COLOR,
+    BOX_BORDER_RIGHT_COLOR,
+    BOX_BORDER_BOTTOM_COLOR,
+    BOX_BORDER_LEFT_COLOR,
+    BOX_CHILDREN,
+    BOX_PROP_COUNT
+} box_prop;
+
+static node_prop_slot box_props[BOX_PROP_COUNT] = {
+    [BOX_FLEX_DIRECTION]      = {"flexDirection", 0},
+    [BOX_ALIGN_ITEMS]         = {"alignItems", 0},
+    [BOX_JUSTIFY_CONTENT]     = {"justifyContent", 0},
+    [BOX_ALIGN_SELF]          = {"alignSelf", 0},
+    [BOX_FLEX_GROW]           = {"flexGrow", 0},
+    [BOX_FLEX_SHRINK]         = {"flexShrink", 0},
+    [BOX_FLEX_BASIS]          = {"flexBasis", 0},
+    [BOX_WIDTH]               = {"width", 0},
+    [BOX_HEIGHT]              = {"height", 0},
+    [BOX_PADDING]             = {"padding", 0},
+    [BOX_PADDING_TOP]         = {"paddingTop", 0},
+    [BOX_PADDING_BOTTOM]      = {"paddingBottom", 0},
+    [BOX_PADDING_LEFT]        = {"paddingLeft", 0},
+    [BOX_PADDING_RIGHT]       = {"paddingRight", 0},
+    [BOX_PADDING_X]           = {"paddingX", 0},
+    [BOX_PADDING_Y]           = {"paddingY", 0},
+    [BOX_MARGIN]              = {"margin", 0},
+    [BOX_MARGIN_TOP]          = {"marginTop", 0},
+    [BOX_MARGIN_BOTTOM]       = {"marginBottom", 0},
+    [BOX_MARGIN_LEFT]         = {"marginLeft", 0},
+    [BOX_MARGIN_RIGHT]        = {"marginRight", 0},
+    [BOX_MARGIN_X]            = {"marginX", 0},
+    [BOX_MARGIN_Y]            = {"marginY", 0},
+    [BOX_GAP]                 = {"gap", 0},
+    [BOX_COLUMN_GAP]          = {"columnGap", 0},
+    [BOX_ROW_GAP]             = {"rowGap", 0},
+    [BOX_FLEX_WRAP]           = {"flexWrap", 0},
+    [BOX_MIN_WIDTH]           = {"minWidth", 0},
+    [BOX_MIN_HEIGHT]          = {"minHeight", 0},
+    [BOX_MAX_WIDTH]           = {"maxWidth", 0},
+    [BOX_MAX_HEIGHT]          = {"maxHeight", 0},
+    [BOX_OVERFLOW]            = {"overflow", 0},
+    [BOX_OVERFLOW_X]          = {"overflowX", 0},
+    [BOX_OVERFLOW_Y]          = {"overflowY", 0},
+    [BOX_DISPLAY]             = {"display", 0},
+    [BOX_POSITION]            = {"position", 0},
+    [BOX_ASPECT_RATIO]        = {"aspectRatio", 0},
+    [BOX_DIRECTION]           = {"direction", 0},
+    [BOX_BORDER_STYLE]        = {"borderStyle", 0},
+    [BOX_BORDER_COLOR]        = {"borderColor", 0},
+    [BOX_BACKGROUND_COLOR]    = {"backgroundColor", 0},
+    [BOX_FOCUSABLE]           = {"focusable", 0},
+    [BOX_FOCUSED]             = {"focused", 0},
+    [BOX_TAB_INDEX]           = {"tabIndex", 0},
+    [BOX_FOCUS_GROUP]         = {"focusGroup", 0},
+    [BOX_AUTO_FOCUS]          = {"autoFocus", 0},
+    [BOX_FOCUS_TRAP]          = {"focusTrap", 0},
+    [BOX_SHOW_CURSOR]         = {"showCursor", 0},
+    [BOX_KEY]                 = {"key", 0},
+    [BOX_ID]                  = {"id", 0},
+    [BOX_BORDER_TOP_COLOR]    = {"borderTopColor", 0},
+    [BOX_BORDER_RIGHT_COLOR]  = {"borderRightColor", 0},
+    [BOX_BORDER_BOTTOM_COLOR] = {"borderBottomColor", 0},
+    [BOX_BORDER_LEFT_COLOR]   = {"borderLeftColor", 0},
+    [BOX_CHILDREN]            = {"children", 0},
+};
+
+typedef enum {
+    TEXT_CONTENT,
+    TEXT_COLOR,
+    TEXT_BACKGROUND_COLOR,
+    TEXT_BOLD,
+    TEXT_DIM,
+    TEXT_ITALIC,
+    TEXT_UNDERLINE,
+    TEXT_INVERSE,
+    TEXT_STRIKETHROUGH,
+    TEXT_WRAP,
+    TEXT_KEY,
+    TEXT_ID,
+    TEXT_HYPERLINK,
+    TEXT_PROP_COUNT
+} text_prop;
+
+static node_prop_slot text_props[TEXT_PROP_COUNT] = {
+    [TEXT_CONTENT]          = {"content", 0},
+    [TEXT_COLOR]            = {"color", 0},
+    [TEXT_BACKGROUND_COLOR] = {"backgroundColor", 0},
+    [TEXT_BOLD]             = {"bold", 0},
+    [TEXT_DIM]              = {"dim", 0},
+    [TEXT_ITALIC]           = {"italic", 0},
+    [TEXT_UNDERLINE]        = {"underline", 0},
+    [TEXT_INVERSE]          = {"inverse", 0},
+    [TEXT_STRIKETHROUGH]    = {"strikethrough", 0},
+    [TEXT_WRAP]             = {"wrap", 0},
+    [TEXT_KEY]              = {"key", 0},
+    [TEXT_ID]               = {"id", 0},
+    [TEXT_HYPERLINK]        = {"hyperlink", 0},
+};
+
+static void resolve_node_props(zend_class_entry *ce, node_prop_slot *props, int count)
+{
+    for (int i = 0; i < count; i++) {
+        zend_property_info *info = zend_hash_str_find_ptr(&ce->properties_info,
+            props[i].name, strlen(props[i].name));
+        props[i].offset = (info && !(info->flags & ZEND_ACC_STATIC)) ? info->offset : 0;
+    }
+}
+
+/* Read a node property. Takes the slot unless a subclass hooks properties
+ * or the property was unset (or the object is lazy), where only the full
+ * read handler gets it right. */
+static zend_always_inline zval* node_prop(zend_object *zobj, const node_prop_slot *slot, zval *rv)
+{
+    if (EXPECTED(slot->offset != 0 && zobj->ce->num_hooked_props == 0)) {
+        zval *prop = OBJ_PROP(zobj, slot->offset);
+        if (EXPECTED(Z_TYPE_P(prop) != IS_UNDEF)) {
+            return prop;
+        }
+    }
+    return zend_read_property(zobj->ce, zobj, slot->name, strlen(slot->name), 1, rv);
+}
+
+/* Token for a string property value (flexDirection, borderStyle, ...) */
+static zend_always_inline tui_keyword style_keyword(zval *prop)
+{
+    return tui_keyword_lookup(Z_STRVAL_P(prop), Z_STRLEN_P(prop));
+}
+
 /* ==========================================================================
  * PHP-TO-C NODE TREE CONVERSION
  *
@@ -1023,7 +1316,7 @@ static int parse_color(zval *value, tui_color *color)
  * The conversion process:
  * 1. Identify the object type (Box or Text)
  * 2. Create corresponding C node (tui_node_create_box/text)
- * 3. Read all PHP properties and apply to the node
+ * 3. Read all PHP properties (by slot, see node_prop()) and apply them
  * 4. For Box nodes, recursively convert all children
  * 5. Return the root of the converted tree
  *
@@ -1031,130 +1324,144 @@ static int parse_color(zval *value, tui_color *color)
  * to Yoga layout engine calls (YGNodeStyleSet*).
  * ========================================================================== */
 
-/**
- * Convert a PHP TuiBox/TuiText object to a C tui_node structure.
- *
- * @param obj   The PHP object (must be TuiBox or TuiText instance)
- * @param depth Current recursion depth (for stack overflow protection)
- * @return      Newly allocated tui_node, or NULL on error
- *
- * The returned node and its children must be freed with tui_node_destroy().
- * This function is exposed for use by split modules (tui_render.c, etc.).
- */
-tui_node* php_to_tui_node(zval *obj, int depth)
+/* Node for an object's own properties; children are left to the caller */
+static tui_node* node_from_props(zend_object *zobj)
 {
-    if (!obj || Z_TYPE_P(obj) != IS_OBJECT) {
-        return NULL;
-    }
-
-    /* Prevent stack overflow from deeply nested trees.
-     * MAX_TREE_DEPTH is defined in tui_internal.h (default: 256) */
-    if (depth > MAX_TREE_DEPTH) {
-        php_error_docref(NULL, E_WARNING, "Maximum node tree depth exceeded (%d)", MAX_TREE_DEPTH);
-        return NULL;
-    }
-
-    zend_class_entry *ce = Z_OBJCE_P(obj);
+    zend_class_entry *ce = zobj->ce;
     tui_node *node = NULL;
     zval rv;
 
     if (instanceof_function(ce, tui_box_ce)) {
-        /* Create box node */
-        node = tui_node_create_box();
+        /* Create box node (StaticOutput is a Box whose children are
+         * printed once in inline mode) */
+        node = instanceof_function(ce, tui_static_ce) ? tui_node_create_static() : tui_node_create_box();
         if (!node) return NULL;
 
         /* Read properties and apply to Yoga node */
         zval *prop;
 
         /* flexDirection */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "flexDirection", sizeof("flexDirection")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_FLEX_DIRECTION], &rv);
         if (prop && Z_TYPE_P(prop) == IS_STRING) {
-            const char *dir = Z_STRVAL_P(prop);
-            if (strcmp(dir, "row") == 0) {
-                YGNodeStyleSetFlexDirection(node->yoga_node, YGFlexDirectionRow);
-            } else if (strcmp(dir, "row-reverse") == 0) {
-                YGNodeStyleSetFlexDirection(node->yoga_node, YGFlexDirectionRowReverse);
-            } else if (strcmp(dir, "column-reverse") == 0) {
-                YGNodeStyleSetFlexDirection(node->yoga_node, YGFlexDirectionColumnReverse);
-            } else {
-                YGNodeStyleSetFlexDirection(node->yoga_node, YGFlexDirectionColumn);
+            switch (style_keyword(prop)) {
+                case TUI_KW_ROW:
+                    YGNodeStyleSetFlexDirection(node->yoga_node, YGFlexDirectionRow);
+                    break;
+                case TUI_KW_ROW_REVERSE:
+                    YGNodeStyleSetFlexDirection(node->yoga_node, YGFlexDirectionRowReverse);
+                    break;
+                case TUI_KW_COLUMN_REVERSE:
+                    YGNodeStyleSetFlexDirection(node->yoga_node, YGFlexDirectionColumnReverse);
+                    break;
+                default:
+                    YGNodeStyleSetFlexDirection(node->yoga_node, YGFlexDirectionColumn);
+                    break;
             }
         }
 
         /* alignItems */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "alignItems", sizeof("alignItems")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_ALIGN_ITEMS], &rv);
         if (prop && Z_TYPE_P(prop) == IS_STRING) {
-            const char *align = Z_STRVAL_P(prop);
-            if (strcmp(align, "flex-start") == 0 || strcmp(align, "start") == 0) {
-                YGNodeStyleSetAlignItems(node->yoga_node, YGAlignFlexStart);
-            } else if (strcmp(align, "center") == 0) {
-                YGNodeStyleSetAlignItems(node->yoga_node, YGAlignCenter);
-            } else if (strcmp(align, "flex-end") == 0 || strcmp(align, "end") == 0) {
-                YGNodeStyleSetAlignItems(node->yoga_node, YGAlignFlexEnd);
-            } else if (strcmp(align, "stretch") == 0) {
-                YGNodeStyleSetAlignItems(node->yoga_node, YGAlignStretch);
-            } else if (strcmp(align, "baseline") == 0) {
-                YGNodeStyleSetAlignItems(node->yoga_node, YGAlignBaseline);
+            switch (style_keyword(prop)) {
+                case TUI_KW_FLEX_START:
+                case TUI_KW_START:
+                    YGNodeStyleSetAlignItems(node->yoga_node, YGAlignFlexStart);
+                    break;
+                case TUI_KW_CENTER:
+                    YGNodeStyleSetAlignItems(node->yoga_node, YGAlignCenter);
+                    break;
+                case TUI_KW_FLEX_END:
+                case TUI_KW_END:
+                    YGNodeStyleSetAlignItems(node->yoga_node, YGAlignFlexEnd);
+                    break;
+                case TUI_KW_STRETCH:
+                    YGNodeStyleSetAlignItems(node->yoga_node, YGAlignStretch);
+                    break;
+                case TUI_KW_BASELINE:
+                    YGNodeStyleSetAlignItems(node->yoga_node, YGAlignBaseline);
+                    break;
+                default:
+                    break;
             }
         }
 
         /* justifyContent */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "justifyContent", sizeof("justifyContent")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_JUSTIFY_CONTENT], &rv);
         if (prop && Z_TYPE_P(prop) == IS_STRING) {
-            const char *justify = Z_STRVAL_P(prop);
-            if (strcmp(justify, "flex-start") == 0 || strcmp(justify, "start") == 0) {
-                YGNodeStyleSetJustifyContent(node->yoga_node, YGJustifyFlexStart);
-            } else if (strcmp(justify, "center") == 0) {
-                YGNodeStyleSetJustifyContent(node->yoga_node, YGJustifyCenter);
-            } else if (strcmp(justify, "flex-end") == 0 || strcmp(justify, "end") == 0) {
-                YGNodeStyleSetJustifyContent(node->yoga_node, YGJustifyFlexEnd);
-            } else if (strcmp(justify, "space-between") == 0) {
-                YGNodeStyleSetJustifyContent(node->yoga_node, YGJustifySpaceBetween);
-            } else if (strcmp(justify, "space-around") == 0) {
-                YGNodeStyleSetJustifyContent(node->yoga_node, YGJustifySpaceAround);
-            } else if (strcmp(justify, "space-evenly") == 0) {
-                YGNodeStyleSetJustifyContent(node->yoga_node, YGJustifySpaceEvenly);
+            switch (style_keyword(prop)) {
+                case TUI_KW_FLEX_START:
+                case TUI_KW_START:
+                    YGNodeStyleSetJustifyContent(node->yoga_node, YGJustifyFlexStart);
+                    break;
+                case TUI_KW_CENTER:
+                    YGNodeStyleSetJustifyContent(node->yoga_node, YGJustifyCenter);
+                    break;
+                case TUI_KW_FLEX_END:
+                case TUI_KW_END:
+                    YGNodeStyleSetJustifyContent(node->yoga_node, YGJustifyFlexEnd);
+                    break;
+                case TUI_KW_SPACE_BETWEEN:
+                    YGNodeStyleSetJustifyContent(node->yoga_node, YGJustifySpaceBetween);
+                    break;
+                case TUI_KW_SPACE_AROUND:
+                    YGNodeStyleSetJustifyContent(node->yoga_node, YGJustifySpaceAround);
+                    break;
+                case TUI_KW_SPACE_EVENLY:
+                    YGNodeStyleSetJustifyContent(node->yoga_node, YGJustifySpaceEvenly);
+                    break;
+                default:
+                    break;
             }
         }
 
         /* alignSelf - allows individual child to override parent's alignItems */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "alignSelf", sizeof("alignSelf")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_ALIGN_SELF], &rv);
         if (prop && Z_TYPE_P(prop) == IS_STRING) {
-            const char *alignSelf = Z_STRVAL_P(prop);
-            if (strcmp(alignSelf, "auto") == 0) {
-                YGNodeStyleSetAlignSelf(node->yoga_node, YGAlignAuto);
-            } else if (strcmp(alignSelf, "flex-start") == 0 || strcmp(alignSelf, "start") == 0) {
-                YGNodeStyleSetAlignSelf(node->yoga_node, YGAlignFlexStart);
-            } else if (strcmp(alignSelf, "center") == 0) {
-                YGNodeStyleSetAlignSelf(node->yoga_node, YGAlignCenter);
-            } else if (strcmp(alignSelf, "flex-end") == 0 || strcmp(alignSelf, "end") == 0) {
-                YGNodeStyleSetAlignSelf(node->yoga_node, YGAlignFlexEnd);
-            } else if (strcmp(alignSelf, "stretch") == 0) {
-                YGNodeStyleSetAlignSelf(node->yoga_node, YGAlignStretch);
-            } else if (strcmp(alignSelf, "baseline") == 0) {
-                YGNodeStyleSetAlignSelf(node->yoga_node, YGAlignBaseline);
+            switch (style_keyword(prop)) {
+                case TUI_KW_AUTO:
+                    YGNodeStyleSetAlignSelf(node->yoga_node, YGAlignAuto);
+                    break;
+                case TUI_KW_FLEX_START:
+                case TUI_KW_START:
+                    YGNodeStyleSetAlignSelf(node->yoga_node, YGAlignFlexStart);
+                    break;
+                case TUI_KW_CENTER:
+                    YGNodeStyleSetAlignSelf(node->yoga_node, YGAlignCenter);
+                    break;
+                case TUI_KW_FLEX_END:
+                case TUI_KW_END:
+                    YGNodeStyleSetAlignSelf(node->yoga_node, YGAlignFlexEnd);
+                    break;
+                case TUI_KW_STRETCH:
+                    YGNodeStyleSetAlignSelf(node->yoga_node, YGAlignStretch);
+                    break;
+                case TUI_KW_BASELINE:
+                    YGNodeStyleSetAlignSelf(node->yoga_node, YGAlignBaseline);
+                    break;
+                default:
+                    break;
             }
         }
 
         /* flexGrow */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "flexGrow", sizeof("flexGrow")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_FLEX_GROW], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             YGNodeStyleSetFlexGrow(node->yoga_node, (float)zval_get_double(prop));
         }
 
         /* flexShrink */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "flexShrink", sizeof("flexShrink")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_FLEX_SHRINK], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             YGNodeStyleSetFlexShrink(node->yoga_node, (float)zval_get_double(prop));
         }
 
         /* flexBasis - initial size before flex distribution */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "flexBasis", sizeof("flexBasis")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_FLEX_BASIS], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             YGNodeStyleSetFlexBasis(node->yoga_node, (float)zval_get_double(prop));
         } else if (prop && Z_TYPE_P(prop) == IS_STRING) {
             const char *basis = Z_STRVAL_P(prop);
-            if (strcmp(basis, "auto") == 0) {
+            if (style_keyword(prop) == TUI_KW_AUTO) {
                 YGNodeStyleSetFlexBasisAuto(node->yoga_node);
             } else {
                 int pct;
@@ -1165,7 +1472,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
         }
 
         /* width */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "width", sizeof("width")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_WIDTH], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             double w = zval_get_double(prop);
             if (tui_validate_dimension(w, "width")) {
@@ -1184,7 +1491,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
         }
 
         /* height */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "height", sizeof("height")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_HEIGHT], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             double h = zval_get_double(prop);
             if (tui_validate_dimension(h, "height")) {
@@ -1203,7 +1510,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
         }
 
         /* padding - only apply non-zero values to avoid overriding YGEdgeAll */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "padding", sizeof("padding")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_PADDING], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             float p = (float)zval_get_double(prop);
             if (p > 0) {
@@ -1211,7 +1518,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
             }
         }
 
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "paddingTop", sizeof("paddingTop")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_PADDING_TOP], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             float pt = (float)zval_get_double(prop);
             if (pt > 0) {
@@ -1219,7 +1526,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
             }
         }
 
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "paddingBottom", sizeof("paddingBottom")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_PADDING_BOTTOM], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             float pb = (float)zval_get_double(prop);
             if (pb > 0) {
@@ -1227,7 +1534,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
             }
         }
 
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "paddingLeft", sizeof("paddingLeft")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_PADDING_LEFT], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             float pl = (float)zval_get_double(prop);
             if (pl > 0) {
@@ -1235,7 +1542,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
             }
         }
 
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "paddingRight", sizeof("paddingRight")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_PADDING_RIGHT], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             float pr = (float)zval_get_double(prop);
             if (pr > 0) {
@@ -1243,7 +1550,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
             }
         }
 
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "paddingX", sizeof("paddingX")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_PADDING_X], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             float px = (float)zval_get_double(prop);
             if (px > 0) {
@@ -1252,7 +1559,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
             }
         }
 
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "paddingY", sizeof("paddingY")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_PADDING_Y], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             float py = (float)zval_get_double(prop);
             if (py > 0) {
@@ -1262,7 +1569,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
         }
 
         /* margin - only apply non-zero values to avoid overriding YGEdgeAll */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "margin", sizeof("margin")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_MARGIN], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             float m = (float)zval_get_double(prop);
             if (m > 0) {
@@ -1270,7 +1577,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
             }
         }
 
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "marginTop", sizeof("marginTop")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_MARGIN_TOP], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             float mt = (float)zval_get_double(prop);
             if (mt > 0) {
@@ -1278,7 +1585,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
             }
         }
 
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "marginBottom", sizeof("marginBottom")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_MARGIN_BOTTOM], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             float mb = (float)zval_get_double(prop);
             if (mb > 0) {
@@ -1286,7 +1593,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
             }
         }
 
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "marginLeft", sizeof("marginLeft")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_MARGIN_LEFT], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             float ml = (float)zval_get_double(prop);
             if (ml > 0) {
@@ -1294,7 +1601,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
             }
         }
 
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "marginRight", sizeof("marginRight")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_MARGIN_RIGHT], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             float mr = (float)zval_get_double(prop);
             if (mr > 0) {
@@ -1302,7 +1609,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
             }
         }
 
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "marginX", sizeof("marginX")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_MARGIN_X], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             float mx = (float)zval_get_double(prop);
             if (mx > 0) {
@@ -1311,7 +1618,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
             }
         }
 
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "marginY", sizeof("marginY")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_MARGIN_Y], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             float my = (float)zval_get_double(prop);
             if (my > 0) {
@@ -1321,7 +1628,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
         }
 
         /* gap - only apply non-zero values to avoid overriding YGGutterAll */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "gap", sizeof("gap")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_GAP], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             float g = (float)zval_get_double(prop);
             if (g > 0) {
@@ -1330,7 +1637,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
         }
 
         /* columnGap */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "columnGap", sizeof("columnGap")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_COLUMN_GAP], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             float cg = (float)zval_get_double(prop);
             if (cg > 0) {
@@ -1339,7 +1646,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
         }
 
         /* rowGap */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "rowGap", sizeof("rowGap")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_ROW_GAP], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             float rg = (float)zval_get_double(prop);
             if (rg > 0) {
@@ -1348,20 +1655,23 @@ tui_node* php_to_tui_node(zval *obj, int depth)
         }
 
         /* flexWrap */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "flexWrap", sizeof("flexWrap")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_FLEX_WRAP], &rv);
         if (prop && Z_TYPE_P(prop) == IS_STRING) {
-            const char *wrap = Z_STRVAL_P(prop);
-            if (strcmp(wrap, "wrap") == 0) {
-                YGNodeStyleSetFlexWrap(node->yoga_node, YGWrapWrap);
-            } else if (strcmp(wrap, "wrap-reverse") == 0) {
-                YGNodeStyleSetFlexWrap(node->yoga_node, YGWrapWrapReverse);
-            } else {
-                YGNodeStyleSetFlexWrap(node->yoga_node, YGWrapNoWrap);
+            switch (style_keyword(prop)) {
+                case TUI_KW_WRAP:
+                    YGNodeStyleSetFlexWrap(node->yoga_node, YGWrapWrap);
+                    break;
+                case TUI_KW_WRAP_REVERSE:
+                    YGNodeStyleSetFlexWrap(node->yoga_node, YGWrapWrapReverse);
+                    break;
+                default:
+                    YGNodeStyleSetFlexWrap(node->yoga_node, YGWrapNoWrap);
+                    break;
             }
         }
 
         /* minWidth */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "minWidth", sizeof("minWidth")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_MIN_WIDTH], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             double mw = zval_get_double(prop);
             if (tui_validate_dimension(mw, "minWidth")) {
@@ -1375,7 +1685,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
         }
 
         /* minHeight */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "minHeight", sizeof("minHeight")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_MIN_HEIGHT], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             double mh = zval_get_double(prop);
             if (tui_validate_dimension(mh, "minHeight")) {
@@ -1389,7 +1699,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
         }
 
         /* maxWidth */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "maxWidth", sizeof("maxWidth")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_MAX_WIDTH], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             double maxw = zval_get_double(prop);
             if (tui_validate_dimension(maxw, "maxWidth")) {
@@ -1403,7 +1713,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
         }
 
         /* maxHeight */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "maxHeight", sizeof("maxHeight")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_MAX_HEIGHT], &rv);
         if (prop && (Z_TYPE_P(prop) == IS_LONG || Z_TYPE_P(prop) == IS_DOUBLE)) {
             double maxh = zval_get_double(prop);
             if (tui_validate_dimension(maxh, "maxHeight")) {
@@ -1417,23 +1727,35 @@ tui_node* php_to_tui_node(zval *obj, int depth)
         }
 
         /* overflow */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "overflow", sizeof("overflow")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_OVERFLOW], &rv);
         if (prop && Z_TYPE_P(prop) == IS_STRING) {
-            const char *overflow = Z_STRVAL_P(prop);
-            if (strcmp(overflow, "hidden") == 0) {
+            tui_keyword overflow = style_keyword(prop);
+            if (overflow == TUI_KW_HIDDEN) {
                 YGNodeStyleSetOverflow(node->yoga_node, YGOverflowHidden);
-            } else if (strcmp(overflow, "scroll") == 0) {
+            } else if (overflow == TUI_KW_SCROLL) {
                 YGNodeStyleSetOverflow(node->yoga_node, YGOverflowScroll);
             } else {
                 YGNodeStyleSetOverflow(node->yoga_node, YGOverflowVisible);
             }
+            node->clip_x = node->clip_y = (overflow == TUI_KW_HIDDEN || overflow == TUI_KW_SCROLL);
+        }
+
+        /* overflowX / overflowY: per-axis clipping, overriding overflow */
+        prop = node_prop(zobj, &box_props[BOX_OVERFLOW_X], &rv);
+        if (prop && Z_TYPE_P(prop) == IS_STRING) {
+            tui_keyword overflow = style_keyword(prop);
+            node->clip_x = (overflow == TUI_KW_HIDDEN || overflow == TUI_KW_SCROLL);
+        }
+        prop = node_prop(zobj, &box_props[BOX_OVERFLOW_Y], &rv);
+        if (prop && Z_TYPE_P(prop) == IS_STRING) {
+            tui_keyword overflow = style_keyword(prop);
+            node->clip_y = (overflow == TUI_KW_HIDDEN || overflow == TUI_KW_SCROLL);
         }
 
         /* display */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "display", sizeof("display")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_DISPLAY], &rv);
         if (prop && Z_TYPE_P(prop) == IS_STRING) {
-            const char *display = Z_STRVAL_P(prop);
-            if (strcmp(display, "none") == 0) {
+            if (style_keyword(prop) == TUI_KW_NONE) {
                 YGNodeStyleSetDisplay(node->yoga_node, YGDisplayNone);
             } else {
                 YGNodeStyleSetDisplay(node->yoga_node, YGDisplayFlex);
@@ -1441,10 +1763,9 @@ tui_node* php_to_tui_node(zval *obj, int depth)
         }
 
         /* position */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "position", sizeof("position")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_POSITION], &rv);
         if (prop && Z_TYPE_P(prop) == IS_STRING) {
-            const char *position = Z_STRVAL_P(prop);
-            if (strcmp(position, "absolute") == 0) {
+            if (style_keyword(prop) == TUI_KW_ABSOLUTE) {
                 YGNodeStyleSetPositionType(node->yoga_node, YGPositionTypeAbsolute);
             } else {
                 YGNodeStyleSetPositionType(node->yoga_node, YGPositionTypeRelative);
@@ -1452,7 +1773,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
         }
 
         /* aspectRatio - maintain width/height proportions */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "aspectRatio", sizeof("aspectRatio")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_ASPECT_RATIO], &rv);
         if (prop && Z_TYPE_P(prop) != IS_NULL) {
             float ar = (float)zval_get_double(prop);
             if (ar > 0) {
@@ -1461,67 +1782,65 @@ tui_node* php_to_tui_node(zval *obj, int depth)
         }
 
         /* direction - RTL/LTR layout direction */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "direction", sizeof("direction")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_DIRECTION], &rv);
         if (prop && Z_TYPE_P(prop) == IS_STRING) {
-            const char *dir = Z_STRVAL_P(prop);
-            if (strcmp(dir, "rtl") == 0) {
+            tui_keyword dir = style_keyword(prop);
+            if (dir == TUI_KW_RTL) {
                 YGNodeStyleSetDirection(node->yoga_node, YGDirectionRTL);
-            } else if (strcmp(dir, "ltr") == 0) {
+            } else if (dir == TUI_KW_LTR) {
                 YGNodeStyleSetDirection(node->yoga_node, YGDirectionLTR);
             }
             /* YGDirectionInherit is the default */
         }
 
         /* borderStyle */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "borderStyle", sizeof("borderStyle")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_BORDER_STYLE], &rv);
         if (prop && Z_TYPE_P(prop) == IS_STRING) {
-            const char *border = Z_STRVAL_P(prop);
-            if (strcmp(border, "single") == 0) {
-                node->border_style = TUI_BORDER_SINGLE;
-                YGNodeStyleSetBorder(node->yoga_node, YGEdgeAll, 1);
-            } else if (strcmp(border, "double") == 0) {
-                node->border_style = TUI_BORDER_DOUBLE;
-                YGNodeStyleSetBorder(node->yoga_node, YGEdgeAll, 1);
-            } else if (strcmp(border, "round") == 0) {
-                node->border_style = TUI_BORDER_ROUND;
-                YGNodeStyleSetBorder(node->yoga_node, YGEdgeAll, 1);
-            } else if (strcmp(border, "bold") == 0) {
-                node->border_style = TUI_BORDER_BOLD;
-                YGNodeStyleSetBorder(node->yoga_node, YGEdgeAll, 1);
-            } else if (strcmp(border, "dashed") == 0) {
-                node->border_style = TUI_BORDER_DASHED;
+            switch (style_keyword(prop)) {
+                case TUI_KW_SINGLE: node->border_style = TUI_BORDER_SINGLE; break;
+                case TUI_KW_DOUBLE: node->border_style = TUI_BORDER_DOUBLE; break;
+                case TUI_KW_ROUND:  node->border_style = TUI_BORDER_ROUND;  break;
+                case TUI_KW_BOLD:   node->border_style = TUI_BORDER_BOLD;   break;
+                case TUI_KW_DASHED: node->border_style = TUI_BORDER_DASHED; break;
+                default:            node->border_style = TUI_BORDER_NONE;   break;
+            }
+            if (node->border_style != TUI_BORDER_NONE) {
                 YGNodeStyleSetBorder(node->yoga_node, YGEdgeAll, 1);
-            } else {
-                node->border_style = TUI_BORDER_NONE;
             }
         }
 
         /* borderColor */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "borderColor", sizeof("borderColor")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_BORDER_COLOR], &rv);
         if (prop && Z_TYPE_P(prop) != IS_NULL) {
             parse_color(prop, &node->border_color);
         }
 
+        /* backgroundColor - fills the box (and makes a layer root opaque) */
+        prop = node_prop(zobj, &box_props[BOX_BACKGROUND_COLOR], &rv);
+        if (prop && Z_TYPE_P(prop) != IS_NULL) {
+            parse_color(prop, &node->style.bg);
+        }
+
         /* focusable */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "focusable", sizeof("focusable")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_FOCUSABLE], &rv);
         if (prop && zend_is_true(prop)) {
             node->focusable = 1;
         }
 
         /* focused */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "focused", sizeof("focused")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_FOCUSED], &rv);
         if (prop && zend_is_true(prop)) {
             node->focused = 1;
         }
 
         /* tabIndex - tab order (-1 = skip, 0+ = order) */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "tabIndex", sizeof("tabIndex")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_TAB_INDEX], &rv);
         if (prop && Z_TYPE_P(prop) == IS_LONG) {
             node->tab_index = (int)Z_LVAL_P(prop);
         }
 
         /* focusGroup - group name for scoped tabbing */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "focusGroup", sizeof("focusGroup")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_FOCUS_GROUP], &rv);
         if (prop && Z_TYPE_P(prop) == IS_STRING) {
             if (tui_node_set_focus_group(node, Z_STRVAL_P(prop)) < 0) {
                 tui_node_destroy(node);
@@ -1530,25 +1849,25 @@ tui_node* php_to_tui_node(zval *obj, int depth)
         }
 
         /* autoFocus - focus on mount */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "autoFocus", sizeof("autoFocus")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_AUTO_FOCUS], &rv);
         if (prop && zend_is_true(prop)) {
             node->auto_focus = 1;
         }
 
         /* focusTrap - trap focus within container */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "focusTrap", sizeof("focusTrap")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_FOCUS_TRAP], &rv);
         if (prop && zend_is_true(prop)) {
             node->focus_trap = 1;
         }
 
         /* showCursor - show terminal cursor when focused (for text input) */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "showCursor", sizeof("showCursor")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_SHOW_CURSOR], &rv);
         if (prop && zend_is_true(prop)) {
             node->show_cursor = 1;
         }
 
         /* key - for reconciliation (with length limit, uses string interning) */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "key", sizeof("key")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_KEY], &rv);
         if (prop && Z_TYPE_P(prop) == IS_STRING) {
             size_t key_len = Z_STRLEN_P(prop);
             if (key_len > TUI_MAX_KEY_LENGTH) {
@@ -1564,7 +1883,7 @@ tui_node* php_to_tui_node(zval *obj, int depth)
         }
 
         /* id - for focus-by-id (with length limit) */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "id", sizeof("id")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_ID], &rv);
         if (prop && Z_TYPE_P(prop) == IS_STRING) {
             size_t id_len = Z_STRLEN_P(prop);
             if (id_len > TUI_MAX_ID_LENGTH) {
@@ -1584,45 +1903,29 @@ tui_node* php_to_tui_node(zval *obj, int depth)
         }
 
         /* Per-side border colors */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "borderTopColor", sizeof("borderTopColor")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_BORDER_TOP_COLOR], &rv);
         if (prop && Z_TYPE_P(prop) != IS_NULL) {
             parse_color(prop, &node->border_top_color);
         }
 
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "borderRightColor", sizeof("borderRightColor")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_BORDER_RIGHT_COLOR], &rv);
         if (prop && Z_TYPE_P(prop) != IS_NULL) {
             parse_color(prop, &node->border_right_color);
         }
 
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "borderBottomColor", sizeof("borderBottomColor")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_BORDER_BOTTOM_COLOR], &rv);
         if (prop && Z_TYPE_P(prop) != IS_NULL) {
             parse_color(prop, &node->border_bottom_color);
         }
 
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "borderLeftColor", sizeof("borderLeftColor")-1, 1, &rv);
+        prop = node_prop(zobj, &box_props[BOX_BORDER_LEFT_COLOR], &rv);
         if (prop && Z_TYPE_P(prop) != IS_NULL) {
             parse_color(prop, &node->border_left_color);
         }
 
-        /* Process children */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "children", sizeof("children")-1, 1, &rv);
-        if (prop && Z_TYPE_P(prop) == IS_ARRAY) {
-            HashTable *ht = Z_ARRVAL_P(prop);
-            zval *child;
-            ZEND_HASH_FOREACH_VAL(ht, child) {
-                tui_node *child_node = php_to_tui_node(child, depth + 1);
-                if (child_node) {
-                    if (tui_node_append_child(node, child_node) < 0) {
-                        /* Failed to append - destroy the orphan child to prevent leak */
-                        tui_node_destroy(child_node);
-                    }
-                }
-            } ZEND_HASH_FOREACH_END();
-        }
-
     } else if (instanceof_function(ce, tui_text_ce)) {
         /* Get text content (with length limit) */
-        zval *prop = zend_read_property(ce, Z_OBJ_P(obj), "content", sizeof("content")-1, 1, &rv);
+        zval *prop = node_prop(zobj, &text_props[TEXT_CONTENT], &rv);
         const char *text = "";
         size_t text_len = 0;
         if (prop && Z_TYPE_P(prop) == IS_STRING) {
@@ -1650,63 +1953,59 @@ tui_node* php_to_tui_node(zval *obj, int depth)
 text_node_created:
 
         /* Apply style properties */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "color", sizeof("color")-1, 1, &rv);
+        prop = node_prop(zobj, &text_props[TEXT_COLOR], &rv);
         if (prop && Z_TYPE_P(prop) != IS_NULL) {
             parse_color(prop, &node->style.fg);
         }
 
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "backgroundColor", sizeof("backgroundColor")-1, 1, &rv);
+        prop = node_prop(zobj, &text_props[TEXT_BACKGROUND_COLOR], &rv);
         if (prop && Z_TYPE_P(prop) != IS_NULL) {
             parse_color(prop, &node->style.bg);
         }
 
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "bold", sizeof("bold")-1, 1, &rv);
+        prop = node_prop(zobj, &text_props[TEXT_BOLD], &rv);
         if (prop && zend_is_true(prop)) {
             node->style.bold = 1;
         }
 
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "dim", sizeof("dim")-1, 1, &rv);
+        prop = node_prop(zobj, &text_props[TEXT_DIM], &rv);
         if (prop && zend_is_true(prop)) {
             node->style.dim = 1;
         }
 
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "italic", sizeof("italic")-1, 1, &rv);
+        prop = node_prop(zobj, &text_props[TEXT_ITALIC], &rv);
         if (prop && zend_is_true(prop)) {
             node->style.italic = 1;
         }
 
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "underline", sizeof("underline")-1, 1, &rv);
+        prop = node_prop(zobj, &text_props[TEXT_UNDERLINE], &rv);
         if (prop && zend_is_true(prop)) {
             node->style.underline = 1;
         }
 
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "inverse", sizeof("inverse")-1, 1, &rv);
+        prop = node_prop(zobj, &text_props[TEXT_INVERSE], &rv);
         if (prop && zend_is_true(prop)) {
             node->style.inverse = 1;
         }
 
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "strikethrough", sizeof("strikethrough")-1, 1, &rv);
+        prop = node_prop(zobj, &text_props[TEXT_STRIKETHROUGH], &rv);
         if (prop && zend_is_true(prop)) {
             node->style.strikethrough = 1;
         }
 
         /* wrap mode */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "wrap", sizeof("wrap")-1, 1, &rv);
+        prop = node_prop(zobj, &text_props[TEXT_WRAP], &rv);
         if (prop && Z_TYPE_P(prop) == IS_STRING) {
-            const char *wrap = Z_STRVAL_P(prop);
-            if (strcmp(wrap, "word") == 0) {
-                node->wrap_mode = TUI_WRAP_WORD;
-            } else if (strcmp(wrap, "char") == 0) {
-                node->wrap_mode = TUI_WRAP_CHAR;
-            } else if (strcmp(wrap, "word-char") == 0) {
-                node->wrap_mode = TUI_WRAP_WORD_CHAR;
-            } else {
-                node->wrap_mode = TUI_WRAP_NONE;
+            switch (style_keyword(prop)) {
+                case TUI_KW_WORD:      node->wrap_mode = TUI_WRAP_WORD;      break;
+                case TUI_KW_CHAR:      node->wrap_mode = TUI_WRAP_CHAR;      break;
+                case TUI_KW_WORD_CHAR: node->wrap_mode = TUI_WRAP_WORD_CHAR; break;
+                default:               node->wrap_mode = TUI_WRAP_NONE;      break;
             }
         }
 
         /* key - for reconciliation (with length limit, uses string interning) */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "key", sizeof("key")-1, 1, &rv);
+        prop = node_prop(zobj, &text_props[TEXT_KEY], &rv);
         if (prop && Z_TYPE_P(prop) == IS_STRING) {
             size_t key_len = Z_STRLEN_P(prop);
             if (key_len > TUI_MAX_KEY_LENGTH) {
@@ -1722,7 +2021,7 @@ text_node_created:
         }
 
         /* id - for focus-by-id and measureElement (with length limit) */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "id", sizeof("id")-1, 1, &rv);
+        prop = node_prop(zobj, &text_props[TEXT_ID], &rv);
         if (prop && Z_TYPE_P(prop) == IS_STRING) {
             size_t id_len = Z_STRLEN_P(prop);
             if (id_len > TUI_MAX_ID_LENGTH) {
@@ -1742,7 +2041,7 @@ text_node_created:
         }
 
         /* hyperlink - OSC 8 hyperlink URL */
-        prop = zend_read_property(ce, Z_OBJ_P(obj), "hyperlink", sizeof("hyperlink")-1, 1, &rv);
+        prop = node_prop(zobj, &text_props[TEXT_HYPERLINK], &rv);
         if (prop && Z_TYPE_P(prop) == IS_STRING) {
             if (tui_node_set_hyperlink(node, Z_STRVAL_P(prop), NULL) < 0) {
                 tui_node_destroy(node);
@@ -1751,8 +2050,8 @@ text_node_created:
         } else if (prop && Z_TYPE_P(prop) == IS_ARRAY) {
             /* Allow {url: 'http://...', id: 'link-1'} format */
             HashTable *ht = Z_ARRVAL_P(prop);
-            zval *url_val = zend_hash_str_find(ht, "url", sizeof("url")-1);
-            zval *id_val = zend_hash_str_find(ht, "id", sizeof("id")-1);
+            zval *url_val = zend_hash_str_find_deref(ht, "url", sizeof("url")-1);
+            zval *id_val = zend_hash_str_find_deref(ht, "id", sizeof("id")-1);
             const char *url = (url_val && Z_TYPE_P(url_val) == IS_STRING) ? Z_STRVAL_P(url_val) : NULL;
             const char *link_id = (id_val && Z_TYPE_P(id_val) == IS_STRING) ? Z_STRVAL_P(id_val) : NULL;
             if (url && tui_node_set_hyperlink(node, url, link_id) < 0) {
@@ -1765,6 +2064,150 @@ text_node_created:
     return node;
 }
 
+/* Whether an object's properties may hold references. Writes through a
+ * reference bypass write_property, so such an object is rebuilt every
+ * time until the references are gone. */
+static int node_object_has_refs(zend_object *zobj)
+{
+    zval *prop = zobj->properties_table;
+    zval *end = prop + zobj->ce->default_properties_count;
+
+    for (; prop < end; prop++) {
+        if (Z_ISREF_P(prop)) return 1;
+    }
+    return 0;
+}
+
+/* Whether an array holds references, at any depth. Assigning to their
+ * target changes the array without a write to the object. */
+static int node_array_has_refs(HashTable *ht, int depth)
+{
+    zval *val;
+
+    if (GC_FLAGS(ht) & IS_ARRAY_IMMUTABLE) return 0;
+    if (depth > 8) return 1;
+
+    ZEND_HASH_FOREACH_VAL(ht, val) {
+        if (Z_ISREF_P(val)) return 1;
+        if (Z_TYPE_P(val) == IS_ARRAY && node_array_has_refs(Z_ARRVAL_P(val), depth + 1)) {
+            return 1;
+        }
+    } ZEND_HASH_FOREACH_END();
+    return 0;
+}
+
+/* Whether an array-valued property (borderColor, hyperlink, ...) holds
+ * references. Children are converted on every render anyway. */
+static int node_object_has_array_refs(zend_object *zobj)
+{
+    zval *prop = zobj->properties_table;
+    zval *end = prop + zobj->ce->default_properties_count;
+    zval *children = box_props[BOX_CHILDREN].offset && instanceof_function(zobj->ce, tui_box_ce)
+        ? OBJ_PROP(zobj, box_props[BOX_CHILDREN].offset) : NULL;
+
+    for (; prop < end; prop++) {
+        if (prop != children && Z_TYPE_P(prop) == IS_ARRAY &&
+            node_array_has_refs(Z_ARRVAL_P(prop), 0)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Node for an object's own properties, copied from the native node the
+ * object keeps when no property was written since it was built */
+static tui_node* node_from_object(zend_object *zobj)
+{
+    zend_class_entry *ce = zobj->ce;
+
+    /* A hook or __get() can return something else on every read */
+    if (zobj->handlers != &tui_node_object_handlers || ce->num_hooked_props || ce->__get) {
+        return node_from_props(zobj);
+    }
+
+    /* Properties fetched by pointer, or a materialized property table
+     * (foreach by reference), may have left references behind */
+    tui_node_object *intern = tui_node_object_from_obj(zobj);
+    if (intern->indirect || zobj->properties) {
+        if (node_object_has_refs(zobj)) {
+            intern->dirty = 1;
+        } else {
+            intern->indirect = 0;
+        }
+    }
+
+    if (intern->dirty || intern->array_refs || !intern->native) {
+        /* Heap, not the frame arena: it lives as long as the object */
+        tui_arena *arena = tui_node_set_arena(NULL);
+        tui_node *native = node_from_props(zobj);
+        tui_node_set_arena(arena);
+        if (!native) return NULL;
+
+        tui_node_destroy(intern->native);
+        intern->native = native;
+        intern->dirty = 0;
+        intern->array_refs = node_object_has_array_refs(zobj);
+        TUI_METRIC_INC(nodes_converted);
+    } else {
+        TUI_METRIC_INC(nodes_copied);
+    }
+
+    return tui_node_clone(intern->native);
+}
+
+/**
+ * Convert a PHP TuiBox/TuiText object to a C tui_node structure.
+ *
+ * @param obj   The PHP object (must be TuiBox or TuiText instance)
+ * @param depth Current recursion depth (for stack overflow protection)
+ * @return      Newly allocated tui_node, or NULL on error
+ *
+ * The returned node and its children must be freed with tui_node_destroy().
+ * This function is exposed for use by split modules (tui_render.c, etc.).
+ */
+tui_node* php_to_tui_node(zval *obj, int depth)
+{
+    if (!obj || Z_TYPE_P(obj) != IS_OBJECT) {
+        return NULL;
+    }
+
+    /* Prevent stack overflow from deeply nested trees.
+     * MAX_TREE_DEPTH is defined in tui_internal.h (default: 256) */
+    if (depth > MAX_TREE_DEPTH) {
+        php_error_docref(NULL, E_WARNING, "Maximum node tree depth exceeded (%d)", MAX_TREE_DEPTH);
+        return NULL;
+    }
+
+    zend_object *zobj = Z_OBJ_P(obj);
+    if (!instanceof_function(zobj->ce, tui_box_ce) && !instanceof_function(zobj->ce, tui_text_ce)) {
+        return NULL;
+    }
+
+    tui_node *node = node_from_object(zobj);
+    if (!node || !instanceof_function(zobj->ce, tui_box_ce)) {
+        return node;
+    }
+
+    /* Process children (never cached: each child is an object of its own) */
+    zval rv;
+    zval *prop = node_prop(zobj, &box_props[BOX_CHILDREN], &rv);
+    if (prop && Z_TYPE_P(prop) == IS_ARRAY) {
+        HashTable *ht = Z_ARRVAL_P(prop);
+        zval *child;
+        ZEND_HASH_FOREACH_VAL(ht, child) {
+            tui_node *child_node = php_to_tui_node(child, depth + 1);
+            if (child_node) {
+                if (tui_node_append_child(node, child_node) < 0) {
+                    /* Failed to append - destroy the orphan child to prevent leak */
+                    tui_node_destroy(child_node);
+                }
+            }
+        } ZEND_HASH_FOREACH_END();
+    }
+
+    return node;
+}
+
 /* ==========================================================================
  * CLASS METHODS
  *
@@ -1944,6 +2387,12 @@ static const zend_function_entry tui_functions[] = {
     PHP_FE(tui_test_run_timers, arginfo_tui_test_run_timers)
     PHP_FE(tui_test_get_by_id, arginfo_tui_test_get_by_id)
     PHP_FE(tui_test_get_by_text, arginfo_tui_test_get_by_text)
+    PHP_FE(tui_test_get_focused, arginfo_tui_test_get_focused)
+    PHP_FE(tui_test_set_terminal, arginfo_tui_test_set_terminal)
+    PHP_FE(tui_test_get_frame, arginfo_tui_test_get_frame)
+    PHP_FE(tui_test_add_layer, arginfo_tui_test_add_layer)
+    PHP_FE(tui_test_update_layer, arginfo_tui_test_update_layer)
+    PHP_FE(tui_test_remove_layer, arginfo_tui_test_remove_layer)
 
     /* Metrics functions */
     PHP_FE(tui_metrics_enable, arginfo_tui_metrics_enable)
@@ -2058,6 +2507,17 @@ static PHP_GINIT_FUNCTION(tui)
 /* }}} */
 
 /* {{{ INI settings */
+
+/* tui.min_render_interval: 0 (no throttling) to TUI_FRAME_INTERVAL_MAX_MS */
+static ZEND_INI_MH(OnUpdateMinRenderInterval)
+{
+    zend_long value = ZEND_STRTOL(ZSTR_VAL(new_value), NULL, 10);
+    if (value < 0 || value > TUI_FRAME_INTERVAL_MAX_MS) {
+        return FAILURE;
+    }
+    return OnUpdateLong(entry, new_value, mh_arg1, mh_arg2, mh_arg3, stage);
+}
+
 PHP_INI_BEGIN()
     STD_PHP_INI_ENTRY("tui.max_buffer_width", "500", PHP_INI_ALL,
                       OnUpdateLong, max_buffer_width, zend_tui_globals, tui_globals)
@@ -2070,7 +2530,11 @@ PHP_INI_BEGIN()
     STD_PHP_INI_ENTRY("tui.max_timers", "32", PHP_INI_ALL,
                       OnUpdateLong, max_timers, zend_tui_globals, tui_globals)
     STD_PHP_INI_ENTRY("tui.min_render_interval", "16", PHP_INI_ALL,
-                      OnUpdateLong, min_render_interval, zend_tui_globals, tui_globals)
+                      OnUpdateMinRenderInterval, min_render_interval, zend_tui_globals, tui_globals)
+    STD_PHP_INI_ENTRY("tui.encode_threads", "0", PHP_INI_ALL,
+                      OnUpdateLong, encode_threads, zend_tui_globals, tui_globals)
+    STD_PHP_INI_ENTRY("tui.node_arena", "0", PHP_INI_ALL,
+                      OnUpdateBool, node_arena, zend_tui_globals, tui_globals)
     STD_PHP_INI_ENTRY("tui.metrics_enabled", "0", PHP_INI_ALL,
                       OnUpdateBool, metrics_enabled, zend_tui_globals, tui_globals)
 PHP_INI_END()
@@ -2089,6 +2553,9 @@ static PHP_MINIT_FUNCTION(tui)
         (int)TUI_G(max_buffer_height)
     );
 
+    /* Pick the row diff kernel (SSE2/AVX2) after checking it against the scalar loop */
+    tui_row_diff_init();
+
     /* Initialize shared Yoga configuration */
     TUI_G(yoga_config) = YGConfigNew();
     if (TUI_G(yoga_config)) {
@@ -2183,6 +2650,7 @@ static PHP_MINIT_FUNCTION(tui)
     /* Register Xocdr\Tui\Ext\ContainerNode class with methods */
     INIT_CLASS_ENTRY(ce, "Xocdr\\Tui\\Ext\\ContainerNode", tui_box_methods);
     tui_box_ce = zend_register_internal_class(&ce);
+    tui_box_ce->create_object = tui_node_object_create;
     zend_class_implements(tui_box_ce, 1, tui_node_interface_ce);
 
     /* TuiBox properties */
@@ -2226,6 +2694,7 @@ static PHP_MINIT_FUNCTION(tui)
     zend_declare_property_null(tui_box_ce, "direction", sizeof("direction")-1, ZEND_ACC_PUBLIC);
     zend_declare_property_null(tui_box_ce, "borderStyle", sizeof("borderStyle")-1, ZEND_ACC_PUBLIC);
     zend_declare_property_null(tui_box_ce, "borderColor", sizeof("borderColor")-1, ZEND_ACC_PUBLIC);
+    zend_declare_property_null(tui_box_ce, "backgroundColor", sizeof("backgroundColor")-1, ZEND_ACC_PUBLIC);
     zend_declare_property_bool(tui_box_ce, "focusable", sizeof("focusable")-1, 0, ZEND_ACC_PUBLIC);
     zend_declare_property_bool(tui_box_ce, "focused", sizeof("focused")-1, 0, ZEND_ACC_PUBLIC);
     zend_declare_property_long(tui_box_ce, "tabIndex", sizeof("tabIndex")-1, 0, ZEND_ACC_PUBLIC);
@@ -2250,8 +2719,18 @@ static PHP_MINIT_FUNCTION(tui)
     /* Register Xocdr\Tui\Ext\ContentNode class with methods */
     INIT_CLASS_ENTRY(ce, "Xocdr\\Tui\\Ext\\ContentNode", tui_text_methods);
     tui_text_ce = zend_register_internal_class(&ce);
+    tui_text_ce->create_object = tui_node_object_create;
     zend_class_implements(tui_text_ce, 1, tui_node_interface_ce);
 
+    /* Shared by both node classes and everything extending them */
+    memcpy(&tui_node_object_handlers, zend_get_std_object_handlers(), sizeof(zend_object_handlers));
+    tui_node_object_handlers.offset = XtOffsetOf(tui_node_object, std);
+    tui_node_object_handlers.free_obj = tui_node_object_free;
+    tui_node_object_handlers.clone_obj = tui_node_object_clone;
+    tui_node_object_handlers.write_property = tui_node_object_write_property;
+    tui_node_object_handlers.unset_property = tui_node_object_unset_property;
+    tui_node_object_handlers.get_property_ptr_ptr = tui_node_object_get_property_ptr_ptr;
+
     /* TuiText properties */
     zend_declare_property_string(tui_text_ce, "content", sizeof("content")-1, "", ZEND_ACC_PUBLIC);
     zend_declare_property_null(tui_text_ce, "color", sizeof("color")-1, ZEND_ACC_PUBLIC);
@@ -2267,6 +2746,10 @@ static PHP_MINIT_FUNCTION(tui)
     zend_declare_property_null(tui_text_ce, "key", sizeof("key")-1, ZEND_ACC_PUBLIC);
     zend_declare_property_null(tui_text_ce, "id", sizeof("id")-1, ZEND_ACC_PUBLIC);
 
+    /* Property slots read by php_to_tui_node() */
+    resolve_node_props(tui_box_ce, box_props, BOX_PROP_COUNT);
+    resolve_node_props(tui_text_ce, text_props, TEXT_PROP_COUNT);
+
     /* Register Xocdr\Tui\Ext\Instance class with methods and custom object handlers */
     INIT_CLASS_ENTRY(ce, "Xocdr\\Tui\\Ext\\Instance", tui_instance_methods);
     tui_instance_ce = zend_register_internal_class(&ce);
@@ -2458,6 +2941,7 @@ static PHP_MINFO_FUNCTION(tui)
     php_info_print_table_start();
     php_info_print_table_header(2, "tui support", "enabled");
     php_info_print_table_row(2, "Version", PHP_TUI_VERSION);
+    php_info_print_table_row(2, "Row diff kernel", tui_row_diff_kernel_name());
     php_info_print_table_end();
 
     DISPLAY_INI_ENTRIES();
@@ -641,6 +641,36 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_tui_test_get_by_text, 0, 2, IS_A
     ZEND_ARG_TYPE_INFO(0, text, IS_STRING, 0)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_tui_test_get_focused, 0, 1, IS_ARRAY, 1)
+    ZEND_ARG_INFO(0, renderer)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_tui_test_set_terminal, 0, 1, IS_VOID, 0)
+    ZEND_ARG_INFO(0, renderer)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, options, IS_ARRAY, 0, "[]")
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_tui_test_get_frame, 0, 1, IS_STRING, 1)
+    ZEND_ARG_INFO(0, renderer)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_tui_test_add_layer, 0, 2, IS_LONG, 0)
+    ZEND_ARG_INFO(0, renderer)
+    ZEND_ARG_TYPE_INFO(0, node, IS_OBJECT, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, zIndex, IS_LONG, 0, "1")
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_tui_test_update_layer, 0, 3, IS_VOID, 0)
+    ZEND_ARG_INFO(0, renderer)
+    ZEND_ARG_TYPE_INFO(0, layerId, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, node, IS_OBJECT, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_tui_test_remove_layer, 0, 2, IS_VOID, 0)
+    ZEND_ARG_INFO(0, renderer)
+    ZEND_ARG_TYPE_INFO(0, layerId, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
 /* Metrics functions */
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_tui_metrics_enable, 0, 0, IS_VOID, 0)
 ZEND_END_ARG_INFO()
@@ -121,6 +121,12 @@ PHP_FUNCTION(tui_buffer_clear)
 }
 /* }}} */
 
+int tui_smart_str_sink(void *ctx, const char *data, size_t len)
+{
+    smart_str_appendl((smart_str *)ctx, data, len);
+    return 0;
+}
+
 /* {{{ tui_buffer_render(resource $buffer): string */
 PHP_FUNCTION(tui_buffer_render)
 {
@@ -135,13 +141,9 @@ PHP_FUNCTION(tui_buffer_render)
         RETURN_THROWS();
     }
 
-    char *output = tui_buffer_to_string(buffer);
-    if (output) {
-        RETVAL_STRING(output);
-        free(output);
-    } else {
-        RETURN_EMPTY_STRING();
-    }
+    smart_str output = {0};
+    tui_output_serialize(NULL, buffer, tui_smart_str_sink, &output);
+    RETURN_STR(smart_str_extract(&output));
 }
 /* }}} */
 
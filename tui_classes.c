@@ -649,6 +649,11 @@ const zend_function_entry tui_text_methods[] = {
  * - addTimer(intervalMs, callback): Add recurring timer
  * - removeTimer(timerId): Remove a timer
  *
+ * Layers:
+ * - addLayer(node, zIndex): Show a node tree above the main UI
+ * - updateLayer(layerId, node): Replace a layer's tree
+ * - removeLayer(layerId): Remove a layer
+ *
  * The Instance wraps an internal tui_app structure that holds:
  * - The current node tree
  * - State slots (dynamic array, max: tui.max_states)
@@ -667,11 +672,8 @@ PHP_METHOD(TuiInstance, rerender)
 
     tui_instance_object *obj = Z_TUI_INSTANCE_P(ZEND_THIS);
     if (obj->app) {
-        /* Use rerender_callback to properly rebuild tree with Instance parameter */
-        if (obj->app->rerender_callback) {
-            obj->app->rerender_callback(obj->app);
-        }
-        tui_app_render_tree(obj->app);
+        /* Coalesced by the frame scheduler while the event loop runs */
+        tui_app_request_render(obj->app);
     }
 }
 /* }}} */
@@ -1213,6 +1215,128 @@ PHP_METHOD(TuiInstance, removeTimer)
 }
 /* }}} */
 
+/* Convert a layer tree argument, throwing unless it is a Box or Text */
+tui_node* tui_layer_node_from_zval(zval *znode)
+{
+    if (!instanceof_function(Z_OBJCE_P(znode), tui_box_ce) &&
+        !instanceof_function(Z_OBJCE_P(znode), tui_text_ce)) {
+        zend_throw_exception(tui_validation_exception_ce,
+            "Layer must be a ContainerNode or ContentNode", 0);
+        return NULL;
+    }
+
+    tui_node *node = php_to_tui_node(znode, 0);
+    if (!node && !EG(exception)) {
+        zend_throw_exception(tui_validation_exception_ce, "Failed to build layer tree", 0);
+    }
+    return node;
+}
+
+/* {{{ TuiInstance::addLayer(ContainerNode|ContentNode $node, int $zIndex = 1): int
+ * Shows a node tree above the main UI (modal, popup, toast). The layer is
+ * laid out and drawn on its own, so the main UI underneath is not
+ * re-rendered. A layer whose root has a backgroundColor hides what is
+ * below its box. */
+PHP_METHOD(TuiInstance, addLayer)
+{
+    zval *znode;
+    zend_long z_index = 1;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_OBJECT(znode)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(z_index)
+    ZEND_PARSE_PARAMETERS_END();
+
+    tui_instance_object *obj = Z_TUI_INSTANCE_P(ZEND_THIS);
+    if (!obj->app) {
+        zend_throw_exception(tui_instance_destroyed_exception_ce,
+            "TuiInstance has been destroyed or unmounted", 0);
+        RETURN_THROWS();
+    }
+    if (z_index < INT_MIN || z_index > INT_MAX) {
+        zend_argument_value_error(2, "must be a 32-bit integer");
+        RETURN_THROWS();
+    }
+
+    tui_node *node = tui_layer_node_from_zval(znode);
+    if (!node) {
+        RETURN_THROWS();
+    }
+
+    int id = tui_app_add_layer(obj->app, node, (int)z_index);
+    if (id < 0) {
+        zend_throw_exception(tui_resource_exception_ce, "Failed to allocate layer", 0);
+        RETURN_THROWS();
+    }
+    RETURN_LONG(id);
+}
+/* }}} */
+
+/* {{{ TuiInstance::updateLayer(int $layerId, ContainerNode|ContentNode $node): void */
+PHP_METHOD(TuiInstance, updateLayer)
+{
+    zend_long layer_id;
+    zval *znode;
+
+    ZEND_PARSE_PARAMETERS_START(2, 2)
+        Z_PARAM_LONG(layer_id)
+        Z_PARAM_OBJECT(znode)
+    ZEND_PARSE_PARAMETERS_END();
+
+    tui_instance_object *obj = Z_TUI_INSTANCE_P(ZEND_THIS);
+    if (!obj->app) {
+        zend_throw_exception(tui_instance_destroyed_exception_ce,
+            "TuiInstance has been destroyed or unmounted", 0);
+        RETURN_THROWS();
+    }
+
+    if (layer_id < INT_MIN || layer_id > INT_MAX) {
+        zend_argument_value_error(1, "is not a layer of this instance");
+        RETURN_THROWS();
+    }
+
+    /* The tree is only reconciled into the layer, so it can use the frame arena */
+    tui_arena *arena = tui_node_arena_acquire();
+    tui_node *node = tui_layer_node_from_zval(znode);
+    if (!node) {
+        tui_node_arena_release(arena);
+        RETURN_THROWS();
+    }
+
+    /* Takes ownership of node, also on failure */
+    int result = tui_app_update_layer(obj->app, (int)layer_id, node);
+    tui_node_arena_release(arena);
+    if (result < 0) {
+        zend_argument_value_error(1, "is not a layer of this instance");
+        RETURN_THROWS();
+    }
+}
+/* }}} */
+
+/* {{{ TuiInstance::removeLayer(int $layerId): void */
+PHP_METHOD(TuiInstance, removeLayer)
+{
+    zend_long layer_id;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_LONG(layer_id)
+    ZEND_PARSE_PARAMETERS_END();
+
+    tui_instance_object *obj = Z_TUI_INSTANCE_P(ZEND_THIS);
+    if (!obj->app) {
+        zend_throw_exception(tui_instance_destroyed_exception_ce,
+            "TuiInstance has been destroyed or unmounted", 0);
+        RETURN_THROWS();
+    }
+    if (layer_id < INT_MIN || layer_id > INT_MAX ||
+        tui_app_remove_layer(obj->app, (int)layer_id) < 0) {
+        zend_argument_value_error(1, "is not a layer of this instance");
+        RETURN_THROWS();
+    }
+}
+/* }}} */
+
 /* {{{ TuiInstance::clear(): void */
 PHP_METHOD(TuiInstance, clear)
 {
@@ -1227,6 +1351,7 @@ PHP_METHOD(TuiInstance, clear)
     if (obj->app->buffer) {
         tui_buffer_clear(obj->app->buffer);
         tui_output_flush(obj->app->output);
+        obj->app->repaint_all = 1;
     }
 }
 /* }}} */
@@ -1258,14 +1383,12 @@ PHP_METHOD(TuiInstance, captureFrame)
         RETURN_NULL();
     }
 
-    char *frame = tui_buffer_to_string(obj->app->buffer);
-    if (!frame) {
+    smart_str frame = {0};
+    if (tui_output_serialize(obj->app->output, obj->app->buffer, tui_smart_str_sink, &frame) < 0) {
+        smart_str_free(&frame);
         RETURN_NULL();
     }
-
-    zend_string *result = zend_string_init(frame, strlen(frame), 0);
-    free(frame);
-    RETURN_STR(result);
+    RETURN_STR(smart_str_extract(&frame));
 }
 /* }}} */
 
@@ -1354,6 +1477,20 @@ ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_tuiinstance_removetimer, 0, 1, I
     ZEND_ARG_TYPE_INFO(0, timerId, IS_LONG, 0)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_tuiinstance_addlayer, 0, 1, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, node, IS_OBJECT, 0)
+    ZEND_ARG_TYPE_INFO_WITH_DEFAULT_VALUE(0, zIndex, IS_LONG, 0, "1")
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_tuiinstance_updatelayer, 0, 2, IS_VOID, 0)
+    ZEND_ARG_TYPE_INFO(0, layerId, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, node, IS_OBJECT, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_tuiinstance_removelayer, 0, 1, IS_VOID, 0)
+    ZEND_ARG_TYPE_INFO(0, layerId, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_tuiinstance_clear, 0, 0, IS_VOID, 0)
 ZEND_END_ARG_INFO()
 
@@ -1396,6 +1533,9 @@ const zend_function_entry tui_instance_methods[] = {
     PHP_ME(TuiInstance, setTickHandler, arginfo_tuiinstance_settickhandler, ZEND_ACC_PUBLIC)
     PHP_ME(TuiInstance, addTimer, arginfo_tuiinstance_addtimer, ZEND_ACC_PUBLIC)
     PHP_ME(TuiInstance, removeTimer, arginfo_tuiinstance_removetimer, ZEND_ACC_PUBLIC)
+    PHP_ME(TuiInstance, addLayer, arginfo_tuiinstance_addlayer, ZEND_ACC_PUBLIC)
+    PHP_ME(TuiInstance, updateLayer, arginfo_tuiinstance_updatelayer, ZEND_ACC_PUBLIC)
+    PHP_ME(TuiInstance, removeLayer, arginfo_tuiinstance_removelayer, ZEND_ACC_PUBLIC)
     PHP_ME(TuiInstance, clear, arginfo_tuiinstance_clear, ZEND_ACC_PUBLIC)
     PHP_ME(TuiInstance, getCapturedOutput, arginfo_tuiinstance_getcapturedoutput, ZEND_ACC_PUBLIC)
     PHP_ME(TuiInstance, captureFrame, arginfo_tuiinstance_captureframe, ZEND_ACC_PUBLIC)
@@ -21,12 +21,15 @@
 #include "ext/standard/info.h"
 #include "zend_exceptions.h"
 #include "zend_enum.h"
+#include "zend_smart_str.h"
 #include "php_tui.h"
 
 #include "src/text/measure.h"
 #include "src/text/wrap.h"
 #include "src/app/app.h"
 #include "src/node/node.h"
+#include "src/node/reconciler.h"
+#include "src/node/keywords.h"
 #include "src/terminal/terminal.h"
 #include "src/terminal/ansi.h"
 #include "src/event/input.h"
@@ -37,6 +40,7 @@
 #include "src/drawing/progress.h"
 #include "src/drawing/sprite.h"
 #include "src/render/buffer.h"
+#include "src/render/diff.h"
 #include "src/testing/renderer.h"
 #include "src/testing/query.h"
 #include "src/pool/pool.h"
@@ -137,6 +141,27 @@ static inline tui_focus_manager_object *tui_focus_manager_from_obj(zend_object *
 
 #define Z_TUI_FOCUS_MANAGER_P(zv) tui_focus_manager_from_obj(Z_OBJ_P(zv))
 
+/* ----------------------------------------------------------------
+ * ContainerNode/ContentNode custom object structure
+ *
+ * native holds the object's own properties (no children) converted
+ * to a tui_node, so unchanged objects are copied instead of read
+ * property by property on every render. Property writes set dirty;
+ * objects whose arrays hold references are rebuilt every time.
+ * ---------------------------------------------------------------- */
+typedef struct {
+    tui_node *native;       /* Built on first render, heap-owned */
+    uint8_t dirty;          /* A property was written since native was built */
+    uint8_t indirect;       /* A property was fetched for writing by pointer */
+    uint8_t array_refs;     /* An array-valued property held references when built */
+    zend_object std;
+} tui_node_object;
+
+/* Helper to get node object from zend_object */
+static inline tui_node_object *tui_node_object_from_obj(zend_object *obj) {
+    return (tui_node_object *)((char *)(obj) - XtOffsetOf(tui_node_object, std));
+}
+
 /* ----------------------------------------------------------------
  * Named Color lookup (used by Color enum and php_to_tui_node)
  * ---------------------------------------------------------------- */
@@ -173,11 +198,13 @@ extern const zend_function_entry tui_stderr_context_methods[];
 extern zend_object_handlers tui_instance_handlers;
 extern zend_object_handlers tui_focus_handlers;
 extern zend_object_handlers tui_focus_manager_handlers;
+extern zend_object_handlers tui_node_object_handlers;
 
 /* Object creation functions */
 zend_object *tui_instance_create_object(zend_class_entry *ce);
 zend_object *tui_focus_create_object(zend_class_entry *ce);
 zend_object *tui_focus_manager_create_object(zend_class_entry *ce);
+zend_object *tui_node_object_create(zend_class_entry *ce);
 
 /* ----------------------------------------------------------------
  * Shared utility functions
@@ -186,9 +213,16 @@ zend_object *tui_focus_manager_create_object(zend_class_entry *ce);
 /* Parse PHP array/object to tui_node tree */
 tui_node* php_to_tui_node(zval *znode, int depth);
 
+/* Convert a layer tree (ContainerNode or ContentNode); throws and
+ * returns NULL otherwise (tui_classes.c) */
+tui_node* tui_layer_node_from_zval(zval *znode);
+
 /* Parse style array to tui_style */
 void parse_style_array(zval *style_arr, tui_style *style);
 
+/* tui_output_serialize() sink appending to a smart_str (ctx) */
+int tui_smart_str_sink(void *ctx, const char *data, size_t len);
+
 /* Register all resources, classes, and constants */
 void tui_register_resources(int module_number);
 void tui_register_classes(void);
@@ -337,6 +371,12 @@ PHP_FUNCTION(tui_test_advance_frame);
 PHP_FUNCTION(tui_test_run_timers);
 PHP_FUNCTION(tui_test_get_by_id);
 PHP_FUNCTION(tui_test_get_by_text);
+PHP_FUNCTION(tui_test_get_focused);
+PHP_FUNCTION(tui_test_set_terminal);
+PHP_FUNCTION(tui_test_get_frame);
+PHP_FUNCTION(tui_test_add_layer);
+PHP_FUNCTION(tui_test_update_layer);
+PHP_FUNCTION(tui_test_remove_layer);
 
 /* Metrics functions (tui_metrics.c) */
 PHP_FUNCTION(tui_metrics_enable);
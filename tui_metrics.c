@@ -62,6 +62,8 @@ PHP_FUNCTION(tui_get_metrics)
     add_assoc_long(return_value, "text_count", (zend_long)m->text_count);
     add_assoc_long(return_value, "static_count", (zend_long)m->static_count);
     add_assoc_long(return_value, "max_depth", (zend_long)m->max_depth);
+    add_assoc_long(return_value, "nodes_converted", (zend_long)m->nodes_converted);
+    add_assoc_long(return_value, "nodes_copied", (zend_long)m->nodes_copied);
 
     /* Reconciler metrics */
     add_assoc_long(return_value, "diff_runs", (zend_long)m->diff_runs);
@@ -102,6 +104,17 @@ PHP_FUNCTION(tui_get_metrics)
     add_assoc_long(return_value, "timer_fires", (zend_long)m->timer_fires);
     add_assoc_long(return_value, "poll_errors", (zend_long)m->poll_errors);
 
+    /* Output metrics */
+    add_assoc_long(return_value, "output_bytes", (zend_long)m->output_bytes);
+    add_assoc_long(return_value, "output_writes", (zend_long)m->output_writes);
+    add_assoc_long(return_value, "cells_changed", (zend_long)m->cells_changed);
+    add_assoc_long(return_value, "rows_touched", (zend_long)m->rows_touched);
+    add_assoc_long(return_value, "cursor_moves", (zend_long)m->cursor_moves);
+    add_assoc_long(return_value, "sgr_sequences", (zend_long)m->sgr_sequences);
+    add_assoc_long(return_value, "link_sequences", (zend_long)m->link_sequences);
+    add_assoc_long(return_value, "full_redraws", (zend_long)m->full_redraws);
+    add_assoc_long(return_value, "damaged_cells", (zend_long)m->damaged_cells);
+
     /* Pool metrics */
     if (TUI_G(pools)) {
         tui_pools *p = TUI_G(pools);
@@ -110,6 +123,12 @@ PHP_FUNCTION(tui_get_metrics)
         add_assoc_long(return_value, "pool_children_returns", (zend_long)p->children_returns);
         add_assoc_long(return_value, "pool_keymap_reuses", (zend_long)p->key_map_reuses);
         add_assoc_long(return_value, "pool_keymap_misses", (zend_long)p->key_map_misses);
+        add_assoc_long(return_value, "pool_wrap_cache_hits", (zend_long)p->wrap_cache.hits);
+        add_assoc_long(return_value, "pool_wrap_cache_misses", (zend_long)p->wrap_cache.misses);
+        add_assoc_long(return_value, "pool_color_cache_hits", (zend_long)p->color_cache.hits);
+        add_assoc_long(return_value, "pool_color_cache_misses", (zend_long)p->color_cache.misses);
+        add_assoc_long(return_value, "pool_yoga_hits", (zend_long)p->yoga_hits);
+        add_assoc_long(return_value, "pool_yoga_misses", (zend_long)p->yoga_misses);
     }
 }
 /* }}} */
@@ -127,6 +146,8 @@ PHP_FUNCTION(tui_get_node_metrics)
     add_assoc_long(return_value, "text_count", (zend_long)m->text_count);
     add_assoc_long(return_value, "static_count", (zend_long)m->static_count);
     add_assoc_long(return_value, "max_depth", (zend_long)m->max_depth);
+    add_assoc_long(return_value, "nodes_converted", (zend_long)m->nodes_converted);
+    add_assoc_long(return_value, "nodes_copied", (zend_long)m->nodes_copied);
 }
 /* }}} */
 
@@ -176,6 +197,31 @@ PHP_FUNCTION(tui_get_render_metrics)
     }
     add_assoc_double(return_value, "max_render_ms", (double)m->max_render_ns / 1000000.0);
     add_assoc_double(return_value, "min_render_ms", (double)m->min_render_ns / 1000000.0);
+
+    /* Output cost: running totals */
+    add_assoc_long(return_value, "output_bytes", (zend_long)m->output_bytes);
+    add_assoc_long(return_value, "output_writes", (zend_long)m->output_writes);
+    add_assoc_long(return_value, "cells_changed", (zend_long)m->cells_changed);
+    add_assoc_long(return_value, "rows_touched", (zend_long)m->rows_touched);
+    add_assoc_long(return_value, "cursor_moves", (zend_long)m->cursor_moves);
+    add_assoc_long(return_value, "sgr_sequences", (zend_long)m->sgr_sequences);
+    add_assoc_long(return_value, "link_sequences", (zend_long)m->link_sequences);
+    add_assoc_long(return_value, "full_redraws", (zend_long)m->full_redraws);
+    add_assoc_long(return_value, "damaged_cells", (zend_long)m->damaged_cells);
+
+    /* Output cost: most recent frame */
+    zval last_frame;
+    array_init(&last_frame);
+    add_assoc_long(&last_frame, "bytes", (zend_long)m->frame_bytes);
+    add_assoc_long(&last_frame, "writes", (zend_long)m->frame_writes);
+    add_assoc_long(&last_frame, "cells_changed", (zend_long)m->frame_cells_changed);
+    add_assoc_long(&last_frame, "rows_touched", (zend_long)m->frame_rows_touched);
+    add_assoc_long(&last_frame, "cursor_moves", (zend_long)m->frame_cursor_moves);
+    add_assoc_long(&last_frame, "sgr_sequences", (zend_long)m->frame_sgr_sequences);
+    add_assoc_long(&last_frame, "link_sequences", (zend_long)m->frame_link_sequences);
+    add_assoc_bool(&last_frame, "full_redraw", m->frame_full_redraw != 0);
+    add_assoc_long(&last_frame, "damaged_cells", (zend_long)m->frame_damaged_cells);
+    add_assoc_zval(return_value, "last_frame", &last_frame);
 }
 /* }}} */
 
@@ -209,6 +255,16 @@ PHP_FUNCTION(tui_get_pool_metrics)
         add_assoc_long(return_value, "children_reuses", (zend_long)p->children_returns);
         add_assoc_long(return_value, "keymap_reuses", (zend_long)p->key_map_reuses);
         add_assoc_long(return_value, "keymap_fallbacks", (zend_long)p->key_map_misses);
+        add_assoc_long(return_value, "wrap_cache_hits", (zend_long)p->wrap_cache.hits);
+        add_assoc_long(return_value, "wrap_cache_misses", (zend_long)p->wrap_cache.misses);
+        add_assoc_long(return_value, "wrap_cache_evictions", (zend_long)p->wrap_cache.evictions);
+        add_assoc_long(return_value, "color_cache_hits", (zend_long)p->color_cache.hits);
+        add_assoc_long(return_value, "color_cache_misses", (zend_long)p->color_cache.misses);
+        add_assoc_long(return_value, "arena_promotions", (zend_long)p->arena_promotions);
+        add_assoc_long(return_value, "yoga_allocs", (zend_long)p->yoga_hits);
+        add_assoc_long(return_value, "yoga_fallbacks", (zend_long)p->yoga_misses);
+        add_assoc_long(return_value, "yoga_reuses", (zend_long)p->yoga_returns);
+        add_assoc_long(return_value, "yoga_discards", (zend_long)p->yoga_discards);
 
         /* Pool efficiency percentages */
         int64_t total_children = p->children_hits + p->children_misses;
@@ -227,12 +283,40 @@ PHP_FUNCTION(tui_get_pool_metrics)
             add_assoc_double(return_value, "keymap_hit_rate", 0.0);
         }
 
+        int64_t total_yoga = p->yoga_hits + p->yoga_misses;
+        if (total_yoga > 0) {
+            add_assoc_double(return_value, "yoga_hit_rate",
+                (double)p->yoga_hits / (double)total_yoga * 100.0);
+        } else {
+            add_assoc_double(return_value, "yoga_hit_rate", 0.0);
+        }
+
+        int64_t total_wrap = p->wrap_cache.hits + p->wrap_cache.misses;
+        if (total_wrap > 0) {
+            add_assoc_double(return_value, "wrap_cache_hit_rate",
+                (double)p->wrap_cache.hits / (double)total_wrap * 100.0);
+        } else {
+            add_assoc_double(return_value, "wrap_cache_hit_rate", 0.0);
+        }
+
+        int64_t total_color = p->color_cache.hits + p->color_cache.misses;
+        if (total_color > 0) {
+            add_assoc_double(return_value, "color_cache_hit_rate",
+                (double)p->color_cache.hits / (double)total_color * 100.0);
+        } else {
+            add_assoc_double(return_value, "color_cache_hit_rate", 0.0);
+        }
+
         /* Pool state: current slot usage */
         add_assoc_long(return_value, "pool_4_slots_used", (zend_long)p->children.count_4);
         add_assoc_long(return_value, "pool_8_slots_used", (zend_long)p->children.count_8);
         add_assoc_long(return_value, "pool_16_slots_used", (zend_long)p->children.count_16);
         add_assoc_long(return_value, "pool_32_slots_used", (zend_long)p->children.count_32);
         add_assoc_bool(return_value, "keymap_in_use", p->key_map.in_use);
+        add_assoc_long(return_value, "yoga_pool_nodes", (zend_long)p->yoga.count);
+        add_assoc_long(return_value, "wrap_cache_entries", (zend_long)p->wrap_cache.used);
+        add_assoc_long(return_value, "arena_chunks", (zend_long)p->frame_arena.chunks);
+        add_assoc_long(return_value, "arena_peak_bytes", (zend_long)p->frame_arena.peak);
     }
 }
 /* }}} */
@@ -72,17 +72,16 @@ static void render_component_callback(tui_app *app)
 
     /* Convert PHP object tree to C node tree */
     if (Z_TYPE(retval) == IS_OBJECT) {
-        /* Free old tree AFTER building new tree to avoid dangling pointer.
-         * This ensures app->root_node is never pointing to freed memory. */
-        tui_node *old_tree = app->root_node;
-
-        /* Build new tree */
-        app->root_node = php_to_tui_node(&retval, 0);
-
-        /* Now safe to free old tree */
-        if (old_tree) {
-            tui_node_destroy(old_tree);
-        }
+        /* Build new tree, then patch the live tree with it. Matched nodes
+         * keep their Yoga nodes (and measure cache); app->root_node is only
+         * reassigned once the old tree is no longer referenced. */
+        tui_arena *arena = tui_node_arena_acquire();
+        tui_node *new_tree = php_to_tui_node(&retval, 0);
+        /* Clears focused_node if the patch destroys it */
+        app->root_node = tui_reconciler_reconcile(app->root_node, new_tree, &app->focused_node);
+        /* The rest of the new tree is destroyed: drop the frame in one go */
+        tui_node_arena_release(arena);
+        app->base.tree_dirty = 1;
     }
 
     zval_ptr_dtor(&retval);
@@ -218,6 +217,7 @@ PHP_FUNCTION(tui_render)
                 RETURN_THROWS();
             }
             app->root_node = php_to_tui_node(&retval, 0);
+            app->base.tree_dirty = 1;
         } else if (Z_TYPE(retval) != IS_NULL) {
             zval_ptr_dtor(&retval);
             zval_ptr_dtor(&params[0]);
@@ -275,8 +275,8 @@ PHP_FUNCTION(tui_rerender)
 
     tui_app *app = get_app_from_instance(instance);
     if (app) {
-        render_component_callback(app);  /* Call PHP component, build node tree */
-        tui_app_render_tree(app);        /* Render tree to screen (no double component call) */
+        /* Coalesced by the frame scheduler while the event loop runs */
+        tui_app_request_render(app);
     }
 }
 /* }}} */
@@ -112,7 +112,7 @@ PHP_FUNCTION(tui_cursor_shape)
     char buf[32];
     size_t len;
     tui_ansi_cursor_shape(buf, &len, cursor_shape);
-    tui_write_all(STDOUT_FILENO, buf, len);
+    tui_output_write(buf, len);
 }
 /* }}} */
 
@@ -124,7 +124,7 @@ PHP_FUNCTION(tui_cursor_show)
     char buf[32];
     size_t len;
     tui_ansi_cursor_show(buf, &len);
-    tui_write_all(STDOUT_FILENO, buf, len);
+    tui_output_write(buf, len);
 }
 /* }}} */
 
@@ -136,7 +136,7 @@ PHP_FUNCTION(tui_cursor_hide)
     char buf[32];
     size_t len;
     tui_ansi_cursor_hide(buf, &len);
-    tui_write_all(STDOUT_FILENO, buf, len);
+    tui_output_write(buf, len);
 }
 /* }}} */
 
@@ -165,7 +165,7 @@ PHP_FUNCTION(tui_set_title)
     tui_ansi_set_title(buf, buf_size, &len, ZSTR_VAL(title));
 
     if (len > 0) {
-        tui_write_all(STDOUT_FILENO, buf, len);
+        tui_output_write(buf, len);
     }
     efree(buf);
 }
@@ -179,7 +179,7 @@ PHP_FUNCTION(tui_reset_title)
     char buf[32];
     size_t len;
     tui_ansi_reset_title(buf, &len);
-    tui_write_all(STDOUT_FILENO, buf, len);
+    tui_output_write(buf, len);
 }
 /* }}} */
 
@@ -294,10 +294,10 @@ PHP_FUNCTION(tui_clipboard_copy)
         RETURN_FALSE;
     }
 
-    ssize_t written = write(STDOUT_FILENO, buf, (size_t)len);
+    int result = tui_output_write(buf, (size_t)len);
     efree(buf);
 
-    RETURN_BOOL(written == len);
+    RETURN_BOOL(result == 0);
 }
 /* }}} */
 
@@ -327,7 +327,7 @@ PHP_FUNCTION(tui_clipboard_request)
     char buf[32];
     size_t len;
     tui_ansi_clipboard_request(buf, &len, clipboard_target);
-    tui_write_all(STDOUT_FILENO, buf, len);
+    tui_output_write(buf, len);
 }
 /* }}} */
 
@@ -357,7 +357,7 @@ PHP_FUNCTION(tui_clipboard_clear)
     char buf[32];
     size_t len;
     tui_ansi_clipboard_clear(buf, &len, clipboard_target);
-    tui_write_all(STDOUT_FILENO, buf, len);
+    tui_output_write(buf, len);
 }
 /* }}} */
 
@@ -567,6 +567,7 @@ PHP_FUNCTION(tui_get_capabilities)
     add_assoc_bool(&capabilities, "title", tui_has_capability(caps, TUI_CAP_TITLE));
     add_assoc_bool(&capabilities, "focus_events", tui_has_capability(caps, TUI_CAP_FOCUS_EVENTS));
     add_assoc_bool(&capabilities, "alternate_screen", tui_has_capability(caps, TUI_CAP_ALTERNATE_SCREEN));
+    add_assoc_bool(&capabilities, "repeat", tui_has_capability(caps, TUI_CAP_REP));
 
     add_assoc_zval(return_value, "capabilities", &capabilities);
 }
@@ -616,6 +617,8 @@ PHP_FUNCTION(tui_has_capability)
         cap = TUI_CAP_FOCUS_EVENTS;
     } else if (zend_string_equals_literal(name, "alternate_screen")) {
         cap = TUI_CAP_ALTERNATE_SCREEN;
+    } else if (zend_string_equals_literal(name, "repeat")) {
+        cap = TUI_CAP_REP;
     } else {
         RETURN_FALSE;  /* Unknown capability */
     }
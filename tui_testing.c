@@ -10,6 +10,7 @@
 */
 
 #include "tui_internal.h"
+#include "src/terminal/capabilities.h"
 
 /* ------------------------------------------------------------------
  * Testing Framework Functions
@@ -72,8 +73,12 @@ PHP_FUNCTION(tui_test_render)
         RETURN_THROWS();
     }
 
-    /* Convert PHP element to tui_node tree */
+    /* Convert PHP element to tui_node tree. With tui.node_arena it is
+     * built in the arena the current tree isn't using. */
+    tui_arena *arena = TUI_G(node_arena) ? tui_test_renderer_frame_arena(renderer) : NULL;
+    tui_arena *previous = tui_node_set_arena(arena);
     tui_node *root = php_to_tui_node(zelement, 0);
+    tui_node_set_arena(previous);
     if (!root) {
         zend_throw_exception(tui_validation_exception_ce,
             "Failed to convert element to node", 0);
@@ -223,6 +228,24 @@ PHP_FUNCTION(tui_test_run_timers)
 }
 /* }}} */
 
+/* Node info array shared by the query functions */
+static void node_info_array(zval *arr, tui_node *node)
+{
+    tui_test_node_info info;
+    tui_test_get_node_info(node, &info);
+
+    array_init(arr);
+    if (info.id) add_assoc_string(arr, "id", (char *)info.id);
+    add_assoc_string(arr, "type", (char *)info.type);
+    if (info.text) add_assoc_string(arr, "text", (char *)info.text);
+    add_assoc_long(arr, "x", info.x);
+    add_assoc_long(arr, "y", info.y);
+    add_assoc_long(arr, "width", info.width);
+    add_assoc_long(arr, "height", info.height);
+    add_assoc_bool(arr, "focusable", info.focusable);
+    add_assoc_bool(arr, "focused", info.focused);
+}
+
 /* {{{ tui_test_get_by_id(resource $renderer, string $id): ?array */
 PHP_FUNCTION(tui_test_get_by_id)
 {
@@ -240,28 +263,16 @@ PHP_FUNCTION(tui_test_get_by_id)
         RETURN_THROWS();
     }
 
-    if (!renderer->root) {
+    if (!renderer->app->root_node) {
         RETURN_NULL();
     }
 
-    tui_node *node = tui_test_find_by_id(renderer->root, ZSTR_VAL(id));
+    tui_node *node = tui_test_find_by_id(renderer->app->root_node, ZSTR_VAL(id));
     if (!node) {
         RETURN_NULL();
     }
 
-    tui_test_node_info info;
-    tui_test_get_node_info(node, &info);
-
-    array_init(return_value);
-    if (info.id) add_assoc_string(return_value, "id", (char *)info.id);
-    add_assoc_string(return_value, "type", (char *)info.type);
-    if (info.text) add_assoc_string(return_value, "text", (char *)info.text);
-    add_assoc_long(return_value, "x", info.x);
-    add_assoc_long(return_value, "y", info.y);
-    add_assoc_long(return_value, "width", info.width);
-    add_assoc_long(return_value, "height", info.height);
-    add_assoc_bool(return_value, "focusable", info.focusable);
-    add_assoc_bool(return_value, "focused", info.focused);
+    node_info_array(return_value, node);
 }
 /* }}} */
 
@@ -284,35 +295,233 @@ PHP_FUNCTION(tui_test_get_by_text)
 
     array_init(return_value);
 
-    if (!renderer->root) {
+    if (!renderer->app->root_node) {
         return;
     }
 
     int count;
-    tui_node **nodes = tui_test_find_by_text(renderer->root, ZSTR_VAL(text), &count);
+    tui_node **nodes = tui_test_find_by_text(renderer->app->root_node, ZSTR_VAL(text), &count);
     if (!nodes || count == 0) {
         return;
     }
 
     for (int i = 0; i < count; i++) {
         zval node_arr;
-        tui_test_node_info info;
-        tui_test_get_node_info(nodes[i], &info);
-
-        array_init(&node_arr);
-        if (info.id) add_assoc_string(&node_arr, "id", (char *)info.id);
-        add_assoc_string(&node_arr, "type", (char *)info.type);
-        if (info.text) add_assoc_string(&node_arr, "text", (char *)info.text);
-        add_assoc_long(&node_arr, "x", info.x);
-        add_assoc_long(&node_arr, "y", info.y);
-        add_assoc_long(&node_arr, "width", info.width);
-        add_assoc_long(&node_arr, "height", info.height);
-        add_assoc_bool(&node_arr, "focusable", info.focusable);
-        add_assoc_bool(&node_arr, "focused", info.focused);
-
+        node_info_array(&node_arr, nodes[i]);
         add_next_index_zval(return_value, &node_arr);
     }
 
     free(nodes);
 }
 /* }}} */
+
+/* {{{ tui_test_get_focused(resource $renderer): ?array */
+PHP_FUNCTION(tui_test_get_focused)
+{
+    zval *zrenderer;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_RESOURCE(zrenderer)
+    ZEND_PARSE_PARAMETERS_END();
+
+    tui_test_renderer *renderer = (tui_test_renderer *)zend_fetch_resource(
+        Z_RES_P(zrenderer), TUI_TEST_RENDERER_RES_NAME, le_tui_test_renderer);
+    if (!renderer) {
+        RETURN_THROWS();
+    }
+
+    if (!renderer->app->focused_node) {
+        RETURN_NULL();
+    }
+
+    node_info_array(return_value, renderer->app->focused_node);
+}
+/* }}} */
+
+/* {{{ tui_test_set_terminal(resource $renderer, array $options = []): void
+ * Options: colors (16777216, 256, 16, 8 or 0), rep, links (bool), threads */
+PHP_FUNCTION(tui_test_set_terminal)
+{
+    zval *zrenderer;
+    HashTable *options = NULL;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_RESOURCE(zrenderer)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_ARRAY_HT(options)
+    ZEND_PARSE_PARAMETERS_END();
+
+    tui_test_renderer *renderer = (tui_test_renderer *)zend_fetch_resource(
+        Z_RES_P(zrenderer), TUI_TEST_RENDERER_RES_NAME, le_tui_test_renderer);
+    if (!renderer) {
+        RETURN_THROWS();
+    }
+
+    zend_long colors = 16777216;
+    zend_long threads = 0;
+    int inline_mode = 0;
+    unsigned int capabilities = TUI_CAP_REP | TUI_CAP_HYPERLINKS_OSC8;
+    zval *val;
+
+    if (options) {
+        if ((val = zend_hash_str_find(options, "colors", 6)) != NULL) {
+            colors = zval_get_long(val);
+        }
+        if ((val = zend_hash_str_find(options, "rep", 3)) != NULL && !zend_is_true(val)) {
+            capabilities &= ~TUI_CAP_REP;
+        }
+        if ((val = zend_hash_str_find(options, "links", 5)) != NULL && !zend_is_true(val)) {
+            capabilities &= ~TUI_CAP_HYPERLINKS_OSC8;
+        }
+        if ((val = zend_hash_str_find(options, "threads", 7)) != NULL) {
+            threads = zval_get_long(val);
+        }
+        if ((val = zend_hash_str_find(options, "inline", 6)) != NULL) {
+            inline_mode = zend_is_true(val);
+        }
+    }
+
+    if (colors != 16777216 && colors != 256 && colors != 16 && colors != 8 && colors != 0) {
+        zend_argument_value_error(2, "\"colors\" must be 16777216, 256, 16, 8 or 0");
+        RETURN_THROWS();
+    }
+    if (threads < 0 || threads > TUI_WORKERS_MAX) {
+        zend_argument_value_error(2, "\"threads\" must be between 0 and %d", TUI_WORKERS_MAX);
+        RETURN_THROWS();
+    }
+
+    if (tui_test_renderer_set_terminal(renderer, capabilities, (int)colors, (int)threads,
+                                       inline_mode) < 0) {
+        zend_throw_exception(tui_resource_exception_ce,
+            "Failed to create test terminal", 0);
+        RETURN_THROWS();
+    }
+}
+/* }}} */
+
+/* {{{ tui_test_get_frame(resource $renderer): ?string */
+PHP_FUNCTION(tui_test_get_frame)
+{
+    zval *zrenderer;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_RESOURCE(zrenderer)
+    ZEND_PARSE_PARAMETERS_END();
+
+    tui_test_renderer *renderer = (tui_test_renderer *)zend_fetch_resource(
+        Z_RES_P(zrenderer), TUI_TEST_RENDERER_RES_NAME, le_tui_test_renderer);
+    if (!renderer) {
+        RETURN_THROWS();
+    }
+
+    size_t len;
+    const char *frame = tui_test_renderer_get_frame(renderer, &len);
+    if (!frame) {
+        RETURN_NULL();
+    }
+
+    RETURN_STRINGL(frame, len);
+}
+/* }}} */
+
+/* {{{ tui_test_add_layer(resource $renderer, ContainerNode|ContentNode $node, int $zIndex = 1): int
+ * Shows $node as an overlay layer, drawn by the next tui_test_advance_frame() */
+PHP_FUNCTION(tui_test_add_layer)
+{
+    zval *zrenderer, *znode;
+    zend_long z_index = 1;
+
+    ZEND_PARSE_PARAMETERS_START(2, 3)
+        Z_PARAM_RESOURCE(zrenderer)
+        Z_PARAM_OBJECT(znode)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(z_index)
+    ZEND_PARSE_PARAMETERS_END();
+
+    tui_test_renderer *renderer = (tui_test_renderer *)zend_fetch_resource(
+        Z_RES_P(zrenderer), TUI_TEST_RENDERER_RES_NAME, le_tui_test_renderer);
+    if (!renderer) {
+        RETURN_THROWS();
+    }
+    if (z_index < INT_MIN || z_index > INT_MAX) {
+        zend_argument_value_error(3, "must be a 32-bit integer");
+        RETURN_THROWS();
+    }
+
+    tui_node *node = tui_layer_node_from_zval(znode);
+    if (!node) {
+        RETURN_THROWS();
+    }
+
+    int id = tui_test_renderer_add_layer(renderer, node, (int)z_index);
+    if (id < 0) {
+        zend_throw_exception(tui_resource_exception_ce, "Failed to allocate layer", 0);
+        RETURN_THROWS();
+    }
+    RETURN_LONG(id);
+}
+/* }}} */
+
+/* {{{ tui_test_update_layer(resource $renderer, int $layerId, ContainerNode|ContentNode $node): void */
+PHP_FUNCTION(tui_test_update_layer)
+{
+    zval *zrenderer, *znode;
+    zend_long layer_id;
+
+    ZEND_PARSE_PARAMETERS_START(3, 3)
+        Z_PARAM_RESOURCE(zrenderer)
+        Z_PARAM_LONG(layer_id)
+        Z_PARAM_OBJECT(znode)
+    ZEND_PARSE_PARAMETERS_END();
+
+    tui_test_renderer *renderer = (tui_test_renderer *)zend_fetch_resource(
+        Z_RES_P(zrenderer), TUI_TEST_RENDERER_RES_NAME, le_tui_test_renderer);
+    if (!renderer) {
+        RETURN_THROWS();
+    }
+    if (layer_id < INT_MIN || layer_id > INT_MAX) {
+        zend_argument_value_error(2, "is not a layer of this renderer");
+        RETURN_THROWS();
+    }
+
+    /* The tree is only reconciled into the layer, so it can use the frame arena */
+    tui_arena *arena = tui_node_arena_acquire();
+    tui_node *node = tui_layer_node_from_zval(znode);
+    if (!node) {
+        tui_node_arena_release(arena);
+        RETURN_THROWS();
+    }
+
+    /* Takes ownership of node, also on failure */
+    int result = tui_test_renderer_update_layer(renderer, (int)layer_id, node);
+    tui_node_arena_release(arena);
+    if (result < 0) {
+        zend_argument_value_error(2, "is not a layer of this renderer");
+        RETURN_THROWS();
+    }
+}
+/* }}} */
+
+/* {{{ tui_test_remove_layer(resource $renderer, int $layerId): void */
+PHP_FUNCTION(tui_test_remove_layer)
+{
+    zval *zrenderer;
+    zend_long layer_id;
+
+    ZEND_PARSE_PARAMETERS_START(2, 2)
+        Z_PARAM_RESOURCE(zrenderer)
+        Z_PARAM_LONG(layer_id)
+    ZEND_PARSE_PARAMETERS_END();
+
+    tui_test_renderer *renderer = (tui_test_renderer *)zend_fetch_resource(
+        Z_RES_P(zrenderer), TUI_TEST_RENDERER_RES_NAME, le_tui_test_renderer);
+    if (!renderer) {
+        RETURN_THROWS();
+    }
+    if (layer_id < INT_MIN || layer_id > INT_MAX ||
+        tui_test_renderer_remove_layer(renderer, (int)layer_id) < 0) {
+        zend_argument_value_error(2, "is not a layer of this renderer");
+        RETURN_THROWS();
+    }
+}
+/* }}} */